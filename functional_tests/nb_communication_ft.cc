@@ -261,4 +261,33 @@ TEST_F(NbCommunicationFT, ConnectionMaxSlowTest) {
     }
 }
 
+// 最大接続数(空き待ちあり)
+TEST_F(NbCommunicationFT, ConnectionWaitSlowTest) {
+    std::thread threads[20];
+    for (int i = 0; i < 20; ++i) {
+        std::thread rest_thread( []() {
+            NbApiGateway get(service_, kApiName, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, "/wait40");
+            get.SetTimeout(80);
+            NbResult<NbHttpResponse> result = get.ExecuteCustomApi();
+            ASSERT_TRUE(result.IsSuccess());
+        });
+        threads[i] = std::move(rest_thread);
+        sleep(1);
+    }
+
+    // 接続の空きを待ち合わせて実行される
+    service_->SetConnectionWaitTimeout(60000);
+    NbApiGateway get(service_, kApiName, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, "/wait40");
+    get.SetTimeout(80);
+    NbResult<NbHttpResponse> result = get.ExecuteCustomApi();
+    service_->SetConnectionWaitTimeout(0);
+    EXPECT_TRUE(result.IsSuccess());
+    EXPECT_LT(0, service_->GetConnectionPoolStatistics().waited_count);
+
+    // スレッド終了待ち
+    for (int i = 0; i < 20; ++i) {
+        threads[i].join();
+    }
+}
+
 } //namespace necbaas
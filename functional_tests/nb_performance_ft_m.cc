@@ -0,0 +1,352 @@
+#include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <thread>
+#include "ft_data.h"
+#include "ft_util.h"
+#include "necbaas/nb_file_bucket.h"
+#include "necbaas/nb_object_bucket.h"
+#include "necbaas/nb_object.h"
+#include "necbaas/nb_query.h"
+#include "necbaas/internal/nb_http_handler.h"
+#include "necbaas/internal/nb_http_file_download_handler.h"
+#include "necbaas/internal/nb_http_file_upload_handler.h"
+#include "necbaas/internal/nb_rest_executor_pool.h"
+
+// メモリ確保回数の計測(計測中のみ加算する)
+static std::atomic<bool> g_count_allocation{false};
+static std::atomic<long long> g_allocation_count{0};
+
+void *operator new(std::size_t size) {
+    if (g_count_allocation) {
+        ++g_allocation_count;
+    }
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+namespace necbaas {
+
+using std::string;
+using std::vector;
+using std::shared_ptr;
+
+// 同時実行スレッド数
+static const int kThreadNum = 16;
+// 1スレッドあたりのリクエスト数
+static const int kRequestPerThread = 20;
+
+// 性能測定(HTTPS接続のサーバで実施すること)
+class NbPerformanceManual : public ::testing::Test {
+  protected:
+    static void SetUpTestCase() {
+        shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+        NbObjectBucket object_bucket(service, kObjectBucketName);
+        for (int i = 0; i < 10; ++i) {
+            NbObject object = object_bucket.NewObject();
+            object["data1"] = i;
+            object.Save();
+        }
+    }
+    static void TearDownTestCase() {
+        FTUtil::DeleteAllObject();
+    }
+
+    virtual void SetUp() {}
+    virtual void TearDown() {}
+
+    // 複数スレッドから同時にクエリを実行し、経過時間(ミリ秒)を返す
+    static long long RunQueries(shared_ptr<NbService> service, int *failed_count) {
+        std::atomic<int> failed{0};
+        auto start = std::chrono::steady_clock::now();
+
+        vector<std::thread> threads;
+        for (int i = 0; i < kThreadNum; ++i) {
+            threads.emplace_back([&service, &failed] {
+                NbObjectBucket object_bucket(service, kObjectBucketName);
+                for (int j = 0; j < kRequestPerThread; ++j) {
+                    NbResult<vector<NbObject>> result = object_bucket.Query(NbQuery());
+                    if (!result.IsSuccess()) {
+                        ++failed;
+                    }
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        *failed_count = failed;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+    }
+
+    static void PrintResult(const string &mode, long long elapsed_ms) {
+        int total = kThreadNum * kRequestPerThread;
+        std::cout << mode << ": " << total << " requests, " << elapsed_ms << " ms, "
+                  << (elapsed_ms > 0 ? total * 1000 / elapsed_ms : 0) << " req/s" << std::endl;
+    }
+};
+
+// HTTP/1.1(接続プール)とHTTP/2(多重化)のスループット比較
+TEST_F(NbPerformanceManual, Http2Throughput) {
+    int failed = 0;
+
+    shared_ptr<NbService> service_http1 = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+    service_http1->SetConnectionReuseEnabled(true);
+    service_http1->SetConnectionWaitTimeout(60000);
+    long long elapsed_http1 = RunQueries(service_http1, &failed);
+    EXPECT_EQ(0, failed);
+    PrintResult("HTTP/1.1 pool", elapsed_http1);
+
+    shared_ptr<NbService> service_http2 = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+    service_http2->SetHttp2Enabled(true);
+    long long elapsed_http2 = RunQueries(service_http2, &failed);
+    EXPECT_EQ(0, failed);
+    PrintResult("HTTP/2 multiplex", elapsed_http2);
+}
+
+// RestExecutorプールの競合時スループット(サーバ接続不要)
+TEST(NbExecutorPoolPerformanceManual, Contention) {
+    static const int kLoopNum = 100000;
+    static const vector<int> kThreadNums{1, 2, 4, 8, 16, 32, 64};
+
+    for (int thread_num : kThreadNums) {
+        NbRestExecutorPool executor_pool;
+        std::atomic<int> failed{0};
+        auto start = std::chrono::steady_clock::now();
+
+        vector<std::thread> threads;
+        for (int i = 0; i < thread_num; ++i) {
+            threads.emplace_back([&executor_pool, &failed] {
+                for (int j = 0; j < kLoopNum; ++j) {
+                    NbRestExecutor *executor = executor_pool.PopRestExecutor(60000);
+                    if (!executor) {
+                        ++failed;
+                        continue;
+                    }
+                    executor_pool.PushRestExecutor(executor);
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+
+        long long elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        long long total = static_cast<long long>(thread_num) * kLoopNum;
+        EXPECT_EQ(0, failed);
+        std::cout << thread_num << " threads: " << total << " pop/push, " << elapsed_us / 1000 << " ms, "
+                  << (elapsed_us > 0 ? total * 1000000 / elapsed_us : 0) << " ops/s" << std::endl;
+    }
+}
+
+// レスポンスボディ受信時のメモリ確保回数(サーバ接続不要)
+TEST(NbHttpHandlerPerformanceManual, ResponseBodyAllocation) {
+    static const size_t kBodySize = 16 * 1024 * 1024;
+    static const size_t kChunkSize = 16 * 1024;
+    vector<char> chunk(kChunkSize, 'a');
+
+    for (bool content_length : {false, true}) {
+        vector<string> headers{"HTTP/1.1 200 OK\r\n", "Content-Type: application/octet-stream\r\n"};
+        if (content_length) {
+            headers.push_back("Content-Length: " + std::to_string(kBodySize) + "\r\n");
+        }
+        headers.push_back("\r\n");
+
+        NbHttpHandler handler;
+        for (auto &header : headers) {
+            handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+        }
+
+        g_allocation_count = 0;
+        g_count_allocation = true;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t received = 0; received < kBodySize; received += kChunkSize) {
+            handler.WriteCallback(chunk.data(), 1, chunk.size());
+        }
+        // 呼び出し元への受け渡し(複製が発生しないこと)
+        NbResult<NbHttpResponse> result(NbResultCode::NB_OK);
+        result.SetSuccessData(handler.Parse());
+        vector<char> body = std::move(result).GetSuccessData().GetBody();
+        long long elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        g_count_allocation = false;
+
+        EXPECT_EQ(kBodySize, body.size());
+        std::cout << (content_length ? "with" : "without") << " Content-Length: "
+                  << static_cast<double>(g_allocation_count) / (kBodySize / (1024 * 1024)) << " allocations/MB, "
+                  << elapsed_us << " us" << std::endl;
+    }
+}
+
+// 単一接続と並列Range指定のファイルダウンロードのスループット比較(高遅延のサーバで実施すること)
+TEST(NbFileBucketPerformanceManual, ParallelDownload) {
+    static const size_t kFileSize = 64 * 1024 * 1024;
+    static const string kDownloadPath = "download_performance.dat";
+
+    shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+    NbFileBucket file_bucket(service, kFileBucketName);
+    vector<char> data(kFileSize, 'p');
+    NbResult<NbFileMetadata> upload_result =
+        file_bucket.UploadNewFile(kFileName, data.data(), data.size(), "application/octet-stream");
+    ASSERT_TRUE(upload_result.IsSuccess());
+    NbFileMetadata metadata = upload_result.GetSuccessData();
+
+    for (int parallel_count : {1, 2, 4, 8}) {
+        auto start = std::chrono::steady_clock::now();
+        NbResult<int64_t> result = file_bucket.DownloadFile(metadata, kDownloadPath, parallel_count);
+        long long elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        EXPECT_TRUE(result.IsSuccess());
+        std::cout << parallel_count << " connections: " << kFileSize / (1024 * 1024) << " MB, " << elapsed_ms << " ms, "
+                  << (elapsed_ms > 0 ? kFileSize / 1024 * 1000 / 1024 / elapsed_ms : 0) << " MB/s" << std::endl;
+    }
+
+    std::remove(kDownloadPath.c_str());
+    FTUtil::DeleteAllFile(service);
+}
+
+// 小さいファイルの一括アップロード・ダウンロードの同時実行数によるスループット比較
+TEST(NbFileBucketPerformanceManual, BatchTransfer) {
+    static const int kFileCount = 200;
+    static const size_t kFileSize = 4 * 1024;
+
+    shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+    service->SetConnectionReuseEnabled(true);
+    NbFileBucket file_bucket(service, kFileBucketName);
+
+    for (int concurrency : {1, 4, 8, 16}) {
+        vector<NbFileUploadJob> upload_jobs(kFileCount);
+        vector<NbFileDownloadJob> download_jobs(kFileCount);
+        for (int i = 0; i < kFileCount; ++i) {
+            upload_jobs[i].file_name = "batch" + std::to_string(i) + ".dat";
+            upload_jobs[i].file_path = "batch_upload" + std::to_string(i) + ".dat";
+            upload_jobs[i].content_type = "application/octet-stream";
+            std::ofstream(upload_jobs[i].file_path, std::ios::out | std::ios::binary) << string(kFileSize, 'b');
+            download_jobs[i].file_name = upload_jobs[i].file_name;
+            download_jobs[i].file_path = "batch_download" + std::to_string(i) + ".dat";
+        }
+
+        NbFileTransferResult<NbFileMetadata> upload = file_bucket.UploadFiles(upload_jobs, concurrency);
+        EXPECT_EQ(kFileCount, upload.success_count);
+        NbFileTransferResult<int64_t> download = file_bucket.DownloadFiles(download_jobs, concurrency);
+        EXPECT_EQ(kFileCount, download.success_count);
+        std::cout << concurrency << " concurrency: upload " << upload.elapsed_time_ms << " ms ("
+                  << upload.bytes_per_second / 1024 << " KB/s), download " << download.elapsed_time_ms << " ms ("
+                  << download.bytes_per_second / 1024 << " KB/s)" << std::endl;
+
+        for (int i = 0; i < kFileCount; ++i) {
+            std::remove(upload_jobs[i].file_path.c_str());
+            std::remove(download_jobs[i].file_path.c_str());
+        }
+        FTUtil::DeleteAllFile(service);
+    }
+}
+
+// ファイルアップロード時の読出し性能(サーバ接続不要)
+// 従来のifstream読出し(CURL既定の64KBバッファ)と、ディスクリプタからの読出し(拡張後の送信バッファ)を比較する
+TEST(NbHttpFileUploadHandlerPerformanceManual, ReadThroughput) {
+    static const vector<size_t> kFileSizes{1UL << 20, 16UL << 20, 256UL << 20, 2048UL << 20};
+    static const size_t kCurlDefaultBufferSize = 64 * 1024;
+    static const string kFilePath = "upload_performance.dat";
+
+    for (size_t file_size : kFileSizes) {
+        {
+            std::ofstream file_stream(kFilePath, std::ios::out | std::ios::binary | std::ios::trunc);
+            vector<char> chunk(1 << 20, 'u');
+            for (size_t written = 0; written < file_size; written += chunk.size()) {
+                file_stream.write(chunk.data(), chunk.size());
+            }
+        }
+
+        for (bool descriptor : {false, true}) {
+            size_t buffer_size = descriptor ? kUploadBufferSize : kCurlDefaultBufferSize;
+            vector<char> buffer(buffer_size);
+            size_t total = 0;
+
+            auto start = std::chrono::steady_clock::now();
+            std::clock_t cpu_start = std::clock();
+            if (descriptor) {
+                NbHttpFileUploadHandler handler(kFilePath);
+                size_t read_size;
+                while ((read_size = handler.ReadCallback(buffer.data(), 1, buffer.size())) > 0) {
+                    total += read_size;
+                }
+            } else {
+                std::ifstream file_stream(kFilePath, std::ios::in | std::ios::binary);
+                while (!file_stream.eof()) {
+                    total += file_stream.read(buffer.data(), buffer.size()).gcount();
+                }
+            }
+            double cpu_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+            long long elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+
+            EXPECT_EQ(file_size, total);
+            double mb = static_cast<double>(file_size) / (1 << 20);
+            std::cout << (descriptor ? "descriptor" : "ifstream  ") << " " << mb << " MB: "
+                      << (elapsed_us > 0 ? mb * 1000000 / elapsed_us : 0) << " MB/s, "
+                      << cpu_ms / mb << " CPU ms/MB" << std::endl;
+        }
+    }
+    std::remove(kFilePath.c_str());
+}
+
+// ファイルダウンロード時の書込み性能(サーバ接続不要)
+// CURLの受信単位(16KB)毎の書込み(従来のチャンク毎flush相当)と、書込みバッファ・領域事前確保を比較する
+TEST(NbHttpFileDownloadHandlerPerformanceManual, WriteThroughput) {
+    static const vector<size_t> kFileSizes{16UL << 20, 256UL << 20, 2048UL << 20};
+    static const size_t kChunkSize = 16 * 1024;
+    static const string kFilePath = "download_performance.dat";
+    vector<char> chunk(kChunkSize, 'd');
+
+    for (size_t file_size : kFileSizes) {
+        const vector<string> headers = {
+            "HTTP/1.1 200 OK\r\n",
+            "X-Content-Length: " + std::to_string(file_size) + "\r\n",
+            "\r\n"};
+        for (int buffer_size : {0, kDownloadBufferSize}) {
+            for (bool sync : {false, true}) {
+                auto start = std::chrono::steady_clock::now();
+                std::clock_t cpu_start = std::clock();
+                {
+                    NbHttpFileDownloadHandler handler(kFilePath);
+                    handler.SetWriteBufferSize(buffer_size);
+                    handler.SetSyncEnabled(sync);
+                    for (const auto &header : headers) {
+                        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+                    }
+                    for (size_t written = 0; written < file_size; written += chunk.size()) {
+                        ASSERT_EQ(chunk.size(), handler.WriteCallback(chunk.data(), 1, chunk.size()));
+                    }
+                    EXPECT_TRUE(handler.Finish());
+                }
+                double cpu_ms = 1000.0 * (std::clock() - cpu_start) / CLOCKS_PER_SEC;
+                long long elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+
+                double mb = static_cast<double>(file_size) / (1 << 20);
+                std::cout << (buffer_size > 0 ? "buffered" : "per-chunk") << (sync ? "+fsync " : " ") << mb << " MB: "
+                          << (elapsed_us > 0 ? mb * 1000000 / elapsed_us : 0) << " MB/s, "
+                          << cpu_ms / mb << " CPU ms/MB" << std::endl;
+            }
+        }
+    }
+    std::remove(kFilePath.c_str());
+}
+} //namespace necbaas
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBASYNCRESULT_H
+#define NECBAAS_NBASYNCRESULT_H
+
+#include <functional>
+#include <future>
+#include <memory>
+#include "necbaas/nb_result.h"
+
+namespace necbaas {
+
+/**
+ * @class NbAsyncResult nb_async_result.h "necbaas/internal/nb_async_result.h"
+ * 非同期処理結果通知.
+ * 処理結果をコールバックとstd::futureの両方へ通知する。<br>
+ * コピーしたインスタンスは同じ通知先を共有するため、完了ラムダへコピーキャプチャして使用する。
+ */
+template <typename T>
+class NbAsyncResult {
+  public:
+    /**
+     * 完了コールバック.
+     */
+    typedef std::function<void(const NbResult<T> &)> Callback;
+
+    /**
+     * コンストラクタ.
+     * @param[in]   callback    完了コールバック(nullptrの場合は呼び出さない)
+     */
+    explicit NbAsyncResult(Callback callback)
+        : promise_(std::make_shared<std::promise<NbResult<T>>>()), callback_(std::move(callback)) {}
+
+    /**
+     * future取得.
+     * 1インスタンス(コピーを含む)につき1回のみ取得可能。
+     * @return      処理結果のfuture
+     */
+    std::future<NbResult<T>> GetFuture() {
+        return promise_->get_future();
+    }
+
+    /**
+     * 完了通知.
+     * コールバックを呼び出した後、futureへ処理結果を設定する。<br>
+     * コールバックが例外を送出した場合も、futureへ処理結果を設定してから例外を再送出する。
+     * @param[in]   result      処理結果
+     */
+    void Complete(const NbResult<T> &result) const {
+        if (callback_) {
+            try {
+                callback_(result);
+            }
+            catch (...) {
+                promise_->set_value(result);
+                throw;
+            }
+        }
+        promise_->set_value(result);
+    }
+
+  private:
+    std::shared_ptr<std::promise<NbResult<T>>> promise_; /*!< 処理結果通知先 */
+    Callback callback_;                                   /*!< 完了コールバック */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBASYNCRESULT_H
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBCIRCUITBREAKER_H
+#define NECBAAS_NBCIRCUITBREAKER_H
+
+#include <mutex>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "necbaas/nb_circuit_breaker_policy.h"
+
+namespace necbaas {
+
+/**
+ * @class NbCircuitBreaker nb_circuit_breaker.h "necbaas/internal/nb_circuit_breaker.h"
+ * サーキットブレーカー.
+ * REST APIの実行結果を記録し、NbCircuitBreakerPolicy に従って状態を遷移させる。<br>
+ * 複数スレッドから使用できる。
+ */
+class NbCircuitBreaker {
+  public:
+    /**
+     * ポリシー取得.
+     * @return      ポリシー
+     */
+    NbCircuitBreakerPolicy GetPolicy();
+
+    /**
+     * ポリシー設定.
+     * 記録した実行結果を破棄し、通常状態に戻す。
+     * @param[in]   policy      ポリシー
+     */
+    void SetPolicy(const NbCircuitBreakerPolicy &policy);
+
+    /**
+     * 状態取得.
+     * @return      状態
+     */
+    NbCircuitBreakerState GetState();
+
+    /**
+     * 実行可否確認.
+     * 試行状態の実行枠は確保しない。
+     * @return      true:実行可能／false:遮断中
+     */
+    bool IsCallPermitted();
+
+    /**
+     * 実行開始.
+     * 試行状態の場合は実行枠を確保する。trueを返した場合は、必ず OnComplete() を呼び出すこと。
+     * @return      true:実行可能／false:遮断中
+     */
+    bool TryAcquire();
+
+    /**
+     * 実行結果記録.
+     * @param[in]   failure     true:失敗
+     * @param[in]   elapsed_ms  所要時間(ミリ秒)
+     */
+    void OnComplete(bool failure, int64_t elapsed_ms);
+
+  private:
+    std::mutex mutex_;                          /*!< 状態更新用Mutex */
+    NbCircuitBreakerPolicy policy_;             /*!< ポリシー */
+    NbCircuitBreakerState state_{NbCircuitBreakerState::CLOSED}; /*!< 状態 */
+    std::vector<uint8_t> outcomes_;             /*!< 直近の実行結果(リングバッファ) */
+    size_t next_{0};                            /*!< 次に記録する位置 */
+    size_t count_{0};                           /*!< 記録数 */
+    int failure_count_{0};                      /*!< 記録中の失敗数 */
+    int slow_count_{0};                         /*!< 記録中の低速数 */
+    std::chrono::steady_clock::time_point opened_at_; /*!< 遮断状態への遷移時刻 */
+    int half_open_acquired_{0};                 /*!< 試行状態で確保した実行枠数 */
+    int half_open_succeeded_{0};                /*!< 試行状態で成功した数 */
+
+    /**
+     * 遮断時間経過の確認(ロック取得済みで呼び出す).
+     */
+    void UpdateState();
+
+    /**
+     * 状態遷移(ロック取得済みで呼び出す).
+     * @param[in]   state       遷移先の状態
+     */
+    void TransitionTo(NbCircuitBreakerState state);
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBCIRCUITBREAKER_H
@@ -14,6 +14,13 @@ namespace necbaas {
 //
 extern const int kHttpConnectionMax;                /*!< HTTP同時接続数最大値 */
 extern const int kRestTimeoutDefault;               /*!< RESTタイムアウトデフォルト(秒) */
+extern const int kConnectionWaitTimeoutDefault;     /*!< HTTP接続空き待ちタイムアウトデフォルト(ミリ秒) */
+extern const int kWarmUpTimeoutDefault;             /*!< 事前接続タイムアウトデフォルト(秒) */
+extern const int kUploadBufferSize;                 /*!< ファイルアップロードの送信バッファサイズ(バイト) */
+extern const int kDownloadBufferSize;               /*!< ファイルダウンロードの書込みバッファサイズデフォルト(バイト) */
+extern const int kRangeSegmentSizeMin;              /*!< 並列ダウンロードの分割サイズ最小値(バイト) */
+extern const std::string kResumeETagFileSuffix;     /*!< ダウンロード再開用ETag保存ファイルの拡張子 */
+extern const int kTransferJobRetryInterval;         /*!< 一括転送のHTTP接続空き待ちの再試行間隔(ミリ秒) */
 
 //
 // URI パス定義
@@ -41,6 +48,13 @@ extern const std::string kHeaderContentLength;      /*!< HTTPヘッダ: Content-
 extern const std::string kHeaderXContentLength;     /*!< HTTPヘッダ: X-Content-Length */
 extern const std::string kHeaderXAcl;               /*!< HTTPヘッダ: X-ACL */
 extern const std::string kHeaderHost;               /*!< HTTPヘッダ: Host */
+extern const std::string kHeaderContentEncoding;    /*!< HTTPヘッダ: Content-Encoding */
+extern const std::string kHeaderContentEncodingGzip; /*!< HTTPヘッダ: Content-Encoding値(gzip) */
+extern const std::string kHeaderTransferEncoding;    /*!< HTTPヘッダ: Transfer-Encoding */
+extern const std::string kHeaderRange;               /*!< HTTPヘッダ: Range */
+extern const std::string kHeaderIfRange;             /*!< HTTPヘッダ: If-Range */
+extern const std::string kHeaderContentRange;        /*!< HTTPヘッダ: Content-Range */
+extern const std::string kHeaderTransferEncodingChunked; /*!< HTTPヘッダ: Transfer-Encoding値(chunked) */
 
 //
 // Key
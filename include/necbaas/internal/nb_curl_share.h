@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBCURLSHARE_H
+#define NECBAAS_NBCURLSHARE_H
+
+#include <memory>
+#include <mutex>
+#include <curl/curl.h>
+
+namespace necbaas {
+
+/**
+ * @class NbCurlShare nb_curl_share.h "necbaas/internal/nb_curl_share.h"
+ * CURL共有キャッシュ.
+ * CURL共有ハンドルを使用し、複数のCURLハンドル間でDNSキャッシュ、TLSセッションを共有する。<br>
+ * 接続キャッシュは、別スレッドで同時に転送するCURLハンドル間の共有にlibcurlが対応していないため共有しない。<br>
+ * 共有データへのアクセスはデータ種別毎のMutexで排他するため、複数スレッドから使用できる。<br>
+ * 共有ハンドルを使用するCURLハンドルより先に破棄してはならないため、shared_ptrで保持すること。<br>
+ * 使用中のまま破棄した場合は処理を中断(abort)する。
+ */
+class NbCurlShare {
+  public:
+    /**
+     * コンストラクタ.
+     */
+    NbCurlShare();
+
+    /**
+     * デストラクタ.
+     */
+    ~NbCurlShare();
+
+    /**
+     * CURL共有ハンドル取得.
+     * @return      CURL共有ハンドル(生成に失敗した場合はnullptr)
+     */
+    CURLSH *GetHandle() const;
+
+    /**
+     * プロセス共通の共有キャッシュ取得.
+     * 使用中のインスタンスがある場合はそれを返し、無い場合は新規に生成する。
+     * @return      共有キャッシュ
+     */
+    static std::shared_ptr<NbCurlShare> GetProcessShare();
+
+    // コピーとムーブを禁止
+    NbCurlShare(NbCurlShare const&) = delete;
+    NbCurlShare& operator =(NbCurlShare const&) = delete;
+    NbCurlShare(NbCurlShare&&) = delete;
+    NbCurlShare& operator =(NbCurlShare&&) = delete;
+
+  private:
+    CURLSH *share_{nullptr};                    /*!< CURL共有ハンドル */
+    std::mutex mutexes_[CURL_LOCK_DATA_LAST];   /*!< 共有データ種別毎のMutex */
+
+    /**
+     * 共有データロック(CURLコールバック).
+     */
+    static void Lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+
+    /**
+     * 共有データアンロック(CURLコールバック).
+     */
+    static void Unlock(CURL *handle, curl_lock_data data, void *userptr);
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBCURLSHARE_H
@@ -6,7 +6,7 @@
 #define NECBAAS_NBHTTPEFILEDOWNLOADHANDLER_H
 
 #include <string>
-#include <fstream>
+#include <vector>
 #include "necbaas/internal/nb_http_handler.h"
 
 namespace necbaas {
@@ -17,6 +17,10 @@ namespace necbaas {
  * CURLのデータ読み書き用コールバック関数を具備する。
  * 受信したデータを指定ファイルに保存し、HTTPレスポンスデータに変換する。
  * 既にファイルが存在する場合は、上書きで書込みする。
+ * 再開モードの場合は、ステータスコードが206であれば既存のファイルの末尾に追記する。
+ * Content-Rangeの開始位置が既存のファイルサイズと異なる場合は、受信を中断する。
+ * 受信データは書込みバッファに蓄積してまとめて書込み、X-Content-Lengthヘッダがあれば
+ * ファイル領域を事前に確保する。
  *
  * <b>本クラスのインスタンスはスレッドセーフではない</b>
  */
@@ -29,21 +33,64 @@ class NbHttpFileDownloadHandler : public NbHttpHandler {
      */
     explicit NbHttpFileDownloadHandler(const std::string &file_name);
 
+    /**
+     * コンストラクタ(再開モード指定).
+     * 再開モードの場合、ファイルはレスポンスヘッダ受信完了時に開く。
+     * ステータスコードが206の場合は追記、その他の200台の場合は上書きで書込みし、
+     * 200台以外の場合はファイルを変更しない。
+     * 206でContent-Rangeの開始位置が既存のファイルサイズと異なる場合はエラーとする。
+     * @param[in]   file_name          ダウンロード先ファイル名
+     * @param[in]   resume             再開モード
+     */
+    NbHttpFileDownloadHandler(const std::string &file_name, bool resume);
+
     /**
      * デストラクタ.
      */
     ~NbHttpFileDownloadHandler();
 
+    // コピーを禁止(ファイルディスクリプタを保持するため)
+    NbHttpFileDownloadHandler(const NbHttpFileDownloadHandler &) = delete;
+    NbHttpFileDownloadHandler &operator=(const NbHttpFileDownloadHandler &) = delete;
+
     /**
      * エラー発生確認.
      * コンストラクタでエラーが発生した場合にtrueとなる。
-     * 対象エラーは、ファイルオープンエラーである。
+     * 対象エラーは、ファイルオープンエラー、ファイル書込みエラーである。
      * @return  確認結果
      * @retval  true    エラー発生
      * @retval  false   エラー未発生
      */
     bool IsError() const;
 
+    /**
+     * 書込みバッファサイズ設定.
+     * 受信データはバッファサイズ分蓄積してからファイルに書込む。
+     * 0の場合はバッファリングせず、受信データ毎に書込む。<br>
+     * デフォルト: kDownloadBufferSize
+     * @param[in]   size            書込みバッファサイズ(バイト)
+     */
+    void SetWriteBufferSize(size_t size);
+
+    /**
+     * 同期書込み設定.
+     * 有効にした場合、Finish()でファイルの内容をストレージに同期(fsync)する。<br>
+     * デフォルト: 無効
+     * @param[in]   sync            true:有効／false:無効
+     */
+    void SetSyncEnabled(bool sync);
+
+    /**
+     * 書込み完了.
+     * 書込みバッファに残ったデータをファイルに書込む。
+     * 同期書込みが有効な場合は、ファイルの内容をストレージに同期する。
+     * ファイルサイズを確認する前に実行すること。
+     * @return  処理結果
+     * @retval  true    成功
+     * @retval  false   書込みエラー
+     */
+    bool Finish();
+
     /**
      * 受信データ書込み関数.
      * 受信データを指定ファイルに書込む。
@@ -54,9 +101,75 @@ class NbHttpFileDownloadHandler : public NbHttpHandler {
      * @return      処理データサイズ
      */
     size_t WriteCallback(char *buffer, size_t size, size_t nmemb) override;
+
+    /**
+     * 受信ヘッダ書込み関数.
+     * 再開モードの場合、ヘッダ受信完了時にステータスコードに応じてファイルを開く。
+     * 206でContent-Rangeの開始位置が既存のファイルサイズと異なる場合は0を返して受信を中断する。
+     * ステータスコードが200台の場合、X-Content-Lengthヘッダのサイズでファイル領域を確保する。
+     * @param[in]   buffer          受信データバッファ
+     * @param[in]   size            データサイズ
+     * @param[in]   nmemb           データ個数
+     * @return      処理データサイズ
+     */
+    size_t WriteHeaderCallback(void *buffer, size_t size, size_t nmemb) override;
   private:
-    std::ofstream file_stream_;   /*!< ファイルストリーム */
+    int fd_{-1};                  /*!< ファイルディスクリプタ */
+    bool error_{false};           /*!< エラー発生         */
     int tmp_status_code_{0};      /*!< status-code        */
+    std::string file_name_;       /*!< ファイル名(再開モード用) */
+    bool resume_{false};          /*!< 再開モード         */
+    bool sync_{false};            /*!< 同期書込み         */
+    bool preallocated_{false};    /*!< ファイル領域確保済み */
+    size_t write_buffer_size_;    /*!< 書込みバッファサイズ */
+    std::vector<char> write_buffer_; /*!< 書込みバッファ  */
+
+    /**
+     * ファイルオープン.
+     * @param[in]   flags           open()のフラグ(O_WRONLY, O_CREAT以外)
+     */
+    void OpenFile(int flags);
+
+    /**
+     * ファイル書込み.
+     * 指定サイズを全て書込むまで繰り返す。
+     * @param[in]   data            書込みデータ
+     * @param[in]   size            データサイズ
+     * @return  処理結果
+     */
+    bool WriteFile(const char *data, size_t size);
+
+    /**
+     * 書込みバッファのデータをファイルに書込む.
+     * @return  処理結果
+     */
+    bool FlushBuffer();
+
+    /**
+     * ファイル領域確保.
+     * X-Content-Lengthヘッダのサイズでファイル領域を確保する。
+     * ファイルサイズは変更しない。確保に失敗した場合も処理を継続する。
+     */
+    void Preallocate();
+
+    /**
+     * 受信ヘッダ検索.
+     * @param[in]   name            ヘッダ名(大文字小文字を区別しない)
+     * @return  ヘッダ値の先頭(':'の直後)、ヘッダがない場合はnullptr
+     */
+    const char *FindHeaderValue(const std::string &name) const;
+
+    /**
+     * X-Content-Lengthヘッダ取得.
+     * @return  X-Content-Length(ヘッダがない場合は-1)
+     */
+    int64_t GetXContentLength() const;
+
+    /**
+     * Content-Rangeヘッダの開始位置取得.
+     * @return  開始位置(ヘッダがない場合、形式が不正な場合は-1)
+     */
+    int64_t GetContentRangeStart() const;
 
     /**
      * ステータスコード取得.
@@ -6,7 +6,6 @@
 #define NECBAAS_NBHTTPFILEUPLOADHANDLER_H
 
 #include <string>
-#include <fstream>
 #include "necbaas/internal/nb_http_handler.h"
 
 namespace necbaas {
@@ -17,6 +16,7 @@ namespace necbaas {
  * CURLのデータ読み書き用コールバック関数を具備する。
  * 受信したデータをメンバ変数に保存し、HTTPレスポンスデータに変換する。
  * 送信データ読出しコールバックを実装し、対象ファイルデータを送信する。
+ * ファイルはファイルディスクリプタで扱い、CURLの送信バッファに直接読み出す(中間バッファを使用しない)。
  *
  * <b>本クラスのインスタンスはスレッドセーフではない</b>
  */
@@ -44,17 +44,31 @@ class NbHttpFileUploadHandler : public NbHttpHandler {
      */
     bool IsError() const;
 
+    /**
+     * ファイルサイズ取得.
+     * オープン済みのファイルディスクリプタから取得したサイズを返す。
+     * @return  ファイルサイズ(エラー時は0)
+     */
+    int64_t GetFileSize() const;
+
     /**
      * 送信データ読出し関数.
      * 指定ファイルを読み出し、送信バッファに格納する。
+     * 送信バッファのサイズ分をまとめて読み出す。
      * @param[out]  buffer          送信データバッファ
      * @param[in]   size            データサイズ
      * @param[in]   nmemb           データ個数
      * @return      処理データサイズ
      */
     size_t ReadCallback(void *buffer, size_t size, size_t nmemb) override;
+
+    // コピーを禁止(ファイルディスクリプタを保持するため)
+    NbHttpFileUploadHandler(NbHttpFileUploadHandler const&) = delete;
+    NbHttpFileUploadHandler& operator =(NbHttpFileUploadHandler const&) = delete;
+
   private:
-    std::ifstream file_stream_;   /*!< ファイルストリーム */
+    int fd_{-1};                  /*!< ファイルディスクリプタ */
+    int64_t file_size_{0};        /*!< ファイルサイズ         */
 };
 }
 
@@ -6,6 +6,7 @@
 #define NECBAAS_NBHTTPHANDLER_H
 
 #include <string>
+#include <utility>
 #include <vector>
 #include "necbaas/nb_http_response.h"
 
@@ -41,6 +42,7 @@ class NbHttpHandler {
     /**
      * 受信データ（ヘッダ）書込み関数.
      * HTTPレスポンスのヘッダデータをメンバ変数に書込みを行うコールバック関数。
+     * Content-Lengthヘッダを受信した場合は、ボディ受信時の事前確保サイズとして保持する。
      * @param[in]   buffer          受信データバッファ
      * @param[in]   size            データサイズ
      * @param[in]   nmemb           データ個数
@@ -51,6 +53,7 @@ class NbHttpHandler {
     /**
      * 受信データ（ボディ）書込み関数.
      * HTTPレスポンスのボディデータをメンバ変数に書込みを行うコールバック関数。
+     * Content-Lengthが分かっている場合は、最初の受信時にボディ領域を確保する。
      * @param[in]   buffer          受信データバッファ
      * @param[in]   size            データサイズ
      * @param[in]   nmemb           データ個数
@@ -66,24 +69,35 @@ class NbHttpHandler {
     NbHttpResponse Parse();
 
   protected:
-    std::vector<std::string> response_headers_;    /*!< HTTPレスポンスヘッダ（１行毎の配列）*/
+    std::string header_buffer_;                    /*!< HTTPレスポンスヘッダ（受信順に連結）*/
+    std::vector<std::pair<size_t, size_t>> header_lines_; /*!< ヘッダ１行毎の開始位置と長さ */
     std::vector<char> response_body_;              /*!< HTTPレスポンスボディ（バイナリ）    */
+    size_t content_length_{0};                     /*!< Content-Length（不明の場合は0）     */
+    bool content_encoded_{false};                  /*!< Content-Encodingによる圧縮転送      */
 
     /**
      * 受信データ解析(ステータスライン).
      * 受信データ(ヘッダ)の１行目を解析し、status-codeとreason-phraseを取り出す。
      * @param[out]   status_code        status-code
      * @param[out]   eson_phrase        reason-phrase
+     * @return       ステータスラインの次の行番号
      */
-    std::vector<std::string>::iterator ParseStatusLine(int *status_code, std::string *reason_phrase);
+    size_t ParseStatusLine(int *status_code, std::string *reason_phrase) const;
 
     /**
      * ステータスライン検索.
-     * レスポンスヘッダを後方検索し、ステータスラインのイテレータを返す。<br>
-     * ステータスラインが見つからなかった場合は、response_headers_.end()を返す。
-     * @return      ステータスラインを示すイテレータ
+     * レスポンスヘッダを後方検索し、ステータスラインの行番号を返す。<br>
+     * ステータスラインが見つからなかった場合は、header_lines_.size()を返す。
+     * @return      ステータスラインの行番号
      */
-    std::vector<std::string>::iterator SearchStatusLine();
+    size_t SearchStatusLine() const;
+
+    /**
+     * ステータスライン判定.
+     * @param[in]   line_index      行番号
+     * @return      ステータスラインの場合はstatus-code前までの長さ、それ以外は0
+     */
+    size_t GetStatusLineMarkerSize(size_t line_index) const;
 };
 } //namespace necbaas
 
@@ -67,6 +67,30 @@ class NbHttpRequest {
      */
     const std::string &GetProxy() const;
 
+    /**
+     * ヘッジリクエスト対象設定.
+     * @param[in]   hedgeable   true:ヘッジリクエストポリシーが有効な場合に重複送信の対象とする
+     */
+    void SetHedgeable(bool hedgeable);
+
+    /**
+     * ヘッジリクエスト対象判定.
+     * @return      true:重複送信の対象
+     */
+    bool IsHedgeable() const;
+
+    /**
+     * ボディ圧縮対象設定.
+     * @param[in]   compressible    true:ボディが閾値以上の場合にgzip圧縮して送信する
+     */
+    void SetBodyCompressible(bool compressible);
+
+    /**
+     * ボディ圧縮対象判定.
+     * @return      true:圧縮の対象
+     */
+    bool IsBodyCompressible() const;
+
     /**
      * ダンプ.
      * ログにHTTPリクエスト情報を出力する
@@ -78,6 +102,8 @@ class NbHttpRequest {
     const std::list<std::string> headers_{};    /*!< HTTPヘッダリスト */
     const std::string body_{};                  /*!< HTTPボディ       */
     const std::string proxy_{};                 /*!< Proxy URL        */
+    bool hedgeable_{false};                     /*!< ヘッジリクエスト対象 */
+    bool body_compressible_{false};             /*!< ボディ圧縮対象 */
 };
 } //namespace necbaas
 
@@ -121,6 +121,22 @@ class NbHttpRequestFactory {
      */
     NbHttpRequestFactory &SessionNone();
 
+    /**
+     * ヘッジリクエスト対象設定.
+     * 重複して送信しても副作用の無い読み取りリクエスト(オブジェクトの取得・クエリ)にのみ設定すること。
+     * ヘッジリクエストポリシーが無効の場合は影響しない。
+     * @return this
+     */
+    NbHttpRequestFactory &Hedgeable();
+
+    /**
+     * ボディ圧縮対象設定.
+     * サービスのリクエスト圧縮閾値以上のボディをgzip圧縮して送信する。
+     * サーバが圧縮を受け付けるAPI(オブジェクトの保存・部分更新)にのみ設定すること。
+     * @return this
+     */
+    NbHttpRequestFactory &CompressibleBody();
+
     /**
      * Builder実行.
      * @return  NbHttpRequestインスタンス
@@ -155,6 +171,8 @@ class NbHttpRequestFactory {
     std::multimap<std::string, std::string> headers_{};         /*!< HTTPヘッダリスト */
     std::string body_{};                                        /*!< HTTPボディ */
     bool session_none_{false};                                  /*!< セッショントークンを付与しない */
+    bool hedgeable_{false};                                     /*!< ヘッジリクエスト対象 */
+    bool body_compressible_{false};                             /*!< ボディ圧縮対象 */
 
     NbResultCode error_{NbResultCode::NB_OK};                   /*!< error発生フラグ  */
 
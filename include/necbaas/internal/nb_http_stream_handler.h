@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBHTTPSTREAMHANDLER_H
+#define NECBAAS_NBHTTPSTREAMHANDLER_H
+
+#include <functional>
+#include "necbaas/internal/nb_http_handler.h"
+
+namespace necbaas {
+
+/**
+ * @class NbHttpStreamHandler nb_http_stream_handler.h "necbaas/internal/nb_http_stream_handler.h"
+ * HTTPハンドラ(ストリーミング受信用).
+ * CURLのデータ読み書き用コールバック関数を具備する。
+ * 受信したボディを保持せずに、受信の都度、出力先関数に渡す。
+ * ステータスコードが200台以外の場合は、エラー情報として基底クラスで保持する。
+ *
+ * <b>本クラスのインスタンスはスレッドセーフではない</b>
+ */
+class NbHttpStreamHandler : public NbHttpHandler {
+  public:
+    /**
+     * 受信データ出力先.
+     * 受信データとサイズを受け取り、処理を継続する場合はtrueを返す。
+     */
+    typedef std::function<bool(const char *data, size_t size)> Sink;
+
+    /**
+     * コンストラクタ.
+     * @param[in]   sink        受信データ出力先
+     */
+    explicit NbHttpStreamHandler(Sink sink);
+
+    /**
+     * デストラクタ.
+     */
+    ~NbHttpStreamHandler();
+
+    /**
+     * 中断確認.
+     * 出力先関数がfalseを返して受信を中断した場合にtrueとなる。
+     * @return  確認結果
+     * @retval  true    中断した
+     * @retval  false   中断していない
+     */
+    bool IsAborted() const;
+
+    /**
+     * 受信データ書込み関数.
+     * 受信データを出力先関数に渡す。
+     * ステータスコードが200台以外の場合は、基底クラスのメソッドで処理する。
+     * @param[in]   buffer          受信データバッファ
+     * @param[in]   size            データサイズ
+     * @param[in]   nmemb           データ個数
+     * @return      処理データサイズ
+     */
+    size_t WriteCallback(char *buffer, size_t size, size_t nmemb) override;
+
+  private:
+    Sink sink_;                     /*!< 受信データ出力先 */
+    bool aborted_{false};           /*!< 中断した */
+    int tmp_status_code_{0};        /*!< status-code */
+};
+} //namespace necbaas
+#endif //NECBAAS_NBHTTPSTREAMHANDLER_H
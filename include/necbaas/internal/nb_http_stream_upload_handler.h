@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBHTTPSTREAMUPLOADHANDLER_H
+#define NECBAAS_NBHTTPSTREAMUPLOADHANDLER_H
+
+#include <cstdint>
+#include <functional>
+#include "necbaas/internal/nb_http_handler.h"
+
+namespace necbaas {
+
+/**
+ * @class NbHttpStreamUploadHandler nb_http_stream_upload_handler.h "necbaas/internal/nb_http_stream_upload_handler.h"
+ * HTTPハンドラ(ストリーミング送信用).
+ * CURLのデータ読み書き用コールバック関数を具備する。
+ * 送信データを保持せずに、CURLの送信要求の都度、生成関数から取得する。
+ *
+ * <b>本クラスのインスタンスはスレッドセーフではない</b>
+ */
+class NbHttpStreamUploadHandler : public NbHttpHandler {
+  public:
+    /**
+     * 送信データ生成関数.
+     * 指定バッファ(最大size)に送信データを書き込み、書き込んだサイズを返す。
+     * 終端の場合は0、中断する場合は負の値を返す。
+     */
+    typedef std::function<int64_t(char *buffer, size_t size)> Producer;
+
+    /**
+     * コンストラクタ.
+     * @param[in]   producer    送信データ生成関数
+     */
+    explicit NbHttpStreamUploadHandler(Producer producer);
+
+    /**
+     * デストラクタ.
+     */
+    ~NbHttpStreamUploadHandler();
+
+    /**
+     * 中断確認.
+     * 生成関数が負の値を返して送信を中断した場合にtrueとなる。
+     * @return  確認結果
+     * @retval  true    中断した
+     * @retval  false   中断していない
+     */
+    bool IsAborted() const;
+
+    /**
+     * 送信データ読出し関数.
+     * 生成関数から送信データを取得する。
+     * @param[out]  buffer          送信データバッファ
+     * @param[in]   size            データサイズ
+     * @param[in]   nmemb           データ個数
+     * @return      送信データサイズ(中断する場合はCURL_READFUNC_ABORT)
+     */
+    size_t ReadCallback(void *buffer, size_t size, size_t nmemb) override;
+
+  private:
+    Producer producer_;             /*!< 送信データ生成関数 */
+    bool aborted_{false};           /*!< 中断した */
+};
+} //namespace necbaas
+#endif //NECBAAS_NBHTTPSTREAMUPLOADHANDLER_H
@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBLATENCYWINDOW_H
+#define NECBAAS_NBLATENCYWINDOW_H
+
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+namespace necbaas {
+
+/**
+ * @class NbLatencyWindow nb_latency_window.h "necbaas/internal/nb_latency_window.h"
+ * 所要時間の記録.
+ * 直近の所要時間を指定数まで保持し、パーセンタイル値を算出する。<br>
+ * 複数スレッドから使用できる。
+ */
+class NbLatencyWindow {
+  public:
+    /**
+     * コンストラクタ.
+     * @param[in]   window_size     保持する所要時間の数(1未満の場合は1)
+     */
+    explicit NbLatencyWindow(int window_size);
+
+    /**
+     * 保持数変更.
+     * 記録済みの所要時間は破棄する。
+     * @param[in]   window_size     保持する所要時間の数(1未満の場合は1)
+     */
+    void Resize(int window_size);
+
+    /**
+     * 所要時間記録.
+     * 保持数を超えた場合は最も古い所要時間を破棄する。
+     * @param[in]   latency_ms      所要時間(ミリ秒)
+     */
+    void Add(int64_t latency_ms);
+
+    /**
+     * 記録数取得.
+     * @return      保持している所要時間の数
+     */
+    int GetCount();
+
+    /**
+     * パーセンタイル値取得.
+     * @param[in]   percentile      パーセンタイル(0～100)
+     * @return      パーセンタイル値(ミリ秒。記録が無い場合は0)
+     */
+    int64_t GetPercentile(int percentile);
+
+  private:
+    std::mutex mutex_;                  /*!< 記録用Mutex */
+    std::vector<int64_t> latencies_;    /*!< 所要時間(リングバッファ) */
+    size_t next_{0};                    /*!< 次に記録する位置 */
+    size_t count_{0};                   /*!< 記録数 */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBLATENCYWINDOW_H
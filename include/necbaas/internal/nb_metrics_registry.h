@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBMETRICSREGISTRY_H
+#define NECBAAS_NBMETRICSREGISTRY_H
+
+#include <atomic>
+#include <cstdint>
+#include "necbaas/nb_result.h"
+#include "necbaas/nb_http_response.h"
+#include "necbaas/nb_statistics.h"
+
+namespace necbaas {
+
+/**
+ * @class NbMetricsRegistry nb_metrics_registry.h "necbaas/internal/nb_metrics_registry.h"
+ * 統計情報の記録.
+ * 操作種別毎にリクエスト数、処理結果コード別件数、送受信バイト数、所要時間ヒストグラムを記録する。<br>
+ * 記録はアトミック変数のみで行い、ロックを取得しない。
+ * 統計情報の取得は記録と並行して行えるが、取得中の記録は一部の値にのみ反映される場合がある。
+ */
+class NbMetricsRegistry {
+  public:
+    /**
+     * コンストラクタ.
+     */
+    NbMetricsRegistry();
+
+    /**
+     * 記録.
+     * @param[in]   operation   操作種別
+     * @param[in]   result      REST実行結果
+     * @param[in]   elapsed_us  所要時間(マイクロ秒)
+     */
+    void Record(NbOperation operation, const NbResult<NbHttpResponse> &result, int64_t elapsed_us);
+
+    /**
+     * 統計情報取得.
+     * @param[out]  statistics  統計情報(operationsを設定する)
+     */
+    void GetStatistics(NbStatistics *statistics) const;
+
+    /**
+     * 統計情報のクリア.
+     */
+    void Reset();
+
+  private:
+    static const int kOperationNum = static_cast<int>(NbOperation::OTHER) + 1;       /*!< 操作種別数 */
+    static const int kResultCodeNum = static_cast<int>(NbResultCode::NB_ERROR_CIRCUIT_OPEN) + 1; /*!< 処理結果コード数(末尾のコードで算出) */
+
+    // 操作種別毎の記録
+    struct Metrics {
+        std::atomic<uint64_t> result_counts[kResultCodeNum];            /*!< 処理結果コード別件数 */
+        std::atomic<uint64_t> bytes_sent;                               /*!< 送信バイト数 */
+        std::atomic<uint64_t> bytes_received;                           /*!< 受信バイト数 */
+        std::atomic<int64_t> latency_sum;                               /*!< 所要時間の合計 */
+        std::atomic<int64_t> latency_min;                               /*!< 所要時間の最小値 */
+        std::atomic<int64_t> latency_max;                               /*!< 所要時間の最大値 */
+        std::atomic<uint64_t> latency_counts[NbLatencyHistogram::kBucketNum]; /*!< 所要時間の区間別件数 */
+    };
+
+    Metrics metrics_[kOperationNum];    /*!< 操作種別毎の記録 */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBMETRICSREGISTRY_H
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBRESTASYNCENGINE_H
+#define NECBAAS_NBRESTASYNCENGINE_H
+
+#include <functional>
+#include <memory>
+#include <thread>
+#include "necbaas/nb_result.h"
+#include "necbaas/nb_http_response.h"
+#include "necbaas/internal/nb_http_request.h"
+#include "necbaas/internal/nb_constants.h"
+
+namespace necbaas {
+
+class NbRestExecutor;
+
+/**
+ * @class NbRestAsyncEngine nb_rest_async_engine.h "necbaas/internal/nb_rest_async_engine.h"
+ * REST非同期実行エンジン.
+ * CURLマルチハンドルを使用し、1つのイベントループスレッドで複数のREST APIを並行して実行する。<br>
+ * イベントループスレッドは最初のリクエスト登録時に起動する。<br>
+ * 完了コールバックはイベントループスレッドで呼び出されるため、コールバック内で長時間ブロックしないこと。
+ */
+class NbRestAsyncEngine {
+  public:
+    /**
+     * 完了コールバック.
+     */
+    typedef std::function<void(NbResult<NbHttpResponse>)> Callback;
+
+    /**
+     * コンストラクタ.
+     * @param[in]   http_connection_max       HTTP同時接続数最大値(超過した転送は接続の空き待ちとなる)
+     */
+    explicit NbRestAsyncEngine(int http_connection_max = kHttpConnectionMax);
+
+    /**
+     * デストラクタ.
+     * 実行中・実行待ちの転送は中断し、NB_ERROR_CANCELEDでコールバックを呼び出す。
+     */
+    ~NbRestAsyncEngine();
+
+    /**
+     * リクエスト登録.
+     * @param[in]   request         HTTPリクエスト
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     * @param[in]   callback        完了コールバック
+     */
+    void Submit(const NbHttpRequest &request, int timeout, Callback callback);
+
+    /**
+     * RestExecutor設定関数の登録.
+     * 転送開始時に、転送に使用するRestExecutorに対してイベントループスレッドで呼び出す。<br>
+     * RestExecutorのHTTP/2モードを有効にした場合、同一接続先への転送はHTTP/2の1接続上に多重化される。
+     * @param[in]   setup       RestExecutor設定関数(nullptrの場合は設定しない)
+     */
+    void SetExecutorSetup(std::function<void(NbRestExecutor *)> setup);
+
+    /**
+     * イベントループスレッド判定.
+     * @return      true:呼び出し元がイベントループスレッド(完了コールバック内)
+     */
+    bool IsLoopThread() const;
+
+    // コピーとムーブを禁止
+    NbRestAsyncEngine(NbRestAsyncEngine const&) = delete;
+    NbRestAsyncEngine& operator =(NbRestAsyncEngine const&) = delete;
+    NbRestAsyncEngine(NbRestAsyncEngine&&) = delete;
+    NbRestAsyncEngine& operator =(NbRestAsyncEngine&&) = delete;
+
+  private:
+    struct Context;
+
+    std::shared_ptr<Context> context_;   /*!< イベントループ共有データ */
+    std::thread loop_thread_;            /*!< イベントループスレッド */
+
+    /**
+     * イベントループ.
+     * コールバック経由でエンジン自身が破棄される場合に備え、共有データはスレッド側でも保持する。
+     * @param[in]   context     イベントループ共有データ
+     */
+    static void RunLoop(std::shared_ptr<Context> context);
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBRESTASYNCENGINE_H
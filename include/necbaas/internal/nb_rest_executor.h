@@ -9,6 +9,10 @@
 #define CURLPP_GLOBAL_H
 
 #include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <curlpp/Easy.hpp>
 #include "necbaas/nb_result.h"
 #include "necbaas/nb_result_code.h"
@@ -16,9 +20,13 @@
 #include "necbaas/internal/nb_http_request.h"
 #include "necbaas/internal/nb_http_handler.h"
 #include "necbaas/internal/nb_constants.h"
+#include "necbaas/internal/nb_curl_share.h"
+#include "necbaas/internal/nb_token_bucket.h"
 
 namespace necbaas {
 
+class NbHttpFileDownloadHandler;
+
 /**
  * @class NbRestExecutor nb_rest_executor.h "necbaas/internal/nb_rest_executor.h"
  * REST APIを実行するクラス.
@@ -58,6 +66,22 @@ public:
     virtual NbResult<NbHttpResponse> ExecuteFileDownload(const NbHttpRequest &request, const std::string &file_path,
                                                          int timeout = kRestTimeoutDefault);
 
+    /**
+     * REST実行(ファイルダウンロードの再開).
+     * file_pathに既存のファイルがある場合は、ファイルサイズの位置からRange指定で続きを受信して追記する。
+     * etagを指定した場合はIf-Rangeを付与し、サーバのファイルが更新されていれば全体を受信して上書きする。<br>
+     * サーバがRange指定に応じない(200)場合は全体を上書きし、416の場合は先頭から受信し直す。<br>
+     * 受信エラー時は既存のファイルを残す。受信完了後のファイルサイズはX-Content-Lengthと比較する。
+     * @param[in]   request         HTTPリクエスト
+     * @param[in]   file_path       ファイルパス
+     * @param[in]   etag            ファイルのETag(空文字の場合はIf-Rangeを付与しない)
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     * @return      処理結果
+     */
+    virtual NbResult<NbHttpResponse> ExecuteFileResumeDownload(const NbHttpRequest &request,
+                                                               const std::string &file_path, const std::string &etag,
+                                                               int timeout = kRestTimeoutDefault);
+
     /**
      * REST実行(データの送受信).
      * @param[in]   request         HTTPリクエスト
@@ -66,8 +90,266 @@ public:
      */
     virtual NbResult<NbHttpResponse> ExecuteRequest(const NbHttpRequest &request, int timeout = kRestTimeoutDefault);
 
+    /**
+     * REST実行(ボディのストリーミング受信).
+     * ステータスコードが200台の場合、受信したボディは保持せずに受信の都度sinkに渡す(処理結果のボディは空)。<br>
+     * sinkがfalseを返した場合は転送を中断し、NB_ERROR_CANCELEDを返す。
+     * @param[in]   request         HTTPリクエスト
+     * @param[in]   sink            受信データ出力先
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     * @return      処理結果
+     */
+    virtual NbResult<NbHttpResponse> ExecuteStreamRequest(const NbHttpRequest &request,
+                                                          std::function<bool(const char *, size_t)> sink,
+                                                          int timeout = kRestTimeoutDefault);
+
+    /**
+     * REST実行(ボディのストリーミング送信).
+     * 送信ボディは保持せずに、送信の都度producerから取得する。<br>
+     * content_lengthが0以上の場合はContent-Length、負の場合はchunked転送で送信する。
+     * producerが負の値を返した場合は転送を中断し、NB_ERROR_CANCELEDを返す。<br>
+     * PUT・POSTのみ実行可能。
+     * @param[in]   request         HTTPリクエスト(ボディは使用しない)
+     * @param[in]   producer        送信データ生成関数
+     * @param[in]   content_length  送信ボディサイズ(不明の場合は負の値)
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     * @return      処理結果
+     */
+    virtual NbResult<NbHttpResponse> ExecuteStreamUpload(const NbHttpRequest &request,
+                                                         std::function<int64_t(char *, size_t)> producer,
+                                                         int64_t content_length,
+                                                         int timeout = kRestTimeoutDefault);
+
+    /**
+     * 事前接続.
+     * リクエストのURLへHEADリクエストを送信し、接続(DNS解決・TCP・TLS)を確立する。
+     * 確立した接続は以降のリクエストで再利用される。<br>
+     * リクエストのHTTPメソッドとボディは使用しない。
+     * @param[in]   request         HTTPリクエスト
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     * @return      処理結果(Fatalエラー以外は、HTTPステータスコードに関わらず接続確立済み)
+     */
+    virtual NbResult<NbHttpResponse> Connect(const NbHttpRequest &request, int timeout = kRestTimeoutDefault);
+
+    /**
+     * 非同期REST実行準備(データの送受信).
+     * ExecuteRequest()と同じCURLオプションを設定する。転送自体は行わない。<br>
+     * 準備に成功した場合、GetCurlHandle()で取得したハンドルをCURLマルチハンドルに登録して転送し、
+     * 転送完了後にCompleteAsyncRequest()を呼び出すこと。
+     * @param[in]   request         HTTPリクエスト
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     * @return      処理結果コード(NB_OK以外は準備失敗)
+     */
+    virtual NbResultCode PrepareAsyncRequest(const NbHttpRequest &request, int timeout = kRestTimeoutDefault);
+
+    /**
+     * CURLハンドル取得.
+     * @return      CURLハンドル
+     */
+    CURL *GetCurlHandle() const;
+
+    /**
+     * 非同期REST実行完了.
+     * PrepareAsyncRequest()で準備した転送の受信データから処理結果を生成する。
+     * @param[in]   curl_code       CURLマルチハンドルから通知された転送結果
+     * @return      処理結果
+     */
+    virtual NbResult<NbHttpResponse> CompleteAsyncRequest(CURLcode curl_code);
+
+    /**
+     * 非同期転送の一時停止確認.
+     * 非同期実行中に帯域制限のトークンが不足した場合、送受信コールバックで待機せずに
+     * 不足分が補充されるまで転送を一時停止する。
+     * 一時停止中はGetResumeTime()以降にResumeTransfer()を呼び出すこと。
+     * @return      true:一時停止中／false:転送中
+     */
+    bool IsTransferPaused() const;
+
+    /**
+     * 非同期転送の再開時刻取得.
+     * @return      帯域制限のトークンが補充される時刻
+     */
+    std::chrono::steady_clock::time_point GetResumeTime() const;
+
+    /**
+     * 非同期転送の再開.
+     * 一時停止中の転送を再開する。イベントループスレッドから呼び出すこと。
+     */
+    void ResumeTransfer();
+
+    /**
+     * 接続再利用モード取得.
+     * @return      接続再利用モード
+     */
+    bool IsConnectionReuse() const;
+
+    /**
+     * 接続再利用モード設定.
+     * 有効にした場合、リクエスト毎のCURLオプションリセットを行わず、
+     * 送受信コールバック・NoSignal・TCP keep-alive等の固定オプションは初回のみ設定する。
+     * Proxy・タイムアウトは変更があった場合のみ再設定する。<br>
+     * 無効(デフォルト)の場合は、リクエスト毎に全オプションを再設定する。<br>
+     * いずれの場合も、CURLハンドルが保持する接続・TLSセッションは次のリクエストで再利用される。
+     * @param[in]   reuse       true:有効／false:無効
+     */
+    void SetConnectionReuse(bool reuse);
+
+    /**
+     * HTTP/2モード取得.
+     * @return      HTTP/2モード
+     */
+    bool IsHttp2() const;
+
+    /**
+     * HTTP/2モード設定.
+     * 有効にした場合、TLS接続時にALPNでHTTP/2をネゴシエーションする。
+     * サーバが対応していない場合、および平文HTTPの場合はHTTP/1.1で通信する。<br>
+     * CURLマルチハンドルで実行する場合は、多重化可能な既存接続の確立を待って相乗りする。
+     * @param[in]   http2       true:有効／false:無効
+     */
+    void SetHttp2(bool http2);
+
+    /**
+     * 共有キャッシュ取得.
+     * @return      共有キャッシュ(未設定の場合はnullptr)
+     */
+    const std::shared_ptr<NbCurlShare> &GetCurlShare() const;
+
+    /**
+     * 共有キャッシュ設定.
+     * 設定した場合、DNSキャッシュ、TLSセッションを同じ共有キャッシュを使用する
+     * 他のRestExecutorと共有する。新規に生成したRestExecutorでもDNS解決・TLSフルハンドシェイクを省略できる。
+     * @param[in]   share       共有キャッシュ(nullptrの場合は共有しない)
+     */
+    void SetCurlShare(std::shared_ptr<NbCurlShare> share);
+
+    /**
+     * 応答圧縮取得.
+     * @return      応答圧縮
+     */
+    bool IsResponseCompression() const;
+
+    /**
+     * 応答圧縮設定.
+     * 有効にした場合、ExecuteRequest()・非同期実行でAccept-Encodingヘッダを送信し、
+     * 圧縮された応答(gzip/deflate等)は自動で展開する。<br>
+     * デフォルト: 有効
+     * @param[in]   compression     true:有効／false:無効
+     */
+    void SetResponseCompression(bool compression);
+
+    /**
+     * リクエスト圧縮閾値取得.
+     * @return      リクエスト圧縮閾値(バイト)
+     */
+    int GetRequestCompressionThreshold() const;
+
+    /**
+     * リクエスト圧縮閾値設定.
+     * ExecuteRequest()のPUT・POSTで、圧縮対象に設定したリクエスト(NbHttpRequest::IsBodyCompressible())の
+     * HTTPボディが閾値以上の場合はgzip圧縮して送信する。
+     * サーバが圧縮されたリクエストを受け付ける場合のみ設定すること。<br>
+     * 0以下の場合は圧縮しない(デフォルト)。
+     * @param[in]   threshold       リクエスト圧縮閾値(バイト)
+     */
+    void SetRequestCompressionThreshold(int threshold);
+
+    /**
+     * ファイルダウンロード書込みバッファサイズ取得.
+     * @return      書込みバッファサイズ(バイト)
+     */
+    int GetFileDownloadBufferSize() const;
+
+    /**
+     * ファイルダウンロード書込みバッファサイズ設定.
+     * ExecuteFileDownload()、ExecuteFileResumeDownload()で受信データをまとめて書込むサイズ。
+     * 0以下の場合はバッファリングしない。<br>
+     * デフォルト: kDownloadBufferSize
+     * @param[in]   size            書込みバッファサイズ(バイト)
+     */
+    void SetFileDownloadBufferSize(int size);
+
+    /**
+     * ファイルダウンロード同期書込み取得.
+     * @return      true:有効／false:無効
+     */
+    bool IsFileDownloadSync() const;
+
+    /**
+     * ファイルダウンロード同期書込み設定.
+     * 有効にした場合、ExecuteFileDownload()、ExecuteFileResumeDownload()の受信完了時に
+     * ファイルの内容をストレージに同期(fsync)する。<br>
+     * デフォルト: 無効
+     * @param[in]   sync            true:有効／false:無効
+     */
+    void SetFileDownloadSync(bool sync);
+
+    /**
+     * 送信の帯域制限取得.
+     * @return      送信の帯域制限(未設定の場合はnullptr)
+     */
+    const std::shared_ptr<NbTokenBucket> &GetUploadLimiter() const;
+
+    /**
+     * 受信の帯域制限取得.
+     * @return      受信の帯域制限(未設定の場合はnullptr)
+     */
+    const std::shared_ptr<NbTokenBucket> &GetDownloadLimiter() const;
+
+    /**
+     * 帯域制限設定.
+     * 送受信コールバックで転送したバイト数を帯域制限から取得し、制限を超える場合は待機する。
+     * 同じ帯域制限を設定した他のRestExecutorと合わせて制限する。
+     * 帯域制限による待機時間もタイムアウトに含まれる。<br>
+     * 非同期実行(PrepareAsyncRequest())ではイベントループを止めないよう待機せず、
+     * 不足分が補充されるまで転送を一時停止する(IsTransferPaused()参照)。
+     * この場合、POST・PUTのボディも送信コールバックで分割して送信し、帯域制限の対象とする。
+     * @param[in]   upload          送信の帯域制限(nullptrの場合は制限しない)
+     * @param[in]   download        受信の帯域制限(nullptrの場合は制限しない)
+     */
+    void SetBandwidthLimiter(std::shared_ptr<NbTokenBucket> upload, std::shared_ptr<NbTokenBucket> download);
+
+    /**
+     * 転送中断要求.
+     * 実行中(または次に実行する)転送を中断し、処理結果を NB_ERROR_CANCELED とする。
+     * 他スレッドから呼び出すことができる。<br>
+     * 中断はCURLの進捗コールバックで行うため、反映まで最大1秒程度かかる。
+     * 要求は ClearCancel() を呼び出すまで有効。
+     */
+    void Cancel();
+
+    /**
+     * 転送中断要求の解除.
+     */
+    void ClearCancel();
+
 protected:
-    curlpp::Easy curlpp_easy_;    /*!< cURLppインスタンス */
+    // CURLハンドルより後に破棄するため、curlpp_easy_より前に宣言する
+    std::shared_ptr<NbCurlShare> curl_share_;       /*!< 共有キャッシュ */
+    curlpp::Easy curlpp_easy_;                      /*!< cURLppインスタンス */
+    std::unique_ptr<NbHttpHandler> async_handler_;  /*!< 非同期実行中のHTTPハンドラ */
+    NbHttpHandler *current_handler_{nullptr};       /*!< 送受信コールバックの転送先 */
+    bool connection_reuse_{false};                  /*!< 接続再利用モード */
+    bool http2_{false};                             /*!< HTTP/2モード */
+    bool persistent_options_set_{false};            /*!< 固定オプション設定済み */
+    std::string current_proxy_;                     /*!< 設定中のProxy */
+    int current_timeout_{-1};                       /*!< 設定中のタイムアウト(秒) */
+    bool response_compression_{true};               /*!< 応答圧縮 */
+    int request_compression_threshold_{0};          /*!< リクエスト圧縮閾値(バイト) */
+    int file_download_buffer_size_;                 /*!< ファイルダウンロード書込みバッファサイズ(バイト) */
+    bool file_download_sync_{false};                /*!< ファイルダウンロード同期書込み */
+    std::shared_ptr<NbTokenBucket> upload_limiter_;   /*!< 送信の帯域制限 */
+    std::shared_ptr<NbTokenBucket> download_limiter_; /*!< 受信の帯域制限 */
+    bool async_transfer_{false};                    /*!< 非同期実行中 */
+    bool paused_{false};                            /*!< 帯域制限による非同期転送の一時停止中 */
+    std::chrono::steady_clock::time_point resume_time_; /*!< 一時停止した転送の再開時刻 */
+    int64_t request_body_size_{0};                  /*!< 送信ボディサイズ(圧縮前、POSTFIELDS分) */
+    std::string async_body_;                        /*!< 帯域制限中の非同期実行の送信ボディ */
+    size_t async_body_offset_{0};                   /*!< async_body_の送信済みサイズ */
+    bool async_body_paced_{false};                  /*!< async_body_を送信コールバックで送信中 */
+    int64_t read_size_{0};                          /*!< 送信コールバックで送信したサイズ */
+    int64_t write_size_{0};                         /*!< 受信コールバックで受信したサイズ(展開後) */
+    std::atomic<bool> cancel_requested_{false};     /*!< 転送中断要求 */
 
     /**
      * CURLオプション 共通設定.
@@ -77,6 +359,105 @@ protected:
      */
     void SetOptCommon(const NbHttpRequest &request, NbHttpHandler &http_handler, int timeout);
 
+    /**
+     * CURLオプション 固定設定.
+     * 送受信コールバック、NoSignal等のリクエストに依存しないオプションを設定する。
+     */
+    void SetOptPersistent();
+
+    /**
+     * CURLオプション HTTPメソッド関連の初期化.
+     * 接続再利用モードで、前回リクエストのメソッド・ボディ設定を解除する。
+     */
+    void ResetOptRequest();
+
+    /**
+     * HTTPヘッダ受信コールバック.
+     * current_handler_に転送する。
+     * @param[in]   buffer      受信データ
+     * @param[in]   size        データサイズ
+     * @param[in]   nmemb       データ数
+     * @return      処理したデータサイズ
+     */
+    size_t WriteHeaderCallback(char *buffer, size_t size, size_t nmemb);
+
+    /**
+     * HTTPボディ受信コールバック.
+     * current_handler_に転送する。
+     * @param[in]   buffer      受信データ
+     * @param[in]   size        データサイズ
+     * @param[in]   nmemb       データ数
+     * @return      処理したデータサイズ
+     */
+    size_t WriteCallback(char *buffer, size_t size, size_t nmemb);
+
+    /**
+     * HTTPボディ送信コールバック.
+     * current_handler_に転送する。
+     * @param[out]  buffer      送信データ格納先
+     * @param[in]   size        データサイズ
+     * @param[in]   nmemb       データ数
+     * @return      格納したデータサイズ
+     */
+    size_t ReadCallback(char *buffer, size_t size, size_t nmemb);
+
+    /**
+     * 帯域制限による非同期転送の一時停止判定.
+     * 前回の転送で予約したトークンの補充時刻前の場合は、一時停止状態にする。
+     * @return      true:一時停止する／false:転送を継続する
+     */
+    bool PauseIfWaiting();
+
+    /**
+     * 非同期転送の帯域予約.
+     * 転送したサイズのトークンを待機せずに消費し、不足する場合は補充時刻を再開時刻とする。
+     * @param[in]   limiter     帯域制限
+     * @param[in]   size        転送したサイズ
+     */
+    void ReserveBandwidth(NbTokenBucket &limiter, int64_t size);
+
+    /**
+     * 送信位置変更コールバック(CURLコールバック).
+     * 再送時にasync_body_の送信位置を戻す。
+     * @param[in]   userptr     RestExecutor
+     * @param[in]   offset      送信位置
+     * @param[in]   origin      基準位置(SEEK_SETのみ対応)
+     * @return      CURL_SEEKFUNC_OK:成功／CURL_SEEKFUNC_CANTSEEK:変更不可
+     */
+    static int SeekCallback(void *userptr, curl_off_t offset, int origin);
+
+    /**
+     * 転送進捗コールバック(CURLコールバック).
+     * 転送中断要求がある場合は転送を中断させる。
+     * @param[in]   userptr     RestExecutor
+     * @return      0:継続／0以外:中断
+     */
+    static int ProgressCallback(void *userptr, curl_off_t dltotal, curl_off_t dlnow,
+                                curl_off_t ultotal, curl_off_t ulnow);
+
+    /**
+     * CURLオプション データ送受信用設定.
+     * 共通設定に加え、受信コールバック、HTTPメソッド、ボディ、ヘッダを設定する。
+     * @param[in]   request         HTTPリクエスト
+     * @param[in]   http_handler    HTTPハンドラ
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     */
+    void SetOptRequest(const NbHttpRequest &request, NbHttpHandler &http_handler, int timeout);
+
+    /**
+     * CURLオプション 応答圧縮設定.
+     * JSON APIの応答受信(ExecuteRequest()、非同期実行)でのみ使用し、ストリーム・ファイル転送は圧縮しない。
+     * @param[in]   request         HTTPリクエスト
+     */
+    void SetOptAcceptEncoding(const NbHttpRequest &request);
+
+    /**
+     * リクエスト圧縮判定.
+     * @param[in]   request         HTTPリクエスト
+     * @return      true:圧縮する／false:圧縮しない
+     */
+    bool IsRequestCompressionTarget(const NbHttpRequest &request) const;
+
     /**
      * 処理結果生成.
      * @param[in]   http_handler    HTTPハンドラ
@@ -96,6 +477,20 @@ protected:
      */
     bool ValidateFileSize(const NbHttpResponse &response, const std::string &file_name) const;
 
+    /**
+     * ファイルダウンロード実行(共通処理).
+     * @param[in]   request         HTTPリクエスト
+     * @param[in]   request_headers 送信するHTTPヘッダ
+     * @param[in]   http_handler    ファイルダウンロード用HTTPハンドラ
+     * @param[in]   file_path       ファイルパス
+     * @param[in]   timeout         RESTタイムアウト(秒)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteFileDownloadCommon(const NbHttpRequest &request,
+                                                       const std::list<std::string> &request_headers,
+                                                       NbHttpFileDownloadHandler &http_handler,
+                                                       const std::string &file_path, int timeout);
+
     /**
      * REST実行開始.
      */   
@@ -7,18 +7,39 @@
 
 #include <string>
 #include <list>
-#include <stack>
+#include <vector>
+#include <deque>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <condition_variable>
+#include <cstdint>
 #include "necbaas/internal/nb_rest_executor.h"
 #include "necbaas/internal/nb_constants.h"
 
 namespace necbaas {
 
+/**
+ * @struct NbRestExecutorPoolStatistics nb_rest_executor_pool.h "necbaas/internal/nb_rest_executor_pool.h"
+ * RestExecutorプール統計情報.
+ */
+struct NbRestExecutorPoolStatistics {
+    uint64_t acquired_count{0};         /*!< 払い出し成功回数 */
+    uint64_t waited_count{0};           /*!< 空き待ちが発生した回数 */
+    uint64_t failed_count{0};           /*!< 払い出し失敗(HTTP同時接続数オーバー)回数 */
+    uint64_t total_wait_time_us{0};     /*!< 空き待ち時間の合計(マイクロ秒) */
+    uint64_t max_wait_time_us{0};       /*!< 空き待ち時間の最大値(マイクロ秒) */
+};
+
 /**
  * @class NbRestExecutorPool nb_rest_executor_pool.h "necbaas/internal/nb_rest_executor_pool.h"
  * RestExecutorプール.
  * RestExecutorの払い出し、返却処理を提供する。
- * 同時に払い出し可能なRestExecutorの上限を設け、上限に達した場合は払い出しが失敗する。
+ * 同時に払い出し可能なRestExecutorの上限を設け、上限に達した場合は払い出しが失敗する。<br>
+ * 待ち時間を指定した場合は、上限に達していても返却を待ち合わせる。
+ * 待ち合わせは到着順(FIFO)で、返却されたRestExecutorは先頭の待ち合わせに直接引き渡す。<br>
+ * 使用可能RestExecutorはスレッドIDで振り分けたシャードで保持し、シャード毎に排他する。
+ * 返却したスレッドと同じスレッドの払い出しでは、最後に返却したRestExecutorが優先して払い出される。
  */
 class NbRestExecutorPool {
   public:
@@ -41,12 +62,38 @@ class NbRestExecutorPool {
      */
     NbRestExecutor *PopRestExecutor();
 
+    /**
+     * RestExecutorの払い出し(空き待ちあり).
+     * HTTP同時接続数オーバーの場合、最大wait_timeoutミリ秒の間、返却を待ち合わせる。<br>
+     * 0以下の値を指定した場合は待ち合わせしない。
+     * @param[in]   wait_timeout    空き待ちタイムアウト(ミリ秒)
+     * @return      RestExecutor
+     * @retval      nullptr以外  払い出し成功
+     * @retval      nullptr      HTTP同時接続数オーバー(待ち合わせタイムアウト)
+     */
+    NbRestExecutor *PopRestExecutor(int wait_timeout);
+
+    /**
+     * RestExecutorの払い出し(空きがある場合のみ).
+     * 空きの有無を確認する用途のため、払い出せない場合もエラーログを出力せず、失敗回数に計上しない。
+     * @return      RestExecutor
+     * @retval      nullptr以外  払い出し成功
+     * @retval      nullptr      空き無し
+     */
+    NbRestExecutor *TryPopRestExecutor();
+
     /**
      * RestExecutorの返却.
      * @param[in]   rest_executor    RestExecutor
      */
     void PushRestExecutor(NbRestExecutor *rest_executor);
 
+    /**
+     * 統計情報取得.
+     * @return      統計情報
+     */
+    NbRestExecutorPoolStatistics GetStatistics();
+
     // コピーとムーブを禁止
     NbRestExecutorPool(NbRestExecutorPool const&) = delete;
     NbRestExecutorPool& operator =(NbRestExecutorPool const&) = delete;
@@ -54,9 +101,64 @@ class NbRestExecutorPool {
     NbRestExecutorPool& operator =(NbRestExecutorPool&&) = delete;
 
   protected:
-    std::stack<NbRestExecutor*> idle_stack_;   /*!< 使用可能RestExecutorのスタック */
-    int creatable_num_;                        /*!< 生成可能RestExecutorの残数 */
-    std::mutex stack_mutex_;                   /*!< スタック用Mutex */
+    /**
+     * 空き待ち情報.
+     */
+    struct Waiter {
+        std::condition_variable cond;            /*!< 引き渡し通知 */
+        NbRestExecutor *rest_executor{nullptr};  /*!< 引き渡されたRestExecutor */
+    };
+
+    /**
+     * 使用可能RestExecutorのシャード.
+     */
+    struct Shard {
+        std::mutex mutex;                        /*!< シャード用Mutex */
+        std::vector<NbRestExecutor *> idle;      /*!< 使用可能RestExecutor(末尾が最後に返却されたもの) */
+        std::atomic<uint64_t> acquired_count{0}; /*!< 払い出し成功回数 */
+        std::atomic<uint64_t> failed_count{0};   /*!< 払い出し失敗回数 */
+        char padding[64];                        /*!< 隣接シャードとのキャッシュライン共有防止 */
+    };
+
+    std::unique_ptr<Shard[]> shards_;          /*!< シャード */
+    size_t shard_num_;                         /*!< シャード数 */
+    std::atomic<int> creatable_num_;           /*!< 生成可能RestExecutorの残数 */
+    std::atomic<int> waiter_num_{0};           /*!< 空き待ち数 */
+    std::mutex waiter_mutex_;                  /*!< 空き待ちキュー用Mutex */
+    std::deque<Waiter *> waiters_;             /*!< 空き待ちキュー(到着順) */
+    NbRestExecutorPoolStatistics wait_statistics_; /*!< 空き待ち統計情報(waiter_mutex_で保護) */
+
+    /**
+     * 呼び出しスレッドのシャード取得.
+     * @return      シャード
+     */
+    Shard &GetShard();
+
+    /**
+     * 使用可能RestExecutorの取り出し.
+     * 呼び出しスレッドのシャードを優先し、空の場合は他のシャードから取り出す。
+     * @return      RestExecutor(使用可能なものが無い場合はnullptr)
+     */
+    NbRestExecutor *TakeIdleRestExecutor();
+
+    /**
+     * RestExecutorの生成.
+     * @return      RestExecutor(生成可能数の上限に達している場合はnullptr)
+     */
+    NbRestExecutor *CreateRestExecutor();
+
+    /**
+     * RestExecutorの返却待ち合わせ.
+     * @param[in]   wait_timeout    空き待ちタイムアウト(ミリ秒)
+     * @return      RestExecutor(タイムアウトした場合はnullptr)
+     */
+    NbRestExecutor *WaitRestExecutor(int wait_timeout);
+
+    /**
+     * 空き待ちへの引き渡し.
+     * waiter_mutex_をロックした状態で呼び出すこと。
+     */
+    void HandOverToWaiters();
 };
 } //namespace necbaas
 
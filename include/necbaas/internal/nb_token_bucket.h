@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBTOKENBUCKET_H
+#define NECBAAS_NBTOKENBUCKET_H
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace necbaas {
+
+/**
+ * @class NbTokenBucket nb_token_bucket.h "necbaas/internal/nb_token_bucket.h"
+ * トークンバケットによる流量制限.
+ * 1秒あたりのレートでトークンを補充し、最大で1秒分まで蓄積する。<br>
+ * トークンが不足する場合は、不足分が補充されるまで呼び出し元スレッドを待機させる。
+ * 待機できないスレッド(イベントループ)では、Reserve()で待機時間を取得して呼び出し元で待ち合わせる。<br>
+ * 複数スレッドから使用でき、実行中でもレートを変更できる。
+ */
+class NbTokenBucket {
+  public:
+    /**
+     * コンストラクタ.
+     * 制限なしの状態で生成する。
+     */
+    NbTokenBucket();
+
+    /**
+     * レート取得.
+     * @return      1秒あたりのトークン数(0の場合は制限なし)
+     */
+    int64_t GetRate() const;
+
+    /**
+     * レート設定.
+     * 蓄積済みのトークンは新しいレートの1秒分までに切り詰める。
+     * @param[in]   rate        1秒あたりのトークン数(0以下の場合は制限なし)
+     */
+    void SetRate(int64_t rate);
+
+    /**
+     * 制限有無確認.
+     * @return      true:制限あり／false:制限なし
+     */
+    bool IsLimited() const;
+
+    /**
+     * トークン取得.
+     * トークンは先に消費し、不足分(他スレッドの不足分を含む)が補充されるまで待機する。
+     * 制限なしの場合は待機しない。
+     * @param[in]   tokens      取得するトークン数
+     */
+    void Acquire(int64_t tokens);
+
+    /**
+     * トークン予約.
+     * Acquire()と同様にトークンを先に消費し、待機せずに不足分が補充されるまでの時間を返す。
+     * 呼び出し元は、返却された時間が経過するまで次の転送を行わないこと。
+     * 制限なしの場合は0を返す。
+     * @param[in]   tokens      取得するトークン数
+     * @return      待機時間(ミリ秒、0の場合は待機不要)
+     */
+    int64_t Reserve(int64_t tokens);
+
+  private:
+    std::mutex mutex_;                                  /*!< トークン更新用Mutex */
+    std::atomic<int64_t> rate_{0};                      /*!< 1秒あたりのトークン数(制限なしの判定はロックせずに行う) */
+    double tokens_{0};                                  /*!< 蓄積済みのトークン数(負の場合は不足分) */
+    std::chrono::steady_clock::time_point last_refill_; /*!< 最終補充時刻 */
+
+    /**
+     * トークン補充.
+     * 最終補充時刻からの経過時間分のトークンを補充する。mutex_をロックして呼び出すこと。
+     */
+    void Refill();
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBTOKENBUCKET_H
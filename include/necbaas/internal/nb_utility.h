@@ -31,10 +31,11 @@ extern std::string TmToDateString(const std::tm &time);
 
 /**
  * ファイルサイズ取得.
+ * 2GBを超えるファイルにも対応する。
  * @param[in]   file_name       ファイル名
- * @return      ファイルサイズ
+ * @return      ファイルサイズ(ファイルがない場合は0)
  */
-extern int GetFileSize(const std::string &file_name);
+extern int64_t GetFileSize(const std::string &file_name);
 
 /**
  * Jsonタイプ変換.
@@ -50,6 +51,24 @@ extern NbJsonType ConvertJsonType(Json::ValueType json_type);
  * @return      比較結果  
  */
 extern bool CompareCaseInsensitiveString(std::string str1, std::string str2);
+
+/**
+ * 文字列比較(大文字小文字区別なし、ASCIIのみ).
+ * 文字列を複製せずに比較する。
+ * @param[in]   str1       文字列１の先頭
+ * @param[in]   length1    文字列１の長さ
+ * @param[in]   str2       文字列２
+ * @return      比較結果
+ */
+extern bool CompareCaseInsensitiveString(const char *str1, size_t length1, const std::string &str2);
+
+/**
+ * gzip圧縮.
+ * @param[in]   data            圧縮するデータ
+ * @param[out]  compressed      圧縮結果(gzip形式)
+ * @return      true:成功／false:失敗
+ */
+extern bool GzipCompress(const std::string &data, std::string *compressed);
 } //namespace NbUtility
 } //namespace necbaas
 
@@ -9,7 +9,10 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <future>
+#include <functional>
 #include "necbaas/nb_service.h"
+#include "necbaas/internal/nb_async_result.h"
 
 namespace necbaas {
 
@@ -21,6 +24,24 @@ namespace necbaas {
  */
 class NbApiGateway {
    public:
+    /**
+     * 非同期実行の完了コールバック.
+     */
+    typedef NbAsyncResult<NbHttpResponse>::Callback AsyncCallback;
+
+    /**
+     * レスポンスボディ出力先.
+     * 受信したデータとサイズを受け取り、受信を継続する場合はtrue、中断する場合はfalseを返す。
+     */
+    typedef std::function<bool(const char *data, size_t size)> ResponseSink;
+
+    /**
+     * リクエストボディ生成関数.
+     * bufferに最大sizeバイトの送信データを書き込み、書き込んだバイト数を返す。<br>
+     * 送信データの終端では0、送信を中断する場合は負の値を返す。
+     */
+    typedef std::function<int64_t(char *buffer, size_t size)> RequestProducer;
+
     /**
      * コンストラクタ.
      * @param[in]   service        サービスインスタンス
@@ -58,6 +79,74 @@ class NbApiGateway {
      */
     NbResult<NbHttpResponse> ExecuteCustomApi(const std::vector<char> &body);
 
+    /**
+     * カスタムAPI実行(レスポンスボディのストリーミング受信).
+     * 文字列Body付きのカスタムAPIを実行し、レスポンスボディを受信の都度sinkに渡す。<br>
+     * レスポンス全体をメモリに保持しないため、サイズの大きいレスポンスの受信に使用する。<br>
+     * sinkは受信処理中に呼び出し元スレッドで呼び出される。sinkがfalseを返した場合は受信を中断し、
+     * NB_ERROR_CANCELEDを返す。<br>
+     * ステータスコードが200台の場合、処理結果のボディは空となる。
+     * 200台以外の場合はsinkを呼び出さず、エラー内容をRESTエラーデータに設定する。<br>
+     * 受信済みのデータは取り消せないため、リトライ・重複送信は行わない。<br>
+     * その他の仕様はExecuteCustomApi()と同じである。
+     * @param[in]   body        Bodyデータ(文字列)
+     * @param[in]   sink        レスポンスボディ出力先
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteCustomApi(const std::string &body, ResponseSink sink);
+
+    /**
+     * カスタムAPI実行(レスポンスボディのファイルディスクリプタ出力).
+     * レスポンスボディを受信の都度、指定のファイルディスクリプタに書き込む。
+     * ファイルディスクリプタはクローズしない。<br>
+     * 書込みに失敗した場合は受信を中断し、NB_ERROR_CANCELEDを返す。<br>
+     * その他の仕様はsink指定のExecuteCustomApi()と同じである。
+     * @param[in]   body        Bodyデータ(文字列)
+     * @param[in]   fd          出力先ファイルディスクリプタ
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteCustomApi(const std::string &body, int fd);
+
+    /**
+     * カスタムAPI実行(リクエストボディのストリーミング送信).
+     * リクエストボディ全体をメモリに保持せず、送信の都度producerから取得する。<br>
+     * content_lengthが0以上の場合はContent-Lengthを付与し、負の場合(サイズ不明)はchunked転送で送信する。<br>
+     * producerは送信処理中に呼び出し元スレッドで呼び出される。producerが負の値を返した場合は送信を中断し、
+     * NB_ERROR_CANCELEDを返す。<br>
+     * POST/PUTメソッドの場合、Content-Typeの設定が必須である。GET/DELETEメソッドの場合は、producerを使用しない。<br>
+     * 送信済みのデータは再生成できないため、リトライ・重複送信は行わない。<br>
+     * その他の仕様はExecuteCustomApi()と同じである。
+     * @param[in]   producer        リクエストボディ生成関数
+     * @param[in]   content_length  リクエストボディサイズ(不明の場合は負の値)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteCustomApi(RequestProducer producer, int64_t content_length = -1);
+
+    /**
+     * カスタムAPI非同期実行.
+     * 文字列Body付きのカスタムAPIを非同期に実行する。呼び出しスレッドはREST完了を待たずに復帰する。<br>
+     * 処理結果はfutureとコールバックの両方に通知される(コールバック呼び出し後にfutureへ設定)。<br>
+     * コールバックはSDK内部のイベントループスレッドで呼び出されるため、長時間ブロックしないこと。<br>
+     * パラメータエラーの場合は、本メソッド内でコールバックを呼び出す。<br>
+     * その他の仕様はExecuteCustomApi()と同じである。
+     * @param[in]   body        Bodyデータ(文字列)
+     * @param[in]   callback    完了コールバック(nullptr：呼び出さない)
+     * @return      処理結果のfuture
+     */
+    std::future<NbResult<NbHttpResponse>> ExecuteCustomApiAsync(const std::string &body = "",
+                                                                AsyncCallback callback = nullptr);
+
+    /**
+     * カスタムAPI非同期実行.
+     * バイナリBody付きのカスタムAPIを非同期に実行する。<br>
+     * その他の仕様は文字列Body版のExecuteCustomApiAsync()と同じである。
+     * @param[in]   body        Bodyデータ(バイナリ)
+     * @param[in]   callback    完了コールバック(nullptr：呼び出さない)
+     * @return      処理結果のfuture
+     */
+    std::future<NbResult<NbHttpResponse>> ExecuteCustomApiAsync(const std::vector<char> &body,
+                                                                AsyncCallback callback = nullptr);
+
     /**
      * RESTタイムアウト取得.
      * @return      タイムアウト(秒)
@@ -169,21 +258,41 @@ class NbApiGateway {
     /**
      * Content-Typeヘッダ判定.
      * PSOT/PUTメソッドでボディが設定されている場合、Content-Typeが設定されているか確認する。
-     * @param[in]       body                ボディ
+     * @param[in]       has_body            ボディ有無
      * @return  判定結果
      * @retval  true    OK
      * @retval  false   NG
      */
-    bool CheckContentType(const std::string &body);
+    bool CheckContentType(bool has_body);
+
+    /**
+     * リクエスト実行前チェック.
+     * api-name, Content-Typeの設定を確認する。
+     * @param[in]       has_body            ボディ有無
+     * @return  チェック結果
+     * @retval  NB_OK   OK
+     * @retval  NB_OK以外   NG(エラーコード)
+     */
+    NbResultCode CheckRequest(bool has_body);
+
+    /**
+     * HTTPリクエスト作成.
+     * @param[in]       body                ボディ
+     * @param[in,out]   request_factory     HTTPリクエストファクトリ
+     * @param[in]       streaming           ボディをストリーミング送信するか
+     * @return  HTTPリクエスト
+     */
+    NbHttpRequest CreateRequest(const std::string &body, NbHttpRequestFactory *request_factory,
+                                bool streaming = false);
 
     /**
      * Content-Typeヘッダ追加.
      * HTTPリクエストファクトリにContent-Typeを設定する。<br>
-     * ボディが空の場合は何もしない。<br>
-     * @param[in]       body                ボディ
+     * ボディが無い場合は何もしない。<br>
+     * @param[in]       has_body            ボディ有無
      * @param[in,out]   request_factory     HTTPリクエストファクトリ
      */
-    void AppendContentType(const std::string &body, NbHttpRequestFactory *request_factory);
+    void AppendContentType(bool has_body, NbHttpRequestFactory *request_factory);
 
     /**
      * 予約ヘッダ名確認.
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBCIRCUITBREAKERPOLICY_H
+#define NECBAAS_NBCIRCUITBREAKERPOLICY_H
+
+namespace necbaas {
+
+/**
+ * サーキットブレーカー状態.
+ */
+enum class NbCircuitBreakerState {
+    CLOSED,     /*!< 通常(REST APIを実行する) */
+    OPEN,       /*!< 遮断(REST APIを実行せず、NB_ERROR_CIRCUIT_OPENを返す) */
+    HALF_OPEN,  /*!< 試行(限られた数のREST APIのみ実行し、結果により通常・遮断に遷移する) */
+};
+
+/**
+ * @struct NbCircuitBreakerPolicy nb_circuit_breaker_policy.h "necbaas/nb_circuit_breaker_policy.h"
+ * サーキットブレーカーポリシー.
+ * 直近window_size件のREST APIのうち、失敗(通信エラー、ステータスコード5xx)の割合、
+ * または低速(slow_call_threshold_ms以上)の割合が閾値以上となった場合に遮断状態へ遷移する。<br>
+ * 遮断状態はopen_duration_ms経過後に試行状態へ遷移し、試行したREST APIが全て成功した場合に通常状態へ戻る。
+ * 試行したREST APIが1件でも失敗した場合は、再度遮断状態へ遷移する。
+ */
+struct NbCircuitBreakerPolicy {
+    bool enabled{false};                /*!< サーキットブレーカーを使用する */
+    int window_size{20};                /*!< 失敗率の算出に使用する直近のREST API数 */
+    int minimum_calls{10};              /*!< 失敗率を判定する最小のREST API数 */
+    int failure_rate_threshold{50};     /*!< 遮断する失敗率(%) */
+    int slow_call_threshold_ms{10000};  /*!< 低速と判定する所要時間(ミリ秒。0以下の場合は判定しない) */
+    int slow_call_rate_threshold{80};   /*!< 遮断する低速の割合(%) */
+    int open_duration_ms{30000};        /*!< 遮断状態の継続時間(ミリ秒) */
+    int half_open_calls{3};             /*!< 試行状態で実行するREST API数 */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBCIRCUITBREAKERPOLICY_H
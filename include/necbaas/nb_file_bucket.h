@@ -7,8 +7,11 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "necbaas/nb_service.h"
 #include "necbaas/nb_file_metadata.h"
+#include "necbaas/nb_file_transfer_job.h"
+#include "necbaas/nb_file_transfer_result.h"
 
 namespace necbaas {
 
@@ -37,13 +40,91 @@ class NbFileBucket {
      * file_pathにファイルが存在する場合、上書き保存となる。<br>
      * ダウンロード中にエラーを検出した場合、その時点までのデータが保存されたファイルが作成される。<br>
      * file_name, file_pathが空文字の場合、パラメータ不正のエラーを返す。<br>
-     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。
+     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。<br>
+     * ファイルサイズがintの範囲を超える場合は、NB_ERROR_FILE_DOWNLOADを返す。
+     * 2GB以上のファイルはDownloadLargeFile()を使用すること。
      * @param[in]   file_name     ダウンロードするファイルの名前
      * @param[in]   file_path     ダウンロードしたファイルの保存先
      * @return      処理結果
      */
     NbResult<int> DownloadFile(const std::string &file_name, const std::string &file_path);
 
+    /**
+     * ファイルダウンロード(2GB以上のファイル).
+     * ファイルサイズをint64_tで返す以外は、DownloadFile()と同じである。
+     * @param[in]   file_name     ダウンロードするファイルの名前
+     * @param[in]   file_path     ダウンロードしたファイルの保存先
+     * @return      処理結果(成功時はファイルサイズ)
+     */
+    NbResult<int64_t> DownloadLargeFile(const std::string &file_name, const std::string &file_path);
+
+    /**
+     * ファイルダウンロード(呼び出し元バッファへの受信).
+     * ファイルを経由せずに、受信データをbufferに直接書き込む。<br>
+     * ファイルサイズがcapacityを超える場合は受信を中断し、NB_ERROR_FILE_DOWNLOADを返す。
+     * エラー時のbufferの内容は不定である。<br>
+     * file_nameが空文字、bufferがnullptrの場合、パラメータ不正のエラーを返す。<br>
+     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。
+     * @param[in]   file_name     ダウンロードするファイルの名前
+     * @param[out]  buffer        受信バッファ
+     * @param[in]   capacity      受信バッファサイズ
+     * @return      処理結果(成功時は受信サイズ)
+     */
+    NbResult<int64_t> DownloadFile(const std::string &file_name, char *buffer, size_t capacity);
+
+    /**
+     * ファイルダウンロード(可変長バッファへの受信).
+     * ファイルを経由せずに、受信データをbufferに格納する。bufferの既存の内容は置き換えられる。<br>
+     * 受信バッファはContent-Lengthから一括で確保し、受信完了後に複製せずにbufferへ移動する。<br>
+     * file_nameが空文字、bufferがnullptrの場合、パラメータ不正のエラーを返す。<br>
+     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。
+     * @param[in]   file_name     ダウンロードするファイルの名前
+     * @param[out]  buffer        受信バッファ
+     * @return      処理結果(成功時は受信サイズ)
+     */
+    NbResult<int64_t> DownloadFile(const std::string &file_name, std::vector<char> *buffer);
+
+    /**
+     * ファイルダウンロード(並列).
+     * metadataのファイルサイズを元にファイルをRange指定の範囲に分割し、複数の接続で並行してダウンロードする。
+     * 保存先ファイルは事前にファイルサイズ分を確保し、各範囲の受信データを該当位置に直接書き込む。<br>
+     * 分割数はparallel_count・HTTP同時接続数最大値・ファイルサイズ(1範囲あたり最小256KB)から決定する。
+     * 分割数が1の場合は、DownloadLargeFile()と同じ処理を行う。<br>
+     * 各範囲の転送に使用する接続は開始前に確保し、空きが分割数に満たない場合は確保できた数に分割する。
+     * 1つ目の接続はNbService::SetConnectionWaitTimeout()の空き待ち時間まで待ち、
+     * 1つしか確保できない場合はDownloadLargeFile()と同じ処理を行う。<br>
+     * サーバがRange指定に対応していない場合、NB_ERROR_FILE_DOWNLOADを返す。<br>
+     * 各範囲の応答のX-Content-Lengthがmetadataのファイルサイズと異なる場合(metadataが古い場合)、
+     * NB_ERROR_FILE_DOWNLOADを返す。<br>
+     * file_pathにファイルが存在する場合、上書き保存となる。
+     * ダウンロード中にエラーを検出した場合、内容が不完全なファイルが作成される。<br>
+     * metadataのfile_name、file_pathが空文字、parallel_countが1未満の場合、パラメータ不正のエラーを返す。<br>
+     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。
+     * @param[in]   metadata       ダウンロードするファイルのメタデータ
+     * @param[in]   file_path      ダウンロードしたファイルの保存先
+     * @param[in]   parallel_count 並列数
+     * @return      処理結果(成功時はファイルサイズ)
+     */
+    NbResult<int64_t> DownloadFile(const NbFileMetadata &metadata, const std::string &file_path, int parallel_count);
+
+    /**
+     * ファイルダウンロード(再開).
+     * 前回のダウンロードが途中で失敗した場合に、保存済みのデータの続きからダウンロードする。<br>
+     * ダウンロード中はfile_pathに".etag"を付加したファイルにmetadataのファイルETagを保存し、
+     * 再開時にETagが一致しない場合(ファイルが更新されている場合)は先頭からダウンロードする。
+     * また、If-Rangeを付与し、サーバ側でもファイルの更新を判定する。<br>
+     * ダウンロード中にエラーを検出した場合は、その時点までのデータとETagを保存したファイルを残す。
+     * サーバが返却した範囲(Content-Range)の開始位置が保存済みのデータサイズと異なる場合は、
+     * 受信を中断してNB_ERROR_FILE_DOWNLOADを返す。<br>
+     * 受信完了後のファイルサイズはX-Content-Lengthと比較し、一致した場合のみETagを保存したファイルを削除する。<br>
+     * metadataのfile_name、file_pathが空文字の場合、パラメータ不正のエラーを返す。<br>
+     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。
+     * @param[in]   metadata      ダウンロードするファイルのメタデータ
+     * @param[in]   file_path     ダウンロードしたファイルの保存先
+     * @return      処理結果(成功時はファイルサイズ)
+     */
+    NbResult<int64_t> ResumeDownloadFile(const NbFileMetadata &metadata, const std::string &file_path);
+
     /**
      * ファイルの新規アップロード.
      * file_name, file_path, content_typeが空文字の場合、パラメータ不正のエラーを返す。<br>
@@ -73,6 +154,38 @@ class NbFileBucket {
     NbResult<NbFileMetadata> UploadNewFile(const std::string &file_name, const std::string &file_path,
                                            const std::string &content_type, bool cache_disable = false);
 
+    /**
+     * ファイルの新規アップロード(メモリ上のデータ).
+     * ファイルを経由せずに、dataを複製せずに送信する。処理完了までdataを解放しないこと。<br>
+     * file_name, content_typeが空文字、dataがnullptrの場合、パラメータ不正のエラーを返す。
+     * (sizeが0の場合、dataはnullptrでもよい)<br>
+     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。<br>
+     * 明示的にACLを設定しない場合はオーバーロードメソッドを使用すること。
+     * @param[in]   file_name     アップロードするファイルの名前
+     * @param[in]   data          アップロードするデータ
+     * @param[in]   size          アップロードするデータのサイズ
+     * @param[in]   content_type  Content-Type
+     * @param[in]   acl           ACL
+     * @param[in]   cache_disable キャッシュ禁止フラグ
+     * @return      処理結果
+     */
+    NbResult<NbFileMetadata> UploadNewFile(const std::string &file_name, const char *data, size_t size,
+                                           const std::string &content_type, const NbAcl &acl,
+                                           bool cache_disable = false);
+
+    /**
+     * ファイルの新規アップロード(メモリ上のデータ、ACLなし).
+     * その他の仕様はACL指定のメモリ上のデータ版UploadNewFile()と同じである。
+     * @param[in]   file_name     アップロードするファイルの名前
+     * @param[in]   data          アップロードするデータ
+     * @param[in]   size          アップロードするデータのサイズ
+     * @param[in]   content_type  Content-Type
+     * @param[in]   cache_disable キャッシュ禁止フラグ
+     * @return      処理結果
+     */
+    NbResult<NbFileMetadata> UploadNewFile(const std::string &file_name, const char *data, size_t size,
+                                           const std::string &content_type, bool cache_disable = false);
+
     /**
      * ファイルの更新アップロード.
      * metadata内に設定されたfile_name等の情報を使用してファイルアップロードを行う。<br>
@@ -100,6 +213,36 @@ class NbFileBucket {
                                               const std::string &content_type, const std::string &meta_etag,
                                               const std::string &file_etag);
 
+    /**
+     * ファイルの更新アップロード(メモリ上のデータ).
+     * metadata内に設定されたfile_name等の情報を使用してファイルアップロードを行う。<br>
+     * その他の仕様はメモリ上のデータ版UploadUpdateFile()と同じである。
+     * @param[in]   data          アップロードするデータ
+     * @param[in]   size          アップロードするデータのサイズ
+     * @param[in]   metadata      メタデータ
+     * @return      処理結果
+     */
+    NbResult<NbFileMetadata> UploadUpdateFile(const char *data, size_t size, const NbFileMetadata &metadata);
+
+    /**
+     * ファイルの更新アップロード(メモリ上のデータ).
+     * ファイルを経由せずに、dataを複製せずに送信する。処理完了までdataを解放しないこと。<br>
+     * file_nameが空文字、dataがnullptrの場合、パラメータ不正のエラーを返す。
+     * (sizeが0の場合、dataはnullptrでもよい)<br>
+     * bucket_nameが空文字の場合、バケット名不正のエラーを返す。<br>
+     * content_type, meta_etag, file_etagを設定しない場合は、空文字を設定すること。
+     * @param[in]   file_name     アップロードするファイルの名前
+     * @param[in]   data          アップロードするデータ
+     * @param[in]   size          アップロードするデータのサイズ
+     * @param[in]   content_type  Content-Type
+     * @param[in]   meta_etag     メタデータのETag
+     * @param[in]   file_etag     ファイル本体のデータのETag
+     * @return      処理結果
+     */
+    NbResult<NbFileMetadata> UploadUpdateFile(const std::string &file_name, const char *data, size_t size,
+                                              const std::string &content_type, const std::string &meta_etag,
+                                              const std::string &file_etag);
+
     /**
      * ファイル削除.
      * 処理成功データ(メタデータ)は、delete_markにtrueを指定したときのみ有効である。<br>
@@ -134,6 +277,31 @@ class NbFileBucket {
       */
     NbResult<std::vector<NbFileMetadata>> GetFiles(bool published = false, bool deleteMark = false);
 
+    /**
+     * 複数ファイルの一括アップロード(新規).
+     * concurrency個のスレッドでジョブを分担し、サービスのREST Executorプールを使用して並行してアップロードする。
+     * 各ジョブの処理はUploadNewFile()と同じである。<br>
+     * concurrencyはHTTP同時接続数最大値とジョブ数を上限とし、1未満の場合は1とする。<br>
+     * 他のスレッドの使用によりREST Executorの空きが無い場合、各ジョブはRESTタイムアウトまで空きを待って再実行する。<br>
+     * 小さいファイルが多い場合は、NbService::SetConnectionReuseEnabled()で接続を再利用すると効果的である。
+     * @param[in]   jobs          アップロードジョブ
+     * @param[in]   concurrency   同時実行数
+     * @return      処理結果(ファイル毎の結果はジョブと同じ順序)
+     */
+    NbFileTransferResult<NbFileMetadata> UploadFiles(const std::vector<NbFileUploadJob> &jobs, int concurrency);
+
+    /**
+     * 複数ファイルの一括ダウンロード.
+     * concurrency個のスレッドでジョブを分担し、サービスのREST Executorプールを使用して並行してダウンロードする。
+     * 各ジョブの処理はDownloadLargeFile()と同じである。<br>
+     * concurrencyはHTTP同時接続数最大値とジョブ数を上限とし、1未満の場合は1とする。<br>
+     * 他のスレッドの使用によりREST Executorの空きが無い場合、各ジョブはRESTタイムアウトまで空きを待って再実行する。
+     * @param[in]   jobs          ダウンロードジョブ
+     * @param[in]   concurrency   同時実行数
+     * @return      処理結果(ファイル毎の結果はジョブと同じ順序)
+     */
+    NbFileTransferResult<int64_t> DownloadFiles(const std::vector<NbFileDownloadJob> &jobs, int concurrency);
+
     /**
      * RESTタイムアウト取得.
      * @return      タイムアウト(秒)
@@ -173,6 +341,79 @@ class NbFileBucket {
      */
     NbResult<NbFileMetadata> UploadNewFile(const std::string &file_name, const std::string &file_path,
                                            const std::string &content_type, const std::string &acl, bool cache_disable);
+
+    /**
+     * ファイルの新規アップロード(メモリ上のデータ、内部).
+     * ACLを設定しない場合は空文字を設定する。
+     * @param[in]   file_name     アップロードするファイルの名前
+     * @param[in]   data          アップロードするデータ
+     * @param[in]   size          アップロードするデータのサイズ
+     * @param[in]   content_type  Content-Type
+     * @param[in]   acl           ACL
+     * @param[in]   cache_disable キャッシュ禁止フラグ
+     * @return      処理結果
+     */
+    NbResult<NbFileMetadata> UploadNewFile(const std::string &file_name, const char *data, size_t size,
+                                           const std::string &content_type, const std::string &acl, bool cache_disable);
+
+    /**
+     * 新規アップロードのHTTPリクエスト作成.
+     * @param[in]   file_name       アップロードするファイルの名前
+     * @param[in]   content_type    Content-Type
+     * @param[in]   acl             ACL
+     * @param[in]   cache_disable   キャッシュ禁止フラグ
+     * @param[in]   request_factory HTTPリクエストファクトリ
+     * @return      HTTPリクエスト
+     */
+    NbHttpRequest CreateUploadNewRequest(const std::string &file_name, const std::string &content_type,
+                                         const std::string &acl, bool cache_disable,
+                                         NbHttpRequestFactory *request_factory) const;
+
+    /**
+     * 更新アップロードのHTTPリクエスト作成.
+     * @param[in]   file_name       アップロードするファイルの名前
+     * @param[in]   content_type    Content-Type
+     * @param[in]   meta_etag       メタデータのETag
+     * @param[in]   file_etag       ファイル本体のデータのETag
+     * @param[in]   request_factory HTTPリクエストファクトリ
+     * @return      HTTPリクエスト
+     */
+    NbHttpRequest CreateUploadUpdateRequest(const std::string &file_name, const std::string &content_type,
+                                            const std::string &meta_etag, const std::string &file_etag,
+                                            NbHttpRequestFactory *request_factory) const;
+
+    /**
+     * アップロード結果作成.
+     * 処理成功時はレスポンスボディからメタデータを作成する。
+     * @param[in]   rest_result     REST実行結果
+     * @return      処理結果
+     */
+    NbResult<NbFileMetadata> MakeUploadResult(const NbResult<NbHttpResponse> &rest_result) const;
+
+    /**
+     * ダウンロードのHTTPリクエスト作成.
+     * @param[in]   file_name       ダウンロードするファイルの名前
+     * @param[in]   request_factory HTTPリクエストファクトリ
+     * @return      HTTPリクエスト
+     */
+    NbHttpRequest CreateDownloadRequest(const std::string &file_name, NbHttpRequestFactory *request_factory) const;
+
+    /**
+     * ダウンロード前チェック.
+     * @param[in]   file_name     ダウンロードするファイルの名前
+     * @param[in]   has_output    出力先が指定されているか
+     * @return      チェック結果
+     */
+    NbResultCode CheckDownload(const std::string &file_name, bool has_output) const;
+
+    /**
+     * ダウンロードサイズ確認.
+     * 受信サイズがX-Content-Lengthヘッダの値と一致するか確認する。
+     * @param[in]   response      HTTPレスポンス
+     * @param[in]   size          受信サイズ
+     * @return      確認結果
+     */
+    bool ValidateDownloadSize(const NbHttpResponse &response, size_t size) const;
 };
 }  // namespace necbaas
 #endif  // NECBAAS_NBFILEBUCKET_H
@@ -64,7 +64,7 @@ class NbFileMetadata {
      * ファイルサイズ取得.
      * @return      ファイルサイズ
      */
-    int GetLength() const;
+    int64_t GetLength() const;
 
     /**
      * ファイル作成日時取得.
@@ -112,7 +112,7 @@ class NbFileMetadata {
     std::string file_name_;      /*!< ファイル名 */
     std::string content_type_;   /*!< Content-Type */
     NbAcl acl_;                  /*!< ACL */
-    int length_{0};              /*!< ファイルサイズ */
+    int64_t length_{0};          /*!< ファイルサイズ */
     std::string created_time_;   /*!< 作成日時 */
     std::string updated_time_;   /*!< 更新日時 */
     std::string meta_etag_;      /*!< メタデータのETag */
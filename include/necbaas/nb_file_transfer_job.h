@@ -0,0 +1,36 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBFILETRANSFERJOB_H
+#define NECBAAS_NBFILETRANSFERJOB_H
+
+#include <string>
+#include <memory>
+#include "necbaas/nb_acl.h"
+
+namespace necbaas {
+
+/**
+ * @struct NbFileUploadJob nb_file_transfer_job.h "necbaas/nb_file_transfer_job.h"
+ * 一括アップロードのジョブ(ファイルの新規アップロード).
+ */
+struct NbFileUploadJob {
+    std::string file_name;          /*!< アップロードするファイルの名前 */
+    std::string file_path;          /*!< アップロードするローカルファイルのパス */
+    std::string content_type;       /*!< Content-Type */
+    std::shared_ptr<NbAcl> acl;     /*!< ACL(nullptrの場合は設定しない) */
+    bool cache_disable{false};      /*!< キャッシュ禁止フラグ */
+};
+
+/**
+ * @struct NbFileDownloadJob nb_file_transfer_job.h "necbaas/nb_file_transfer_job.h"
+ * 一括ダウンロードのジョブ.
+ */
+struct NbFileDownloadJob {
+    std::string file_name;          /*!< ダウンロードするファイルの名前 */
+    std::string file_path;          /*!< ダウンロードしたファイルの保存先 */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBFILETRANSFERJOB_H
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBFILETRANSFERRESULT_H
+#define NECBAAS_NBFILETRANSFERRESULT_H
+
+#include <cstdint>
+#include <vector>
+#include "necbaas/nb_result.h"
+
+namespace necbaas {
+
+/**
+ * @struct NbFileTransferResult nb_file_transfer_result.h "necbaas/nb_file_transfer_result.h"
+ * 一括アップロード・ダウンロード結果.
+ * ファイル毎の処理結果と、全体の転送量・スループットを保持する。
+ */
+template <typename T>
+struct NbFileTransferResult {
+    std::vector<NbResult<T>> results;   /*!< ファイル毎の処理結果(ジョブと同じ順序) */
+    int success_count{0};               /*!< 成功したファイル数 */
+    int failure_count{0};               /*!< 失敗したファイル数 */
+    int64_t total_bytes{0};             /*!< 成功したファイルの合計サイズ(バイト) */
+    int64_t elapsed_time_ms{0};         /*!< 全体の所要時間(ミリ秒) */
+    int64_t bytes_per_second{0};        /*!< スループット(バイト/秒) */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBFILETRANSFERRESULT_H
@@ -0,0 +1,29 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBHEDGEPOLICY_H
+#define NECBAAS_NBHEDGEPOLICY_H
+
+namespace necbaas {
+
+/**
+ * @struct NbHedgePolicy nb_hedge_policy.h "necbaas/nb_hedge_policy.h"
+ * ヘッジリクエストポリシー.
+ * オブジェクトの取得・クエリのGETリクエストが待ち時間内に完了しない場合、別のREST Executorで同じリクエストを重複して送信する。
+ * 先に完了した応答を採用し、もう一方の転送は中断する。
+ * ただし接続失敗など、リトライ可能なエラーで完了した応答は採用せず、もう一方の転送の完了を待つ。<br>
+ * 待ち時間は、直近の成功した対象リクエストの所要時間のパーセンタイル値とする。
+ * 記録数がminimum_samplesに満たない間はdefault_delay_msを使用する。
+ */
+struct NbHedgePolicy {
+    bool enabled{false};        /*!< ヘッジリクエストを使用する */
+    int percentile{95};         /*!< 待ち時間とする所要時間のパーセンタイル(0～100) */
+    int default_delay_ms{100};  /*!< 記録数不足時の待ち時間(ミリ秒) */
+    int min_delay_ms{10};       /*!< 待ち時間の下限(ミリ秒) */
+    int window_size{100};       /*!< パーセンタイルの算出に使用する直近の所要時間の数 */
+    int minimum_samples{20};    /*!< パーセンタイルを使用する最小の記録数 */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBHEDGEPOLICY_H
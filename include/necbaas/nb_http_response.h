@@ -8,6 +8,10 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include "necbaas/nb_transfer_info.h"
 
 namespace necbaas {
 
@@ -20,6 +24,19 @@ namespace necbaas {
  */
 class NbHttpResponse {
    public:
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>HTTPヘッダ位置情報.</p>
+     * ヘッダ格納領域内のヘッダ名と値の位置を示す。
+     */
+    struct HeaderField {
+        size_t name_offset;     /*!< ヘッダ名の開始位置 */
+        size_t name_length;     /*!< ヘッダ名の長さ */
+        size_t value_offset;    /*!< 値の開始位置 */
+        size_t value_length;    /*!< 値の長さ */
+    };
+
     /**
      * <b>[内部処理用]</b>
      * @internal
@@ -34,14 +51,34 @@ class NbHttpResponse {
      * @param[in]   headers         HTTPヘッダリスト
      * @param[in]   body            HTTPボディ
      */
-    NbHttpResponse(int status_code, const std::string &reason_phrase,
-                   const std::multimap<std::string, std::string> &headers, const std::vector<char> &body);
+    NbHttpResponse(int status_code, std::string reason_phrase,
+                   std::multimap<std::string, std::string> headers, std::vector<char> body);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>コンストラクタ(受信データ).</p>
+     * 受信したヘッダを格納領域ごと引き継ぎ、ヘッダ毎の文字列は生成しない。
+     * @param[in]   status_code     status-code
+     * @param[in]   reason_phrase   reason-phrase
+     * @param[in]   header_buffer   ヘッダ格納領域
+     * @param[in]   header_fields   ヘッダ位置情報
+     * @param[in]   body            HTTPボディ
+     */
+    NbHttpResponse(int status_code, std::string reason_phrase, std::string header_buffer,
+                   std::vector<HeaderField> header_fields, std::vector<char> body);
 
     /**
      * デストラクタ.
      */
     ~NbHttpResponse();
 
+    // コピーとムーブを許可(デストラクタ定義により暗黙のムーブが抑止されるため明示する)
+    NbHttpResponse(NbHttpResponse const&) = default;
+    NbHttpResponse& operator =(NbHttpResponse const&) = default;
+    NbHttpResponse(NbHttpResponse&&) = default;
+    NbHttpResponse& operator =(NbHttpResponse&&) = default;
+
     /**
      * status-code取得.
      * @return      status-code
@@ -56,15 +93,101 @@ class NbHttpResponse {
 
     /**
      * HTTPヘッダリスト取得.
+     * 受信データから生成した場合は、初回呼び出し時にリストを生成する。
+     * リストの生成は排他するため、複数スレッドから同時に呼び出してもよい。
      * @return      HTTPヘッダリスト
      */
     const std::multimap<std::string, std::string> &GetHeaders() const;
 
+    /**
+     * HTTPヘッダ取得.
+     * ヘッダ名は大文字小文字を区別しない。同名のヘッダが複数ある場合は最初のヘッダの値を返す。
+     * @param[in]   name        ヘッダ名
+     * @param[out]  value       ヘッダの値
+     * @return      取得結果
+     * @retval      true        ヘッダあり
+     * @retval      false       ヘッダなし
+     */
+    bool GetHeader(const std::string &name, std::string *value) const;
+
     /**
      * HTTPボディ取得.
      * @return      HTTPボディ
      */
-    const std::vector<char> &GetBody() const;
+    const std::vector<char> &GetBody() const &;
+
+    /**
+     * HTTPボディ取得(右辺値).
+     * HTTPレスポンスが不要な場合(std::move()した場合や一時オブジェクト)は、ボディを複製せずに取り出す。
+     * @return      HTTPボディ
+     */
+    std::vector<char> GetBody() &&;
+
+    /**
+     * 接続再利用確認.
+     * @return      接続再利用
+     * @retval      true    既存の接続(TCP/TLS)を再利用して送受信した
+     * @retval      false   新規に接続した、または不明
+     */
+    bool IsConnectionReused() const;
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>接続再利用設定.</p>
+     * @param[in]   reused      接続再利用
+     */
+    void SetConnectionReused(bool reused);
+
+    /**
+     * 送信ボディサイズ取得.
+     * @return      送信したHTTPボディのバイト数(圧縮前)
+     */
+    int64_t GetRequestBodySize() const;
+
+    /**
+     * 送信ボディ転送サイズ取得.
+     * @return      送信したHTTPボディの転送バイト数(圧縮した場合は圧縮後)
+     */
+    int64_t GetRequestTransferSize() const;
+
+    /**
+     * 受信ボディサイズ取得.
+     * @return      受信したHTTPボディのバイト数(展開後)
+     */
+    int64_t GetResponseBodySize() const;
+
+    /**
+     * 受信ボディ転送サイズ取得.
+     * @return      受信したHTTPボディの転送バイト数(圧縮されている場合は展開前)
+     */
+    int64_t GetResponseTransferSize() const;
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>送受信サイズ設定.</p>
+     * @param[in]   request_body_size           送信ボディサイズ(圧縮前)
+     * @param[in]   request_transfer_size       送信ボディ転送サイズ
+     * @param[in]   response_body_size          受信ボディサイズ(展開後)
+     * @param[in]   response_transfer_size      受信ボディ転送サイズ
+     */
+    void SetTransferSize(int64_t request_body_size, int64_t request_transfer_size,
+                         int64_t response_body_size, int64_t response_transfer_size);
+
+    /**
+     * 転送情報取得.
+     * @return      転送の所要時間内訳と送受信バイト数
+     */
+    const NbTransferInfo &GetTransferInfo() const;
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>転送情報設定.</p>
+     * @param[in]   transfer_info   転送情報
+     */
+    void SetTransferInfo(const NbTransferInfo &transfer_info);
 
     /**
      * <b>[内部処理用]</b>
@@ -75,10 +198,36 @@ class NbHttpResponse {
     void Dump() const;
 
    private:
+    /**
+     * HTTPヘッダリスト(GetHeaders()初回呼び出し時に生成).
+     * コピー・ムーブ時は引き継がず、コピー先で再生成する(生成中のリストを参照しない)。
+     */
+    struct HeaderCache {
+        HeaderCache() = default;
+        HeaderCache(const HeaderCache &) {}
+        HeaderCache &operator =(const HeaderCache &) {
+            headers.clear();
+            created = false;
+            return *this;
+        }
+
+        std::mutex mutex;                                     /*!< 生成用Mutex */
+        std::atomic<bool> created{false};                     /*!< 生成済み */
+        std::multimap<std::string, std::string> headers;      /*!< HTTPヘッダリスト */
+    };
+
     int status_code_{0};                              /*!< status-code   */
     std::string reason_phrase_;                       /*!< reason-phrase */
-    std::multimap<std::string, std::string> headers_; /*!< header-field  */
+    std::string header_buffer_;                       /*!< header-field格納領域 */
+    std::vector<HeaderField> header_fields_;          /*!< header-field位置情報 */
+    mutable HeaderCache headers_;                     /*!< header-field(GetHeaders()初回呼び出し時に生成) */
     std::vector<char> body_;                          /*!< message-body  */
+    bool connection_reused_{false};                   /*!< 接続再利用    */
+    int64_t request_body_size_{0};                    /*!< 送信ボディサイズ(圧縮前) */
+    int64_t request_transfer_size_{0};                /*!< 送信ボディ転送サイズ */
+    int64_t response_body_size_{0};                   /*!< 受信ボディサイズ(展開後) */
+    int64_t response_transfer_size_{0};               /*!< 受信ボディ転送サイズ */
+    NbTransferInfo transfer_info_;                    /*!< 転送情報 */
 };
 }  // namespace necbaas
 
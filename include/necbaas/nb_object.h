@@ -7,9 +7,11 @@
 
 #include <string>
 #include <memory>
+#include <future>
 #include "necbaas/nb_service.h"
 #include "necbaas/nb_acl.h"
 #include "necbaas/nb_json_object.h"
+#include "necbaas/internal/nb_async_result.h"
 
 namespace necbaas {
 
@@ -25,6 +27,11 @@ namespace necbaas {
  */
 class NbObject : public NbJsonObject {
    public:
+    /**
+     * 非同期保存の完了コールバック.
+     */
+    typedef std::function<void(const NbResult<NbObject> &)> SaveCallback;
+
     /**
      * <b>[内部処理用]</b>
      * @internal
@@ -88,6 +95,19 @@ class NbObject : public NbJsonObject {
      */
     NbResult<NbObject> Save(bool acl = false);
 
+    /**
+     * オブジェクトを非同期に保存する.
+     * 保存を非同期に実行する。呼び出しスレッドはREST完了を待たずに復帰する。<br>
+     * 本メソッドは自インスタンスを更新しない。保存後のオブジェクトは処理結果から取得すること。<br>
+     * 処理結果はfutureとコールバックの両方に通知される(コールバック呼び出し後にfutureへ設定)。<br>
+     * コールバックはSDK内部のイベントループスレッドで呼び出されるため、長時間ブロックしないこと。<br>
+     * その他の仕様はSave()と同じである。
+     * @param[in]   acl         ACL更新フラグ
+     * @param[in]   callback    完了コールバック(nullptr：呼び出さない)
+     * @return      処理結果のfuture
+     */
+    std::future<NbResult<NbObject>> SaveAsync(bool acl = false, SaveCallback callback = nullptr) const;
+
     /**
      * RESTタイムアウト取得.
      * @return      タイムアウト(秒)
@@ -206,6 +226,23 @@ class NbObject : public NbJsonObject {
      * @param[in]   json      Jsonオブジェクト
      */
     static void RemoveReservationFields(NbJsonObject *json);
+
+    /**
+     * 保存用HTTPリクエスト作成.
+     * @param[in]       acl                 ACL更新フラグ
+     * @param[in,out]   request_factory     HTTPリクエストファクトリ
+     * @return  HTTPリクエスト
+     */
+    NbHttpRequest CreateSaveRequest(bool acl, NbHttpRequestFactory *request_factory) const;
+
+    /**
+     * 保存結果作成.
+     * REST実行結果をオブジェクトに反映し、処理結果を作成する。
+     * @param[in]       rest_result     REST実行結果
+     * @param[in,out]   object          反映先オブジェクト
+     * @return      処理結果
+     */
+    static NbResult<NbObject> MakeSaveResult(const NbResult<NbHttpResponse> &rest_result, NbObject *object);
 };
 }  // namespace necbaas
 #endif  // NECBAAS_NBOBJECT_H
@@ -9,10 +9,12 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <future>
 #include "necbaas/nb_service.h"
 #include "necbaas/nb_result.h"
 #include "necbaas/nb_object.h"
 #include "necbaas/nb_query.h"
+#include "necbaas/internal/nb_async_result.h"
 
 namespace necbaas {
 
@@ -24,6 +26,11 @@ namespace necbaas {
  */
 class NbObjectBucket {
    public:
+    /**
+     * 非同期クエリの完了コールバック.
+     */
+    typedef NbAsyncResult<std::vector<NbObject>>::Callback QueryCallback;
+
     /**
      * コンストラクタ.
      * @param[in]   service        サービスインスタンス
@@ -58,6 +65,21 @@ class NbObjectBucket {
      */
     NbResult<std::vector<NbObject>> Query(const NbQuery &query, int *count = nullptr);
 
+    /**
+     * オブジェクトの非同期クエリ.
+     * クエリを非同期に実行する。呼び出しスレッドはREST完了を待たずに復帰する。<br>
+     * 処理結果はfutureとコールバックの両方に通知される(コールバック呼び出し後にfutureへ設定)。<br>
+     * コールバックはSDK内部のイベントループスレッドで呼び出されるため、長時間ブロックしないこと。<br>
+     * countを指定する場合は、処理完了まで有効な領域を指定すること。countは処理結果通知前に設定される。<br>
+     * その他の仕様はQuery()と同じである。
+     * @param[in]   query       検索条件
+     * @param[out]  count       件数取得
+     * @param[in]   callback    完了コールバック(nullptr：呼び出さない)
+     * @return      処理結果のfuture
+     */
+    std::future<NbResult<std::vector<NbObject>>> QueryAsync(const NbQuery &query, int *count = nullptr,
+                                                            QueryCallback callback = nullptr);
+
     /**
      * RESTタイムアウト取得.
      * @return      タイムアウト(秒)
@@ -97,6 +119,20 @@ class NbObjectBucket {
      * @return      リクエストパラメータ
      */
     std::multimap<std::string, std::string> GetParams(const NbQuery &query, int *count) const;
+
+    /**
+     * クエリ結果作成.
+     * REST実行結果からクエリ結果を作成する。
+     * @param[in]   service         サービスインスタンス
+     * @param[in]   bucket_name     バケット名
+     * @param[in]   rest_result     REST実行結果
+     * @param[out]  count           件数取得
+     * @return      処理結果
+     */
+    static NbResult<std::vector<NbObject>> MakeQueryResult(const std::shared_ptr<NbService> &service,
+                                                           const std::string &bucket_name,
+                                                           const NbResult<NbHttpResponse> &rest_result,
+                                                           int *count);
 };
 }  // namespace necbaas
 #endif  // NECBAAS_NBOBJECTBUCKET_H
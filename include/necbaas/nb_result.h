@@ -6,8 +6,10 @@
 #define NECBAAS_NBRESULT_H
 
 #include <string>
+#include <utility>
 #include "necbaas/nb_rest_error.h"
 #include "necbaas/nb_result_code.h"
+#include "necbaas/nb_transfer_info.h"
 
 namespace necbaas {
 
@@ -39,6 +41,12 @@ class NbResult {
      */
     ~NbResult() {};
 
+    // コピーとムーブを許可(デストラクタ定義により暗黙のムーブが抑止されるため明示する)
+    NbResult(NbResult const&) = default;
+    NbResult& operator =(NbResult const&) = default;
+    NbResult(NbResult&&) = default;
+    NbResult& operator =(NbResult&&) = default;
+
     /**
      * 処理結果成功判定.
      * @return  判定結果
@@ -91,10 +99,19 @@ class NbResult {
      * 処理成功データ取得.
      * @return  処理成功データ
      */
-    const T &GetSuccessData() const {
+    const T &GetSuccessData() const & {
         return success_data_;
     };
 
+    /**
+     * 処理成功データ取得(右辺値).
+     * 処理結果が不要な場合(std::move()した場合や一時オブジェクト)は、処理成功データを複製せずに取り出す。
+     * @return  処理成功データ
+     */
+    T GetSuccessData() && {
+        return std::move(success_data_);
+    };
+
     /**
      * <b>[内部処理用]</b>
      * @internal
@@ -105,6 +122,16 @@ class NbResult {
         success_data_ = success_data;
     };
 
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>処理成功データ設定(ムーブ).</p>
+     * @param[in]   success_data     処理成功データ
+     */
+    void SetSuccessData(T &&success_data) {
+        success_data_ = std::move(success_data);
+    };
+
     /**
      * RESTエラーデータ取得.
      * @return  RESTエラーデータ
@@ -123,10 +150,63 @@ class NbResult {
         rest_error_ = rest_error;
     };
 
+    /**
+     * リトライ回数取得.
+     * @return  リトライポリシーによりREST APIをリトライした回数
+     */
+    int GetRetryCount() const {
+        return retry_count_;
+    };
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>リトライ回数設定.</p>
+     * @param[in]   retry_count     リトライ回数
+     */
+    void SetRetryCount(int retry_count) {
+        retry_count_ = retry_count;
+    };
+
+    /**
+     * 転送情報取得.
+     * エラー発生時も、転送を開始していれば中断までの情報を返す。
+     * リトライした場合は最後の転送の情報となる。
+     * @return  転送情報(REST未実行の場合は全て0)
+     */
+    const NbTransferInfo &GetTransferInfo() const {
+        return transfer_info_;
+    };
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>転送情報設定.</p>
+     * @param[in]   transfer_info   転送情報
+     */
+    void SetTransferInfo(const NbTransferInfo &transfer_info) {
+        transfer_info_ = transfer_info;
+    };
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>REST実行情報の引き継ぎ.</p>
+     * REST実行結果から、リトライ回数と転送情報を設定する。
+     * @param[in]   rest_result     REST実行結果
+     */
+    template <typename U>
+    void SetRestInfo(const NbResult<U> &rest_result) {
+        retry_count_ = rest_result.GetRetryCount();
+        transfer_info_ = rest_result.GetTransferInfo();
+    };
+
    private:
     NbResultCode result_code_{NbResultCode::NB_FATAL}; /*!< 処理結果コード */
     T success_data_;                                   /*!< 処理成功データ */
     NbRestError rest_error_;                           /*!< RESTエラーデータ */
+    int retry_count_{0};                               /*!< リトライ回数 */
+    NbTransferInfo transfer_info_;                     /*!< 転送情報 */
 };
 }  // namespace necbaas
 #endif  // NECBAAS_NBRESULT_H
@@ -32,6 +32,9 @@ enum class NbResultCode {
     NB_ERROR_CURL_LOGIC,         /*!< CURL Loginエラー               */
     NB_ERROR_CURL_FATAL,         /*!< CURL その他エラー              */
     NB_FATAL,                    /*!< 処理異常検出                   */
+    // 既存の値を変えないため、以降のコードは末尾に追加する
+    NB_ERROR_CANCELED,           /*!< 処理キャンセル                 */
+    NB_ERROR_CIRCUIT_OPEN,       /*!< サーキットブレーカー遮断中     */
 };
 }  // namespace necbaas
 #endif  // NECBAAS_NBRESULTCODE_H
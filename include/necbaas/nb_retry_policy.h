@@ -0,0 +1,26 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBRETRYPOLICY_H
+#define NECBAAS_NBRETRYPOLICY_H
+
+namespace necbaas {
+
+/**
+ * @struct NbRetryPolicy nb_retry_policy.h "necbaas/nb_retry_policy.h"
+ * REST APIリトライポリシー.
+ * 通信エラー(NB_ERROR_CURL_RUNTIME)、およびステータスコード502/503/504の応答をリトライ対象とする。<br>
+ * リトライ間隔は指数バックオフとし、揺らぎ(ジッタ)として間隔の後半50%の範囲でランダムに決定する。
+ */
+struct NbRetryPolicy {
+    int max_attempts{1};            /*!< 最大試行回数(初回を含む。1以下の場合はリトライしない) */
+    int initial_backoff_ms{100};    /*!< 初回リトライ間隔の上限(ミリ秒) */
+    int max_backoff_ms{5000};       /*!< リトライ間隔の上限(ミリ秒) */
+    double backoff_multiplier{2.0}; /*!< リトライ毎のリトライ間隔の倍率 */
+    int deadline_ms{0};             /*!< 全体期限(ミリ秒)。次のリトライ開始が期限を超える場合はリトライしない(0以下の場合は期限なし) */
+    bool retry_post{false};         /*!< POSTをリトライする(非冪等のため、デフォルトはGET/PUT/DELETEのみリトライする) */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBRETRYPOLICY_H
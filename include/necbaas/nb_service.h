@@ -7,9 +7,27 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <map>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include "necbaas/nb_circuit_breaker_policy.h"
+#include "necbaas/nb_retry_policy.h"
+#include "necbaas/nb_hedge_policy.h"
+#include "necbaas/nb_statistics.h"
+#include "necbaas/nb_warm_up_result.h"
 #include "necbaas/internal/nb_session_token.h"
 #include "necbaas/internal/nb_rest_executor.h"
 #include "necbaas/internal/nb_rest_executor_pool.h"
+#include "necbaas/internal/nb_rest_async_engine.h"
+#include "necbaas/internal/nb_curl_share.h"
+#include "necbaas/internal/nb_circuit_breaker.h"
+#include "necbaas/internal/nb_latency_window.h"
+#include "necbaas/internal/nb_metrics_registry.h"
+#include "necbaas/internal/nb_token_bucket.h"
 #include "necbaas/internal/nb_http_request_factory.h"
 
 namespace necbaas {
@@ -38,6 +56,24 @@ class NbService {
                                                     const std::string &app_id, const std::string &app_key,
                                                     const std::string &proxy = "");
 
+    /**
+     * サービスインスタンス生成(事前接続あり).
+     * サービスインスタンス生成後、WarmUp()またはWarmUpAsync()で事前接続を行う。
+     * その他の仕様は事前接続なしのCreateService()と同じである。
+     * @param[in]   endpoint_url        Endpoint URI
+     * @param[in]   tenant_id           テナントID
+     * @param[in]   app_id              アプリケーションID
+     * @param[in]   app_key             アプリケーションキー
+     * @param[in]   proxy               Proxy URL(空文字の場合はProxy無効)
+     * @param[in]   warm_up_num         事前接続するREST Executor数
+     * @param[in]   warm_up_background  true:バックグラウンドで事前接続する／false:事前接続完了後に復帰する
+     * @return      サービスインスタンス
+     */
+    static std::shared_ptr<NbService> CreateService(const std::string &endpoint_url, const std::string &tenant_id,
+                                                    const std::string &app_id, const std::string &app_key,
+                                                    const std::string &proxy, int warm_up_num,
+                                                    bool warm_up_background);
+
     /**
      * ロギング設定（デバッグログ）.
      * プロセス内の全サービスに対して設定される。<br>
@@ -97,6 +133,282 @@ class NbService {
      */
     const std::string &GetProxy() const;
 
+    /**
+     * HTTP接続空き待ちタイムアウト取得.
+     * @return  空き待ちタイムアウト(ミリ秒)
+     */
+    int GetConnectionWaitTimeout() const;
+
+    /**
+     * HTTP接続空き待ちタイムアウト設定.
+     * HTTP同時接続数が上限に達している場合に、接続の空きを待ち合わせる時間(ミリ秒)を設定する。<br>
+     * 待ち合わせは到着順に処理され、タイムアウトした場合は NB_ERROR_CONNECTION_OVER を返す。<br>
+     * 0以下の値が設定された場合は待ち合わせせず、即座に NB_ERROR_CONNECTION_OVER を返す(デフォルト)。
+     * @param[in]   timeout     空き待ちタイムアウト(ミリ秒)
+     */
+    void SetConnectionWaitTimeout(int timeout);
+
+    /**
+     * HTTP接続プール統計情報取得.
+     * 接続の払い出し回数、空き待ち回数、空き待ち時間などを取得する。
+     * @return  統計情報
+     */
+    NbRestExecutorPoolStatistics GetConnectionPoolStatistics();
+
+    /**
+     * 接続再利用モード確認.
+     * @return  true:有効／false:無効
+     */
+    bool IsConnectionReuseEnabled() const;
+
+    /**
+     * 接続再利用モード設定.
+     * 有効にした場合、プール内のREST Executorはリクエスト毎のCURLオプション再構築を行わず、
+     * TCP keep-aliveにより接続(TCP/TLS)を維持する。<br>
+     * 接続を再利用したかどうかは、NbHttpResponse::IsConnectionReused() で確認できる。<br>
+     * default設定: 無効
+     * @param[in]   flag    true:有効／false:無効
+     */
+    void SetConnectionReuseEnabled(bool flag);
+
+    /**
+     * HTTP/2モード確認.
+     * @return  true:有効／false:無効
+     */
+    bool IsHttp2Enabled() const;
+
+    /**
+     * HTTP/2モード設定.
+     * 有効にした場合、TLS接続時にALPNでHTTP/2をネゴシエーションし、
+     * REST API(ファイル転送を除く)は非同期実行エンジンの少数の接続上に多重化して実行する。<br>
+     * サーバがHTTP/2に対応していない場合はHTTP/1.1で通信する。<br>
+     * default設定: 無効
+     * @param[in]   flag    true:有効／false:無効
+     */
+    void SetHttp2Enabled(bool flag);
+
+    /**
+     * 応答圧縮確認.
+     * @return  true:有効／false:無効
+     */
+    bool IsResponseCompressionEnabled() const;
+
+    /**
+     * 応答圧縮設定.
+     * 有効にした場合、JSONを応答するREST APIでAccept-Encodingヘッダを送信し、
+     * サーバが圧縮した応答は自動で展開する。ファイル転送・カスタムAPIのストリーム受信では送信しない。<br>
+     * 圧縮前後の受信サイズは NbHttpResponse::GetResponseBodySize()、GetResponseTransferSize() で確認できる。<br>
+     * default設定: 有効
+     * @param[in]   flag    true:有効／false:無効
+     */
+    void SetResponseCompressionEnabled(bool flag);
+
+    /**
+     * リクエスト圧縮閾値取得.
+     * @return  リクエスト圧縮閾値(バイト)
+     */
+    int GetRequestCompressionThreshold() const;
+
+    /**
+     * リクエスト圧縮閾値設定.
+     * オブジェクトの保存(NbObject::Save())・部分更新(NbObject::PartUpdateObject())のボディが閾値以上の場合、
+     * gzip圧縮して送信する。その他のAPIは圧縮しない。
+     * サーバが圧縮されたリクエスト(Content-Encoding: gzip)を受け付ける場合のみ設定すること。<br>
+     * 0以下の値が設定された場合は圧縮しない(デフォルト)。
+     * @param[in]   threshold   リクエスト圧縮閾値(バイト)
+     */
+    void SetRequestCompressionThreshold(int threshold);
+
+    /**
+     * ファイルダウンロード書込みバッファサイズ取得.
+     * @return  書込みバッファサイズ(バイト)
+     */
+    int GetFileDownloadBufferSize() const;
+
+    /**
+     * ファイルダウンロード書込みバッファサイズ設定.
+     * ファイルダウンロードでは受信データを書込みバッファに蓄積し、まとめてファイルに書込む。<br>
+     * 0以下の値が設定された場合はバッファリングしない。<br>
+     * default設定: 1MB
+     * @param[in]   size        書込みバッファサイズ(バイト)
+     */
+    void SetFileDownloadBufferSize(int size);
+
+    /**
+     * ファイルダウンロード同期書込み確認.
+     * @return  true:有効／false:無効
+     */
+    bool IsFileDownloadSyncEnabled() const;
+
+    /**
+     * ファイルダウンロード同期書込み設定.
+     * 有効にした場合、ファイルダウンロードの完了時にファイルの内容をストレージに同期(fsync)する。
+     * 電源断などでもダウンロード済みのファイルを失わないが、完了までの時間が長くなる。<br>
+     * default設定: 無効
+     * @param[in]   flag    true:有効／false:無効
+     */
+    void SetFileDownloadSyncEnabled(bool flag);
+
+    /**
+     * 送信帯域制限取得.
+     * @return  送信帯域制限(バイト/秒。0の場合は制限なし)
+     */
+    int64_t GetUploadBandwidthLimit() const;
+
+    /**
+     * 送信帯域制限設定.
+     * サービス内の全てのREST APIの送信データ量(HTTPボディ)を、合計で1秒あたりの指定バイト数以下に制限する。<br>
+     * 実行中の転送にも即時に反映される。帯域制限による待機時間もタイムアウトに含まれるため、
+     * 大きなファイルを転送する場合はタイムアウトを長く設定すること。<br>
+     * バックグラウンド同期など優先度の低い通信は、別のサービスで低い制限を設定して実行することで、
+     * 通常の通信の帯域を確保できる。<br>
+     * 0以下の値が設定された場合は制限しない(デフォルト)。
+     * @param[in]   bytes_per_second    送信帯域制限(バイト/秒)
+     */
+    void SetUploadBandwidthLimit(int64_t bytes_per_second);
+
+    /**
+     * 受信帯域制限取得.
+     * @return  受信帯域制限(バイト/秒。0の場合は制限なし)
+     */
+    int64_t GetDownloadBandwidthLimit() const;
+
+    /**
+     * 受信帯域制限設定.
+     * サービス内の全てのREST APIの受信データ量(HTTPボディ、展開後)を、合計で1秒あたりの指定バイト数以下に制限する。<br>
+     * 実行中の転送にも即時に反映される。帯域制限による待機時間もタイムアウトに含まれる。<br>
+     * 0以下の値が設定された場合は制限しない(デフォルト)。
+     * @param[in]   bytes_per_second    受信帯域制限(バイト/秒)
+     */
+    void SetDownloadBandwidthLimit(int64_t bytes_per_second);
+
+    /**
+     * リクエストレート制限取得.
+     * @return  リクエストレート制限(リクエスト/秒。0の場合は制限なし)
+     */
+    int GetRequestRateLimit() const;
+
+    /**
+     * リクエストレート制限設定.
+     * サービス内のREST APIの送信回数(リトライを含む)を、1秒あたりの指定回数以下に制限する。
+     * 制限を超える場合は、送信可能になるまで呼び出し元スレッドで待機する。<br>
+     * 0以下の値が設定された場合は制限しない(デフォルト)。
+     * @param[in]   requests_per_second リクエストレート制限(リクエスト/秒)
+     */
+    void SetRequestRateLimit(int requests_per_second);
+
+    /**
+     * プロセス共通キャッシュ共有確認.
+     * @return  true:有効／false:無効
+     */
+    bool IsProcessCacheShareEnabled() const;
+
+    /**
+     * プロセス共通キャッシュ共有設定.
+     * サービス内のREST Executorは、DNSキャッシュ、TLSセッションを常に共有する。<br>
+     * 有効にした場合、有効にした全サービス間で同じキャッシュを共有する。
+     * 無効にした場合は、サービス専用のキャッシュを新たに使用する。<br>
+     * default設定: 無効
+     * @param[in]   flag    true:有効／false:無効
+     */
+    void SetProcessCacheShareEnabled(bool flag);
+
+    /**
+     * リトライポリシー取得.
+     * @return  リトライポリシー
+     */
+    NbRetryPolicy GetRetryPolicy();
+
+    /**
+     * リトライポリシー設定.
+     * 同期実行のREST API(ファイル転送を含む)で、一時的な失敗(通信エラー、502/503/504応答)をリトライする。<br>
+     * 非冪等なPOSTは NbRetryPolicy::retry_post を有効にした場合のみリトライする。
+     * 非同期実行のREST APIはリトライしない。<br>
+     * リトライ回数は NbResult::GetRetryCount() で確認できる。<br>
+     * default設定: リトライしない
+     * @param[in]   policy  リトライポリシー
+     */
+    void SetRetryPolicy(const NbRetryPolicy &policy);
+
+    /**
+     * サーキットブレーカーポリシー取得.
+     * @return  サーキットブレーカーポリシー
+     */
+    NbCircuitBreakerPolicy GetCircuitBreakerPolicy();
+
+    /**
+     * サーキットブレーカーポリシー設定.
+     * 有効にした場合、Endpoint URIへのREST API(同期実行)の失敗率・所要時間を監視し、
+     * 閾値を超えた場合はREST APIを実行せずに NB_ERROR_CIRCUIT_OPEN を返す。
+     * 遮断中はREST Executorを払い出さないため、応答しないサーバによって接続が枯渇することを防ぐ。<br>
+     * 設定時に状態は通常(CLOSED)に戻る。<br>
+     * default設定: 無効
+     * @param[in]   policy  サーキットブレーカーポリシー
+     */
+    void SetCircuitBreakerPolicy(const NbCircuitBreakerPolicy &policy);
+
+    /**
+     * サーキットブレーカー状態取得.
+     * @return  サーキットブレーカー状態(無効の場合は常にCLOSED)
+     */
+    NbCircuitBreakerState GetCircuitBreakerState();
+
+    /**
+     * ヘッジリクエストポリシー取得.
+     * @return  ヘッジリクエストポリシー
+     */
+    NbHedgePolicy GetHedgePolicy();
+
+    /**
+     * ヘッジリクエストポリシー設定.
+     * 有効にした場合、同期実行のオブジェクトの取得(NbObjectBucket::GetObject())・クエリ(NbObjectBucket::Query())が
+     * 待ち時間内に完了しなければ、別のREST Executorで同じリクエストを送信し、先に完了した応答を採用する(リトライ可能なエラーは除く)。
+     * サーバ応答のテールレイテンシ(p99等)を改善する。<br>
+     * 最初の転送は呼び出し元スレッドで行い、重複送信した転送のみバックグラウンドスレッドで行う。
+     * 採用されなかった転送は中断してREST Executorを返却する。
+     * 空きREST Executorが無い場合は重複送信しない。<br>
+     * HTTP/2モードのリクエスト、およびその他のAPI(ファイル転送・ファイル一覧取得等)は対象外。
+     * 設定時に記録した所要時間は破棄する。<br>
+     * default設定: 無効
+     * @param[in]   policy  ヘッジリクエストポリシー
+     */
+    void SetHedgePolicy(const NbHedgePolicy &policy);
+
+    /**
+     * 統計情報取得.
+     * サービス生成(またはResetStatistics())以降のREST APIについて、操作種別毎のリクエスト数、
+     * 処理結果コード別件数、送受信バイト数、所要時間ヒストグラムを返す。
+     * REST Executorプールの統計情報(HTTP接続空き待ち時間等)も含む。<br>
+     * 記録はロックを取得せずに行うため、REST API実行中に取得した場合は一部の値にのみ反映されている場合がある。
+     * @return  統計情報
+     */
+    NbStatistics GetStatistics();
+
+    /**
+     * 統計情報のクリア.
+     * REST Executorプールの統計情報はクリアしない。
+     */
+    void ResetStatistics();
+
+    /**
+     * 事前接続.
+     * 指定数のREST Executorを生成し、Endpoint URIへの接続(DNS解決・TCP・TLS)を並行して確立する。
+     * 確立した接続は以降のREST APIで再利用されるため、初回リクエストの接続コストを削減できる。<br>
+     * 払い出し可能なREST Executor数(HTTP同時接続数最大値から使用中の数を除いたもの)を超える分は接続しない。
+     * @param[in]   connection_num  事前接続するREST Executor数
+     * @return      事前接続結果
+     */
+    NbWarmUpResult WarmUp(int connection_num);
+
+    /**
+     * 事前接続(バックグラウンド).
+     * WarmUp()をバックグラウンドスレッドで実行する。前回の事前接続が実行中の場合は完了を待ってから開始する。<br>
+     * サービスインスタンスを破棄する場合は、事前接続の完了を待ち合わせる。
+     * @param[in]   connection_num  事前接続するREST Executor数
+     * @param[in]   callback        完了コールバック(バックグラウンドスレッドで呼び出される。nullptrの場合は呼び出さない)
+     */
+    void WarmUpAsync(int connection_num, std::function<void(const NbWarmUpResult &)> callback = nullptr);
+
     /**
      * <b>[内部処理用]</b>
      * @internal
@@ -126,9 +438,43 @@ class NbService {
      * <p>REST実行(データの送受信).</p>
      * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
      * @param[in]   timeout         タイムアウト値(秒)
+     * @param[in]   operation       統計情報の操作種別
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request, int timeout,
+                                            NbOperation operation = NbOperation::OTHER);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>REST実行(ボディのストリーミング受信).</p>
+     * 受信したボディは保持せずに受信の都度sinkに渡す。受信済みのデータは取り消せないため、リトライ・重複送信は行わない。
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[in]   sink            受信データ出力先
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @param[in]   operation       統計情報の操作種別
      * @return      処理結果
      */
-    NbResult<NbHttpResponse> ExecuteRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request, int timeout);
+    NbResult<NbHttpResponse> ExecuteStreamRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                  std::function<bool(const char *, size_t)> sink, int timeout,
+                                                  NbOperation operation = NbOperation::OTHER);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>REST実行(ボディのストリーミング送信).</p>
+     * 送信ボディは保持せずに送信の都度producerから取得する。送信済みのデータは再生成できないため、リトライ・重複送信は行わない。
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[in]   producer        送信データ生成関数
+     * @param[in]   content_length  送信ボディサイズ(不明の場合は負の値)
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @param[in]   operation       統計情報の操作種別
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteStreamUpload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                 std::function<int64_t(char *, size_t)> producer,
+                                                 int64_t content_length, int timeout,
+                                                 NbOperation operation = NbOperation::OTHER);
 
     /**
      * <b>[内部処理用]</b>
@@ -142,6 +488,106 @@ class NbService {
     NbResult<NbHttpResponse> ExecuteFileDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
                                                  const std::string &file_path, int timeout);
 
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>ファイルダウンロード再開実行.</p>
+     * file_pathの既存のファイルの続きから受信する。リトライ時も受信済みのデータの続きから受信する。
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[in]   file_path       ファイルパス
+     * @param[in]   etag            ファイルのETag
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteFileResumeDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                       const std::string &file_path, const std::string &etag,
+                                                       int timeout);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>ファイルダウンロード実行(呼び出し元バッファへの受信).</p>
+     * 受信データをbufferに直接書き込む。リトライ時はbufferの先頭から書き直す。<br>
+     * 受信データがcapacityを超えた場合は受信を中断し、NB_ERROR_FILE_DOWNLOADを返す。
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[out]  buffer          受信バッファ
+     * @param[in]   capacity        受信バッファサイズ
+     * @param[out]  size            受信サイズ
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteBufferDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                   char *buffer, size_t capacity, size_t *size, int timeout);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>ファイルの範囲ダウンロード実行.</p>
+     * create_requestでRangeヘッダを指定したリクエストを実行し、受信データをfdのoffsetの位置から書き込む。
+     * 複数スレッドから同一のfdに対して並行して実行できる。リトライ時はoffsetの位置から書き直す。<br>
+     * 受信サイズがlengthと一致しない場合は、NB_ERROR_FILE_DOWNLOADを返す。<br>
+     * 範囲はファイルの位置と一致させるため、応答圧縮(Accept-Encoding)は使用しない。<br>
+     * REST Executorはプールから払い出さず、ReserveRestExecutors()で予約したものを使用する。
+     * 統計情報は記録しない(呼び出し元でダウンロード全体を1回分として記録する)。
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[in]   executor        予約済みREST Executor
+     * @param[in]   fd              出力先ファイルディスクリプタ
+     * @param[in]   offset          書込み位置(範囲の先頭)
+     * @param[in]   length          範囲のサイズ
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteRangeDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                  NbRestExecutor *executor, int fd, int64_t offset, int64_t length,
+                                                  int timeout);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>REST Executor予約.</p>
+     * 並行転送用に、最大max_count個のREST Executorをまとめて払い出す。
+     * 1つ目はHTTP接続空き待ちタイムアウトまで待ち、2つ目以降は空きがある分のみ払い出す。<br>
+     * 予約したREST ExecutorはReleaseRestExecutors()で返却すること。
+     * @param[in]   max_count       予約数の上限
+     * @return      予約したREST Executor(空きが無い場合は空)
+     */
+    std::vector<NbRestExecutor *> ReserveRestExecutors(int max_count);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>REST Executor予約解除.</p>
+     * @param[in]   executors       ReserveRestExecutors()で予約したREST Executor
+     */
+    void ReleaseRestExecutors(const std::vector<NbRestExecutor *> &executors);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>統計情報の記録.</p>
+     * 複数のリクエストで構成される操作(並行ダウンロード等)は、呼び出し元で1回分として記録する。
+     * @param[in]   operation   操作種別
+     * @param[in]   result      処理結果
+     * @param[in]   start       開始時刻
+     */
+    void RecordStatistics(NbOperation operation, const NbResult<NbHttpResponse> &result,
+                          std::chrono::steady_clock::time_point start);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>ファイルアップロード実行(メモリ上のデータ).</p>
+     * dataを複製せずに送信する。リトライ時はdataの先頭から送信し直す。<br>
+     * 送信完了までdataを解放しないこと。
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[in]   data            送信データ
+     * @param[in]   size            送信データサイズ
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecuteBufferUpload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                 const char *data, size_t size, int timeout);
+
     /**
      * <b>[内部処理用]</b>
      * @internal
@@ -153,6 +599,21 @@ class NbService {
      */
     NbResult<NbHttpResponse> ExecuteFileUpload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
                                                const std::string &file_path, int timeout);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>REST非同期実行(データの送受信).</p>
+     * リクエストは呼び出しスレッドで作成し、転送は非同期実行エンジンのイベントループで行う。<br>
+     * リクエスト作成でエラーが発生した場合は、呼び出しスレッドでコールバックを呼び出す。<br>
+     * それ以外の場合、コールバックはイベントループスレッドで呼び出される。
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @param[in]   callback        完了コールバック
+     * @param[in]   operation       統計情報の操作種別
+     */
+    void ExecuteRequestAsync(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request, int timeout,
+                             NbRestAsyncEngine::Callback callback, NbOperation operation = NbOperation::OTHER);
    private:
     std::string app_id_;                    /*!< アプリケーションID */
     std::string app_key_;                   /*!< アプリケーションキー */
@@ -162,6 +623,159 @@ class NbService {
     NbSessionToken session_token_;          /*!< セッショントークン */
     NbRestExecutorPool rest_executor_pool_; /*!< REST Executorプール */
     std::mutex session_token_mutex_;        /*!< セッショントークン更新用Mutex */
+    std::atomic<int> connection_wait_timeout_{kConnectionWaitTimeoutDefault}; /*!< HTTP接続空き待ちタイムアウト(ミリ秒) */
+    std::atomic<bool> connection_reuse_enabled_{false}; /*!< 接続再利用モード */
+    std::atomic<bool> http2_enabled_{false};    /*!< HTTP/2モード */
+    std::atomic<bool> process_cache_share_enabled_{false}; /*!< プロセス共通キャッシュ共有 */
+    std::atomic<bool> response_compression_enabled_{true}; /*!< 応答圧縮 */
+    std::atomic<int> request_compression_threshold_{0}; /*!< リクエスト圧縮閾値(バイト) */
+    std::atomic<int> file_download_buffer_size_{kDownloadBufferSize}; /*!< ファイルダウンロード書込みバッファサイズ(バイト) */
+    std::atomic<bool> file_download_sync_enabled_{false}; /*!< ファイルダウンロード同期書込み */
+    std::shared_ptr<NbTokenBucket> upload_limiter_{std::make_shared<NbTokenBucket>()};   /*!< 送信帯域制限 */
+    std::shared_ptr<NbTokenBucket> download_limiter_{std::make_shared<NbTokenBucket>()}; /*!< 受信帯域制限 */
+    NbTokenBucket request_limiter_;         /*!< リクエストレート制限 */
+    NbRetryPolicy retry_policy_;            /*!< リトライポリシー */
+    std::mutex retry_policy_mutex_;         /*!< リトライポリシー用Mutex */
+    NbCircuitBreaker circuit_breaker_;      /*!< サーキットブレーカー */
+    NbMetricsRegistry metrics_;             /*!< 統計情報 */
+    NbHedgePolicy hedge_policy_;            /*!< ヘッジリクエストポリシー */
+    std::mutex hedge_policy_mutex_;         /*!< ヘッジリクエストポリシー用Mutex */
+    NbLatencyWindow hedge_latency_{NbHedgePolicy().window_size}; /*!< ヘッジリクエスト対象の所要時間 */
+    int hedge_worker_num_{0};               /*!< 実行中のヘッジリクエスト転送スレッド数 */
+    std::mutex hedge_worker_mutex_;         /*!< ヘッジリクエスト転送スレッド数用Mutex */
+    std::condition_variable hedge_worker_cond_; /*!< ヘッジリクエスト転送スレッド終了通知 */
+    struct HedgeState;
+    std::multimap<std::chrono::steady_clock::time_point, std::weak_ptr<HedgeState>> hedge_timers_;
+                                            /*!< 重複送信の予定時刻(呼び出し元の完了後は期限切れとなる) */
+    std::thread hedge_timer_thread_;        /*!< 重複送信タイマースレッド(初回のヘッジリクエスト時に開始する) */
+    bool hedge_timer_stop_{false};          /*!< 重複送信タイマースレッド停止要求 */
+    std::mutex hedge_timer_mutex_;          /*!< 重複送信タイマー用Mutex */
+    std::condition_variable hedge_timer_cond_;  /*!< 重複送信タイマー更新通知 */
+    std::shared_ptr<NbCurlShare> curl_share_;   /*!< REST Executor間の共有キャッシュ(atomic_load/storeでアクセスする) */
+    std::unique_ptr<NbRestAsyncEngine> async_engine_; /*!< REST非同期実行エンジン */
+    std::mutex async_engine_mutex_;         /*!< 非同期実行エンジン生成用Mutex */
+    std::thread warm_up_thread_;            /*!< 事前接続スレッド */
+    std::mutex warm_up_mutex_;              /*!< 事前接続スレッド用Mutex */
+
+    /**
+     * REST Executorへのサービス設定反映(共有キャッシュを除く).
+     * @param[in]   executor    REST Executor
+     */
+    void ApplyExecutorSettings(NbRestExecutor *executor);
+
+    /**
+     * REST実行(データの送受信、統計情報の記録を除く).
+     * @param[in]   create_request  HTTPリクエスト作成関数ポインタ
+     * @param[in]   timeout         タイムアウト値(秒)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> DispatchRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                             int timeout);
+
+    /**
+     * REST Executor 取り出し(待ち時間指定).
+     * サービス設定と共有キャッシュを反映する。
+     * @param[in]   wait_timeout    HTTP接続空き待ちタイムアウト(ミリ秒)
+     * @return  REST Executor(同時接続数オーバーの場合はnullptr)
+     */
+    NbRestExecutor *AcquireRestExecutor(int wait_timeout);
+
+    /**
+     * REST Executor 取り出し(空きがある場合のみ).
+     * 同時接続数オーバーをエラーとして扱わない(ログ出力・失敗回数の計上を行わない)。
+     * サービス設定と共有キャッシュを反映する。
+     * @return  REST Executor(空きが無い場合はnullptr)
+     */
+    NbRestExecutor *TryAcquireRestExecutor();
+
+    /**
+     * 払い出したREST Executorへのサービス設定・共有キャッシュ反映.
+     * @param[in]   executor    REST Executor(nullptrの場合は何もしない)
+     * @return  executor
+     */
+    NbRestExecutor *SetUpRestExecutor(NbRestExecutor *executor);
+
+    /**
+     * REST実行(リクエスト作成済み).
+     * @param[in]   request             HTTPリクエスト
+     * @param[in]   executor_method     Executor関数ポインタ
+     * @param[in]   retryable           リトライ可否
+     * @param[in]   reserved_executor   予約済みREST Executor(nullptrの場合はプールから払い出す)
+     * @return      処理結果
+     */
+    NbResult<NbHttpResponse> ExecutePooled(
+        const NbHttpRequest &request,
+        std::function<NbResult<NbHttpResponse>(NbRestExecutor *, const NbHttpRequest &)> executor_method,
+        bool retryable = true, NbRestExecutor *reserved_executor = nullptr);
+
+    /**
+     * ヘッジリクエスト実行(1回分).
+     * @param[in]   request     HTTPリクエスト
+     * @param[in]   timeout     RESTタイムアウト(秒)
+     * @param[in]   policy      ヘッジリクエストポリシー
+     * @return      先に成功、またはリトライ不可のエラーで完了した転送の処理結果(全てリトライ可能なエラーの場合は最後のエラー)
+     */
+    NbResult<NbHttpResponse> ExecuteHedgedRequest(const NbHttpRequest &request, int timeout,
+                                                  const NbHedgePolicy &policy);
+
+    /**
+     * ヘッジリクエスト転送(1転送分).
+     * 呼び出し元スレッドで転送し、処理結果を共有データに反映してREST Executorを返却する。
+     * REST Executorは呼び出し前に共有データの転送中リストに登録すること。
+     * @param[in]   state       共有データ
+     * @param[in]   executor    REST Executor
+     * @param[in]   request     HTTPリクエスト
+     */
+    void RunHedgeTransfer(const std::shared_ptr<HedgeState> &state, NbRestExecutor *executor,
+                          const NbHttpRequest &request);
+
+    /**
+     * ヘッジリクエスト転送開始(重複送信分).
+     * 転送はバックグラウンドスレッドで行う。共有データのMutexをロックして呼び出すこと。
+     * @param[in]   state       共有データ
+     * @param[in]   executor    REST Executor(転送中リストに登録済み)
+     */
+    void StartHedgeWorker(const std::shared_ptr<HedgeState> &state, NbRestExecutor *executor);
+
+    /**
+     * 重複送信の予約.
+     * 指定時刻に最初の転送が完了していなければ、タイマースレッドから重複送信する。
+     * @param[in]   state       共有データ
+     * @param[in]   deadline    重複送信する時刻
+     */
+    void ScheduleHedge(const std::shared_ptr<HedgeState> &state, std::chrono::steady_clock::time_point deadline);
+
+    /**
+     * 重複送信タイマースレッド処理.
+     */
+    void RunHedgeTimer();
+
+    /**
+     * 重複送信(タイマー満了時).
+     * 空きREST Executorが無い場合は重複送信しない。
+     * @param[in]   state       共有データ
+     */
+    void SendHedge(const std::shared_ptr<HedgeState> &state);
+
+    /**
+     * リトライポリシーに従ったREST実行.
+     * 各試行はサーキットブレーカーで実行可否を判定し、結果を記録する。
+     * @param[in]   request     HTTPリクエスト(リトライ対象の判定に使用する)
+     * @param[in]   attempt     1回分のREST実行関数
+     * @param[in]   retryable   リトライ可否(falseの場合は1回のみ実行する)
+     * @return      処理結果(リトライ回数を設定する)
+     */
+    NbResult<NbHttpResponse> ExecuteWithRetry(const NbHttpRequest &request,
+                                              std::function<NbResult<NbHttpResponse>()> attempt,
+                                              bool retryable = true);
+
+    /**
+     * サービスインスタンス破棄(CreateService()で生成したshared_ptrのデリータ).
+     * 非同期実行エンジンのイベントループスレッドで最後の参照が解放された場合は、
+     * デストラクタがループスレッド上でエンジン停止・curlpp::terminate()を行わないよう、別スレッドで破棄する。
+     * @param[in]   service     サービスインスタンス
+     */
+    static void DeleteService(NbService *service);
 
    protected:
     /**
@@ -184,6 +798,21 @@ class NbService {
      */
     virtual void PushRestExecutor(NbRestExecutor *executor);
 
+    /**
+     * 非同期リクエスト登録.
+     * 非同期実行エンジンは初回登録時に生成する。
+     * @param[in]   request     HTTPリクエスト
+     * @param[in]   timeout     RESTタイムアウト(秒)
+     * @param[in]   callback    完了コールバック
+     */
+    virtual void SubmitAsyncRequest(const NbHttpRequest &request, int timeout, NbRestAsyncEngine::Callback callback);
+
+    /**
+     * 非同期実行エンジンのイベントループスレッド判定.
+     * @return  true:呼び出し元がイベントループスレッド
+     */
+    bool IsAsyncLoopThread();
+
     /**
      * HTTPリクエストファクトリ取得.
      * @param[in]   executor    RESTタイムアウト(秒)
@@ -195,11 +824,14 @@ class NbService {
      * REST実行(共通処理).
      * @param[in]   create_request         HTTPリクエスト作成関数ポインタ
      * @param[in]   executor_method        Executor関数ポインタ
+     * @param[in]   retryable              リトライ可否
+     * @param[in]   reserved_executor      予約済みREST Executor(nullptrの場合はプールから払い出す)
      * @return      処理結果
      */
     NbResult<NbHttpResponse> ExecuteCommon(
         std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
-        std::function<NbResult<NbHttpResponse>(NbRestExecutor *, const NbHttpRequest &)> executor_method);
+        std::function<NbResult<NbHttpResponse>(NbRestExecutor *, const NbHttpRequest &)> executor_method,
+        bool retryable = true, NbRestExecutor *reserved_executor = nullptr);
 };
 }  // namespace necbaas
 #endif  // NECBAAS_NBSERVICE_H
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBSTATISTICS_H
+#define NECBAAS_NBSTATISTICS_H
+
+#include <map>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "necbaas/nb_result_code.h"
+#include "necbaas/internal/nb_rest_executor_pool.h"
+
+namespace necbaas {
+
+/**
+ * 統計情報の操作種別.
+ */
+enum class NbOperation {
+    OBJECT_QUERY,   /*!< オブジェクトクエリ */
+    OBJECT_GET,     /*!< オブジェクト取得 */
+    OBJECT_SAVE,    /*!< オブジェクト保存(部分更新を含む) */
+    OBJECT_DELETE,  /*!< オブジェクト削除 */
+    FILE_UPLOAD,    /*!< ファイルアップロード */
+    FILE_DOWNLOAD,  /*!< ファイルダウンロード */
+    FILE_DELETE,    /*!< ファイル削除 */
+    FILE_LIST,      /*!< ファイル一覧取得 */
+    LOGIN,          /*!< ログイン */
+    LOGOUT,         /*!< ログアウト */
+    CUSTOM_API,     /*!< カスタムAPI */
+    OTHER,          /*!< その他 */
+};
+
+/**
+ * @class NbLatencyHistogram nb_statistics.h "necbaas/nb_statistics.h"
+ * 所要時間ヒストグラム.
+ * 所要時間(マイクロ秒)を、2のべき乗毎に16分割した区間(相対誤差6.25%以下)で集計する。
+ *
+ * <b>本クラスのインスタンスはスレッドセーフではない</b>
+ */
+class NbLatencyHistogram {
+  public:
+    static const int kBucketNum = 592;  /*!< 区間数 */
+
+    /**
+     * コンストラクタ.
+     */
+    NbLatencyHistogram();
+
+    /**
+     * 記録数取得.
+     * @return      記録数
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * 最小値取得.
+     * @return      最小値(マイクロ秒。記録が無い場合は0)
+     */
+    int64_t GetMin() const;
+
+    /**
+     * 最大値取得.
+     * @return      最大値(マイクロ秒。記録が無い場合は0)
+     */
+    int64_t GetMax() const;
+
+    /**
+     * 平均値取得.
+     * @return      平均値(マイクロ秒。記録が無い場合は0)
+     */
+    double GetMean() const;
+
+    /**
+     * パーセンタイル値取得.
+     * 該当する区間の上限値を返す(最大値を超えない)。
+     * @param[in]   percentile  パーセンタイル(0～100)
+     * @return      パーセンタイル値(マイクロ秒。記録が無い場合は0)
+     */
+    int64_t GetPercentile(double percentile) const;
+
+    /**
+     * 区間別記録数取得.
+     * @return      記録のある区間の上限値(マイクロ秒)と記録数のリスト(昇順)
+     */
+    std::vector<std::pair<int64_t, uint64_t>> GetBuckets() const;
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>区間番号取得.</p>
+     * @param[in]   value_us    所要時間(マイクロ秒)
+     * @return      区間番号
+     */
+    static int GetBucketIndex(int64_t value_us);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>区間の上限値取得.</p>
+     * @param[in]   index       区間番号
+     * @return      上限値(マイクロ秒)
+     */
+    static int64_t GetBucketUpperBound(int index);
+
+    /**
+     * <b>[内部処理用]</b>
+     * @internal
+     * <p>集計値設定.</p>
+     * @param[in]   counts      区間別記録数(kBucketNum個)
+     * @param[in]   sum_us      合計値(マイクロ秒)
+     * @param[in]   min_us      最小値(マイクロ秒)
+     * @param[in]   max_us      最大値(マイクロ秒)
+     */
+    void Set(const std::vector<uint64_t> &counts, int64_t sum_us, int64_t min_us, int64_t max_us);
+
+  private:
+    std::vector<uint64_t> counts_;  /*!< 区間別記録数 */
+    uint64_t count_{0};             /*!< 記録数 */
+    int64_t sum_{0};                /*!< 合計値 */
+    int64_t min_{0};                /*!< 最小値 */
+    int64_t max_{0};                /*!< 最大値 */
+};
+
+/**
+ * @struct NbOperationStatistics nb_statistics.h "necbaas/nb_statistics.h"
+ * 操作種別毎の統計情報.
+ * REST API(リトライを含む)1回の呼び出しを1リクエストとして集計する。
+ */
+struct NbOperationStatistics {
+    uint64_t request_count{0};                      /*!< リクエスト数 */
+    uint64_t error_count{0};                        /*!< エラー数(NB_OK以外) */
+    std::map<NbResultCode, uint64_t> result_counts; /*!< 処理結果コード別の件数(0件のコードは含まない) */
+    uint64_t bytes_sent{0};                         /*!< 送信バイト数(ヘッダを含む) */
+    uint64_t bytes_received{0};                     /*!< 受信バイト数(ヘッダを含む) */
+    NbLatencyHistogram latency;                     /*!< 所要時間(HTTP接続空き待ちを含む) */
+};
+
+/**
+ * @struct NbStatistics nb_statistics.h "necbaas/nb_statistics.h"
+ * サービス統計情報.
+ */
+struct NbStatistics {
+    std::map<NbOperation, NbOperationStatistics> operations;    /*!< 操作種別毎の統計情報(実行した操作のみ) */
+    NbRestExecutorPoolStatistics connection_pool;               /*!< REST Executorプール統計情報(空き待ち時間等) */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBSTATISTICS_H
@@ -0,0 +1,35 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBTRANSFERINFO_H
+#define NECBAAS_NBTRANSFERINFO_H
+
+#include <cstdint>
+
+namespace necbaas {
+
+/**
+ * @struct NbTransferInfo nb_transfer_info.h "necbaas/nb_transfer_info.h"
+ * REST API転送情報.
+ * CURLが計測した転送の所要時間内訳と送受信バイト数。
+ * 時間はいずれもリクエスト開始からの経過時間(マイクロ秒)で、該当するフェーズが無い場合は0となる。<br>
+ * 例: DNS解決時間 = name_lookup_time_us、サーバ処理時間 = start_transfer_time_us - pre_transfer_time_us<br>
+ * バイト数はいずれも転送したバイト数で、圧縮されている場合は圧縮状態のサイズとなる。
+ * 展開後の受信ボディサイズは NbHttpResponse::GetResponseBodySize() で確認できる。
+ */
+struct NbTransferInfo {
+    int64_t name_lookup_time_us{0};     /*!< DNS解決完了までの時間 */
+    int64_t connect_time_us{0};         /*!< TCP接続完了までの時間 */
+    int64_t app_connect_time_us{0};     /*!< TLSハンドシェイク完了までの時間 */
+    int64_t pre_transfer_time_us{0};    /*!< 送信開始直前までの時間 */
+    int64_t start_transfer_time_us{0};  /*!< 最初の受信バイトまでの時間 */
+    int64_t total_time_us{0};           /*!< 転送完了までの時間 */
+    int64_t request_size{0};            /*!< 送信したHTTPリクエストのバイト数(CURLが計測したヘッダ等、リダイレクト分を含む) */
+    int64_t response_header_size{0};    /*!< 受信したHTTPレスポンスのヘッダバイト数 */
+    int64_t upload_size{0};             /*!< 送信したHTTPボディのバイト数(圧縮後) */
+    int64_t download_size{0};           /*!< 受信したHTTPボディのバイト数(展開前) */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBTRANSFERINFO_H
@@ -0,0 +1,23 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#ifndef NECBAAS_NBWARMUPRESULT_H
+#define NECBAAS_NBWARMUPRESULT_H
+
+#include <cstdint>
+
+namespace necbaas {
+
+/**
+ * @struct NbWarmUpResult nb_warm_up_result.h "necbaas/nb_warm_up_result.h"
+ * 事前接続結果.
+ */
+struct NbWarmUpResult {
+    int connected_count{0};         /*!< 接続に成功したREST Executor数 */
+    int failed_count{0};            /*!< 接続に失敗したREST Executor数 */
+    int64_t elapsed_time_ms{0};     /*!< 事前接続の所要時間(ミリ秒) */
+};
+} //namespace necbaas
+
+#endif //NECBAAS_NBWARMUPRESULT_H
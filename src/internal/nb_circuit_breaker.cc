@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_circuit_breaker.h"
+#include "necbaas/internal/nb_logger.h"
+
+namespace necbaas {
+
+// 実行結果の記録ビット
+static const uint8_t kOutcomeFailure = 0x01;
+static const uint8_t kOutcomeSlow = 0x02;
+
+NbCircuitBreakerPolicy NbCircuitBreaker::GetPolicy() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return policy_;
+}
+
+void NbCircuitBreaker::SetPolicy(const NbCircuitBreakerPolicy &policy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    policy_ = policy;
+    TransitionTo(NbCircuitBreakerState::CLOSED);
+}
+
+NbCircuitBreakerState NbCircuitBreaker::GetState() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    UpdateState();
+    return state_;
+}
+
+bool NbCircuitBreaker::IsCallPermitted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!policy_.enabled) {
+        return true;
+    }
+    UpdateState();
+    switch (state_) {
+        case NbCircuitBreakerState::CLOSED:
+            return true;
+        case NbCircuitBreakerState::HALF_OPEN:
+            return half_open_acquired_ < policy_.half_open_calls;
+        default:
+            return false;
+    }
+}
+
+bool NbCircuitBreaker::TryAcquire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!policy_.enabled) {
+        return true;
+    }
+    UpdateState();
+    switch (state_) {
+        case NbCircuitBreakerState::CLOSED:
+            return true;
+        case NbCircuitBreakerState::HALF_OPEN:
+            if (half_open_acquired_ < policy_.half_open_calls) {
+                ++half_open_acquired_;
+                return true;
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+void NbCircuitBreaker::OnComplete(bool failure, int64_t elapsed_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!policy_.enabled) {
+        return;
+    }
+    bool slow = (policy_.slow_call_threshold_ms > 0 && elapsed_ms >= policy_.slow_call_threshold_ms);
+
+    switch (state_) {
+        case NbCircuitBreakerState::CLOSED: {
+            // 直近window_size件の結果を保持し、最も古い結果を置き換える
+            uint8_t outcome = (failure ? kOutcomeFailure : 0) | (slow ? kOutcomeSlow : 0);
+            if (count_ == outcomes_.size()) {
+                failure_count_ -= (outcomes_[next_] & kOutcomeFailure) ? 1 : 0;
+                slow_count_ -= (outcomes_[next_] & kOutcomeSlow) ? 1 : 0;
+            } else {
+                ++count_;
+            }
+            outcomes_[next_] = outcome;
+            next_ = (next_ + 1) % outcomes_.size();
+            failure_count_ += failure ? 1 : 0;
+            slow_count_ += slow ? 1 : 0;
+
+            if (static_cast<int>(count_) >= policy_.minimum_calls &&
+                (failure_count_ * 100 >= policy_.failure_rate_threshold * static_cast<int>(count_) ||
+                 slow_count_ * 100 >= policy_.slow_call_rate_threshold * static_cast<int>(count_))) {
+                NBLOG(INFO) << "Circuit breaker opened. calls:" << count_ << " failure:" << failure_count_
+                            << " slow:" << slow_count_;
+                TransitionTo(NbCircuitBreakerState::OPEN);
+            }
+            break;
+        }
+        case NbCircuitBreakerState::HALF_OPEN:
+            if (failure || slow) {
+                NBLOG(INFO) << "Circuit breaker reopened.";
+                TransitionTo(NbCircuitBreakerState::OPEN);
+            } else if (++half_open_succeeded_ >= policy_.half_open_calls) {
+                NBLOG(INFO) << "Circuit breaker closed.";
+                TransitionTo(NbCircuitBreakerState::CLOSED);
+            }
+            break;
+        default:
+            // 遮断前に開始したREST APIの結果は記録しない
+            break;
+    }
+}
+
+void NbCircuitBreaker::UpdateState() {
+    if (state_ == NbCircuitBreakerState::OPEN &&
+        std::chrono::steady_clock::now() - opened_at_ >= std::chrono::milliseconds(policy_.open_duration_ms)) {
+        NBLOG(INFO) << "Circuit breaker half-opened.";
+        TransitionTo(NbCircuitBreakerState::HALF_OPEN);
+    }
+}
+
+void NbCircuitBreaker::TransitionTo(NbCircuitBreakerState state) {
+    state_ = state;
+    switch (state) {
+        case NbCircuitBreakerState::CLOSED:
+            outcomes_.assign((policy_.window_size > 0) ? policy_.window_size : 1, 0);
+            next_ = 0;
+            count_ = 0;
+            failure_count_ = 0;
+            slow_count_ = 0;
+            break;
+        case NbCircuitBreakerState::OPEN:
+            opened_at_ = std::chrono::steady_clock::now();
+            break;
+        case NbCircuitBreakerState::HALF_OPEN:
+            half_open_acquired_ = 0;
+            half_open_succeeded_ = 0;
+            break;
+    }
+}
+} //namespace necbaas
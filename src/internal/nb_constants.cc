@@ -13,6 +13,13 @@ using std::string;
 //
 const int kHttpConnectionMax = 20;
 const int kRestTimeoutDefault = 60;
+const int kConnectionWaitTimeoutDefault = 0;
+const int kWarmUpTimeoutDefault = 10;
+const int kUploadBufferSize = 1024 * 1024;
+const int kDownloadBufferSize = 1024 * 1024;
+const int kRangeSegmentSizeMin = 256 * 1024;
+const string kResumeETagFileSuffix = ".etag";
+const int kTransferJobRetryInterval = 50;
 
 //
 // URI パス定義
@@ -40,6 +47,13 @@ const string kHeaderContentLength = "Content-Length";
 const string kHeaderXContentLength = "X-Content-Length";
 const string kHeaderXAcl = "X-ACL";
 const string kHeaderHost = "Host";
+const string kHeaderContentEncoding = "Content-Encoding";
+const string kHeaderContentEncodingGzip = "gzip";
+const string kHeaderTransferEncoding = "Transfer-Encoding";
+const string kHeaderRange = "Range";
+const string kHeaderIfRange = "If-Range";
+const string kHeaderContentRange = "Content-Range";
+const string kHeaderTransferEncodingChunked = "chunked";
 
 //
 // Key
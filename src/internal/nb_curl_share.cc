@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_curl_share.h"
+#include <cstdlib>
+#include "necbaas/internal/nb_logger.h"
+
+namespace necbaas {
+
+using std::shared_ptr;
+
+NbCurlShare::NbCurlShare() {
+    share_ = curl_share_init();
+    if (!share_) {
+        NBLOG(ERROR) << "curl_share_init error.";
+        return;
+    }
+    curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &NbCurlShare::Lock);
+    curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &NbCurlShare::Unlock);
+    curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    // 接続キャッシュは別スレッドで同時に転送するハンドル間の共有に対応していないため、共有しない
+}
+
+NbCurlShare::~NbCurlShare() {
+    if (share_) {
+        CURLSHcode code = curl_share_cleanup(share_);
+        if (code == CURLSHE_IN_USE) {
+            // 使用中のハンドルが解放後のMutexを参照するため、処理を継続しない
+            NBLOG(ERROR) << "curl share is still in use.";
+            std::abort();
+        } else if (code != CURLSHE_OK) {
+            NBLOG(ERROR) << "curl_share_cleanup error code:" << static_cast<int>(code);
+        }
+    }
+}
+
+CURLSH *NbCurlShare::GetHandle() const {
+    return share_;
+}
+
+shared_ptr<NbCurlShare> NbCurlShare::GetProcessShare() {
+    // 使用中のサービスが無くなった時点で解放し、curl_global_cleanup()後に残さない
+    static std::mutex mutex;
+    static std::weak_ptr<NbCurlShare> process_share;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    shared_ptr<NbCurlShare> share = process_share.lock();
+    if (!share) {
+        share = std::make_shared<NbCurlShare>();
+        process_share = share;
+    }
+    return share;
+}
+
+void NbCurlShare::Lock(CURL *handle, curl_lock_data data, curl_lock_access access, void *userptr) {
+    NbCurlShare *share = static_cast<NbCurlShare *>(userptr);
+    share->mutexes_[data].lock();
+}
+
+void NbCurlShare::Unlock(CURL *handle, curl_lock_data data, void *userptr) {
+    NbCurlShare *share = static_cast<NbCurlShare *>(userptr);
+    share->mutexes_[data].unlock();
+}
+} //namespace necbaas
@@ -3,20 +3,85 @@
  */
 
 #include "necbaas/internal/nb_http_file_download_handler.h"
-#include <thread>
+#include <fcntl.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include "necbaas/internal/nb_constants.h"
 #include "necbaas/internal/nb_logger.h"
 
 namespace necbaas {
 
 using std::string;
 
-NbHttpFileDownloadHandler::NbHttpFileDownloadHandler(const string &file_name) {
-    file_stream_.open(file_name, std::ios::out | std::ios::binary | std::ios::trunc);
+NbHttpFileDownloadHandler::NbHttpFileDownloadHandler(const string &file_name)
+    : file_name_(file_name), write_buffer_size_(kDownloadBufferSize) {
+    OpenFile(O_TRUNC);
 }
 
-NbHttpFileDownloadHandler::~NbHttpFileDownloadHandler() {}
+NbHttpFileDownloadHandler::NbHttpFileDownloadHandler(const string &file_name, bool resume)
+    : file_name_(file_name), resume_(resume), write_buffer_size_(kDownloadBufferSize) {
+    if (!resume_) {
+        OpenFile(O_TRUNC);
+    }
+}
+
+NbHttpFileDownloadHandler::~NbHttpFileDownloadHandler() {
+    if (fd_ >= 0) {
+        FlushBuffer();
+        close(fd_);
+    }
+}
+
+void NbHttpFileDownloadHandler::OpenFile(int flags) {
+    fd_ = open(file_name_.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | flags, 0666);
+    if (fd_ < 0) {
+        NBLOG(ERROR) << "file open error errno:" << errno;
+        error_ = true;
+    }
+}
 
-bool NbHttpFileDownloadHandler::IsError() const { return !file_stream_; }
+void NbHttpFileDownloadHandler::SetWriteBufferSize(size_t size) { write_buffer_size_ = size; }
+
+void NbHttpFileDownloadHandler::SetSyncEnabled(bool sync) { sync_ = sync; }
+
+size_t NbHttpFileDownloadHandler::WriteHeaderCallback(void *buffer, size_t size, size_t nmemb) {
+    size_t write_size = NbHttpHandler::WriteHeaderCallback(buffer, size, nmemb);
+
+    // ヘッダ終端(空行)で最終レスポンスのステータスコードを確定する
+    if (write_size != 2 || static_cast<const char *>(buffer)[0] != '\r') {
+        return write_size;
+    }
+    int status_code = 0;
+    ParseStatusLine(&status_code, nullptr);
+    if (status_code / 100 != 2) {
+        return write_size;
+    }
+
+    if (resume_ && fd_ < 0) {
+        tmp_status_code_ = status_code;
+        // 206の場合のみ既存のデータに追記する
+        OpenFile((status_code == 206) ? O_APPEND : O_TRUNC);
+        if (IsError()) {
+            return 0;
+        }
+        // 返却された範囲が保存済みデータの続きでなければ、追記するとファイルが壊れるため中断する
+        struct stat file_stat;
+        if (status_code == 206 && (fstat(fd_, &file_stat) != 0 || GetContentRangeStart() != file_stat.st_size)) {
+            NBLOG(ERROR) << "Content-Range does not match the saved data.";
+            error_ = true;
+            return 0;
+        }
+    }
+    if (fd_ >= 0 && !preallocated_) {
+        Preallocate();
+    }
+    return write_size;
+}
+
+bool NbHttpFileDownloadHandler::IsError() const { return error_; }
 
 size_t NbHttpFileDownloadHandler::WriteCallback(char *buffer, size_t size, size_t nmemb) {
     size_t write_size = size * nmemb;
@@ -25,19 +90,126 @@ size_t NbHttpFileDownloadHandler::WriteCallback(char *buffer, size_t size, size_
         // エラーの場合は基底クラスを実行
         NBLOG(ERROR) << "response failed code: " << tmp_status_code_;
         return NbHttpHandler::WriteCallback(buffer, size, nmemb);
-    } else {
-        file_stream_.write(buffer, write_size);
-        file_stream_.flush();
-        if (IsError()) {
-            // 書込みエラーのため処理中断
-            NBLOG(ERROR) << "file_stream: write error";
+    }
+    if (IsError() || fd_ < 0) {
+        return 0;
+    }
+
+    // バッファに収まらない場合は蓄積済みのデータを先に書込む
+    if (write_buffer_.size() + write_size > write_buffer_size_ && !FlushBuffer()) {
+        return 0;
+    }
+    if (write_size >= write_buffer_size_) {
+        // バッファサイズ以上のデータはバッファを経由せずに書込む
+        if (!WriteFile(buffer, write_size)) {
             return 0;
         }
+    } else {
+        if (write_buffer_.capacity() < write_buffer_size_) {
+            write_buffer_.reserve(write_buffer_size_);
+        }
+        write_buffer_.insert(write_buffer_.end(), buffer, buffer + write_size);
     }
 
     return write_size;
 }
 
+bool NbHttpFileDownloadHandler::Finish() {
+    if (fd_ < 0) {
+        return !IsError();
+    }
+    if (!FlushBuffer()) {
+        return false;
+    }
+    if (sync_ && fsync(fd_) != 0) {
+        NBLOG(ERROR) << "fsync error errno:" << errno;
+        error_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool NbHttpFileDownloadHandler::WriteFile(const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t written = write(fd_, data, size);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // 書込みエラーのため処理中断
+            NBLOG(ERROR) << "file write error errno:" << errno;
+            error_ = true;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool NbHttpFileDownloadHandler::FlushBuffer() {
+    if (write_buffer_.empty()) {
+        return !IsError();
+    }
+    bool result = WriteFile(write_buffer_.data(), write_buffer_.size());
+    write_buffer_.clear();
+    return result;
+}
+
+void NbHttpFileDownloadHandler::Preallocate() {
+    preallocated_ = true;
+    int64_t length = GetXContentLength();
+    if (length <= 0) {
+        return;
+    }
+#ifdef FALLOC_FL_KEEP_SIZE
+    // 追記する場合は既存データの後ろのみ確保する
+    struct stat file_stat;
+    if (fstat(fd_, &file_stat) != 0 || file_stat.st_size >= length) {
+        return;
+    }
+    // ファイルサイズを変更しないため、追記モードやサイズ検証に影響しない
+    if (fallocate(fd_, FALLOC_FL_KEEP_SIZE, file_stat.st_size, length - file_stat.st_size) != 0) {
+        NBLOG(INFO) << "fallocate failed errno:" << errno;
+    }
+#endif
+}
+
+const char *NbHttpFileDownloadHandler::FindHeaderValue(const string &name) const {
+    for (size_t line_index = ParseStatusLine(nullptr, nullptr); line_index < header_lines_.size(); ++line_index) {
+        const char *line = header_buffer_.data() + header_lines_[line_index].first;
+        size_t line_length = header_lines_[line_index].second;
+        if (line_length > name.size() && line[name.size()] == ':' &&
+            strncasecmp(line, name.c_str(), name.size()) == 0) {
+            return line + name.size() + 1;
+        }
+    }
+    return nullptr;
+}
+
+int64_t NbHttpFileDownloadHandler::GetXContentLength() const {
+    const char *value = FindHeaderValue(kHeaderXContentLength);
+    return (value != nullptr) ? std::strtoll(value, nullptr, 10) : -1;
+}
+
+int64_t NbHttpFileDownloadHandler::GetContentRangeStart() const {
+    // Content-Range: bytes first-last/complete-length
+    const char *value = FindHeaderValue(kHeaderContentRange);
+    if (value == nullptr) {
+        return -1;
+    }
+    while (*value == ' ' || *value == '\t') {
+        ++value;
+    }
+    static const char kUnit[] = "bytes ";
+    if (strncasecmp(value, kUnit, sizeof(kUnit) - 1) != 0) {
+        return -1;
+    }
+    char *end = nullptr;
+    int64_t first = std::strtoll(value + sizeof(kUnit) - 1, &end, 10);
+    return (end != value + sizeof(kUnit) - 1 && *end == '-') ? first : -1;
+}
+
 int NbHttpFileDownloadHandler::GetStatusCode() {
     if (tmp_status_code_ == 0) {
         ParseStatusLine(&tmp_status_code_, nullptr);
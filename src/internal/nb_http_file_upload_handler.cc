@@ -3,7 +3,10 @@
  */
 
 #include "necbaas/internal/nb_http_file_upload_handler.h"
-#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
 #include "necbaas/internal/nb_logger.h"
 
 namespace necbaas {
@@ -11,32 +14,54 @@ namespace necbaas {
 using std::string;
 
 NbHttpFileUploadHandler::NbHttpFileUploadHandler(const string &file_name) {
-    file_stream_.open(file_name, std::ios::in | std::ios::binary);
-}
+    fd_ = open(file_name.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd_ < 0) {
+        return;
+    }
 
-NbHttpFileUploadHandler::~NbHttpFileUploadHandler() {}
+    // サイズは同じディスクリプタから取得する(ファイルを開き直さない)
+    struct stat file_stat;
+    if (fstat(fd_, &file_stat) != 0) {
+        NBLOG(ERROR) << "fstat error errno:" << errno;
+        close(fd_);
+        fd_ = -1;
+        return;
+    }
+    file_size_ = file_stat.st_size;
 
-bool NbHttpFileUploadHandler::IsError() const { return !file_stream_; }
+    // 先頭から順に読み出すため、先読みを有効にする
+    posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
 
-size_t NbHttpFileUploadHandler::ReadCallback(void *buffer, size_t size, size_t nmemb) {
-    if (file_stream_.eof()) {
-        // ファイル終端なら転送終了
-        return 0;
+NbHttpFileUploadHandler::~NbHttpFileUploadHandler() {
+    if (fd_ >= 0) {
+        close(fd_);
     }
+}
+
+bool NbHttpFileUploadHandler::IsError() const { return fd_ < 0; }
+
+int64_t NbHttpFileUploadHandler::GetFileSize() const { return file_size_; }
 
+size_t NbHttpFileUploadHandler::ReadCallback(void *buffer, size_t size, size_t nmemb) {
     if (IsError()) {
         // エラー発生
-        NBLOG(ERROR) << "file_stream: read error";
+        NBLOG(ERROR) << "file read error";
         return 0;
     }
 
-    size_t read_size = (size_t)file_stream_.read((char *)buffer, size * nmemb).gcount();
-    if (read_size <= 0) {
+    // 送信バッファへ直接読み出す(ファイル終端なら0で転送終了)
+    ssize_t read_size;
+    do {
+        read_size = read(fd_, buffer, size * nmemb);
+    } while (read_size < 0 && errno == EINTR);
+
+    if (read_size < 0) {
         // 読み込み失敗
-        NBLOG(ERROR) << "file_stream: read error";
+        NBLOG(ERROR) << "file read error errno:" << errno;
         return 0;
     }
 
-    return read_size;
+    return static_cast<size_t>(read_size);
 }
 }  // namespace necbaas
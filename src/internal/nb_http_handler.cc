@@ -3,17 +3,30 @@
  */
 
 #include "necbaas/internal/nb_http_handler.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <strings.h>
 #include <thread>
+#include "necbaas/internal/nb_constants.h"
 #include "necbaas/internal/nb_logger.h"
+#include "necbaas/internal/nb_utility.h"
 
 namespace necbaas {
 
 using std::string;
 using std::vector;
 
-static const string kStatusCodeLineMarker = "HTTP/1.1 ";
-static const auto kSizeStatusLineMarker = kStatusCodeLineMarker.size();
-static const int kStatusCodeSize = 3;
+// ステータスラインの先頭(HTTP/2の場合、CURLはマイナーバージョンを付与しない)
+static const vector<string> kStatusLineMarkers{"HTTP/1.1 ", "HTTP/2 "};
+static const size_t kStatusCodeSize = 3;
+static const string kHttpVersionPrefix = "HTTP/";
+// ヘッダ格納領域の初期確保サイズ
+static const size_t kHeaderReserveSize = 1024;
+// Content-Lengthによる事前確保の上限(不正な値による過大な確保を防ぐ)
+static const size_t kBodyReserveMax = 64 * 1024 * 1024;
+// 無変換を表すContent-Encoding
+static const char kContentEncodingIdentity[] = "identity";
 
 NbHttpHandler::NbHttpHandler() {}
 NbHttpHandler::~NbHttpHandler() {}
@@ -25,17 +38,41 @@ size_t NbHttpHandler::ReadCallback(void *buffer, size_t size, size_t nmemb) {
 
 size_t NbHttpHandler::WriteHeaderCallback(void *buffer, size_t size, size_t nmemb) {
     size_t write_size = size * nmemb;
-    string header((char *)buffer, write_size);
-    response_headers_.push_back(header);
+    if (header_buffer_.empty()) {
+        header_buffer_.reserve(kHeaderReserveSize);
+    }
+    size_t offset = header_buffer_.size();
+    header_buffer_.append(static_cast<const char *>(buffer), write_size);
+    header_lines_.emplace_back(offset, write_size);
+
+    const char *line = header_buffer_.data() + offset;
+    if (header_buffer_.compare(offset, kHttpVersionPrefix.size(), kHttpVersionPrefix) == 0) {
+        // 新たなレスポンス(100 Continue、プロキシのCONNECT応答の後など)の開始
+        content_length_ = 0;
+        content_encoded_ = false;
+    } else {
+        const char *colon = static_cast<const char *>(std::memchr(line, ':', write_size));
+        if (colon && NbUtility::CompareCaseInsensitiveString(line, colon - line, kHeaderContentLength)) {
+            // 格納領域は終端文字を持つため、行末を超えて読むことはない
+            long long content_length = std::strtoll(colon + 1, nullptr, 10);
+            content_length_ = (content_length > 0) ? static_cast<size_t>(content_length) : 0;
+        } else if (colon && NbUtility::CompareCaseInsensitiveString(line, colon - line, kHeaderContentEncoding)) {
+            const char *value = colon + 1 + std::strspn(colon + 1, " \t");
+            content_encoded_ = (strncasecmp(value, kContentEncodingIdentity, sizeof(kContentEncodingIdentity) - 1) != 0);
+        }
+    }
 
     return write_size;
 }
 
 size_t NbHttpHandler::WriteCallback(char *buffer, size_t size, size_t nmemb) {
     size_t write_size = size * nmemb;
-    auto before_size = response_body_.size();
-    response_body_.resize(before_size + write_size);
-    std::copy(buffer, buffer + write_size, response_body_.begin() + before_size);
+    if (response_body_.empty() && content_length_ > 0 && !content_encoded_) {
+        // 受信サイズが分かっている場合は一括で確保し、再確保とコピーを避ける
+        // 圧縮転送時のContent-Lengthは展開前のサイズで展開後のサイズと一致しないため、確保しない
+        response_body_.reserve(std::min(content_length_, kBodyReserveMax));
+    }
+    response_body_.insert(response_body_.end(), buffer, buffer + write_size);
 
     return write_size;
 }
@@ -45,86 +82,102 @@ NbHttpResponse NbHttpHandler::Parse() {
     string reason_phrase{};
 
     //レスポンスの１行目からステータスコードとリーズンフレーズを取得
-    auto header_line = ParseStatusLine(&status_code, &reason_phrase);
+    size_t line_index = ParseStatusLine(&status_code, &reason_phrase);
 
-    std::multimap<std::string, std::string> headers{};
+    vector<NbHttpResponse::HeaderField> header_fields;
+    header_fields.reserve(header_lines_.size() - std::min(line_index, header_lines_.size()));
     //２行目以降はヘッダ情報
-    for (; header_line != response_headers_.end(); ++header_line) {
-        auto index = header_line->find_first_of(':');
-        if (index != string::npos) {
-            // assume normal header
-            // key
-            string header_key = header_line->substr(0, index);
-            // value
-            string header_value = header_line->substr(index + 1);
-            // remove \r\n at the tail
-            if (header_value.length() >= 2) {
-                header_value = header_value.substr(0, header_value.length() - 2);
-            } else {
-                //異常値(改行コード(CRLF)は必須)
-                header_value.clear();
-            }
-            // 前方スペースを削除
-            string::size_type not_space = header_value.find_first_not_of(' ');
-            if (not_space == string::npos) {
-                header_value.clear();
-            } else if (not_space > 0) {
-                header_value = header_value.substr(not_space);
-            }
+    for (; line_index < header_lines_.size(); ++line_index) {
+        size_t line_offset = header_lines_[line_index].first;
+        size_t line_length = header_lines_[line_index].second;
+        const char *line = header_buffer_.data() + line_offset;
+
+        const char *colon = static_cast<const char *>(std::memchr(line, ':', line_length));
+        if (!colon) {
+            continue;
+        }
+        NbHttpResponse::HeaderField field;
+        field.name_offset = line_offset;
+        field.name_length = colon - line;
 
-            headers.insert(std::make_pair(header_key, header_value));
+        // 値は':'の次から行末まで
+        field.value_offset = line_offset + field.name_length + 1;
+        field.value_length = line_length - field.name_length - 1;
+        // remove \r\n at the tail
+        if (field.value_length >= 2) {
+            field.value_length -= 2;
+        } else {
+            //異常値(改行コード(CRLF)は必須)
+            field.value_length = 0;
         }
+        // 前方スペースを削除
+        while (field.value_length > 0 && header_buffer_[field.value_offset] == ' ') {
+            ++field.value_offset;
+            --field.value_length;
+        }
+
+        header_fields.push_back(field);
     }
 
-    // HTTPレスポンス設定
-    NbHttpResponse http_response(status_code, reason_phrase, headers, std::move(response_body_));
+    // HTTPレスポンス設定(ヘッダは格納領域ごと引き継ぐ)
+    NbHttpResponse http_response(status_code, std::move(reason_phrase), std::move(header_buffer_),
+                                 std::move(header_fields), std::move(response_body_));
     return http_response;
 }
 
-vector<string>::iterator NbHttpHandler::SearchStatusLine() {
-    //ステータスラインを後方検索
-    // PROXYを使用する場合、HTTP CONNECTの情報も取得してしまうため
-    auto it = response_headers_.end();
-
-    if (response_headers_.empty()) {
-        return it;
-    }
-    
-    for (auto header_line = response_headers_.end() - 1; ; --header_line) {
-        if ((header_line->length() > kSizeStatusLineMarker + kStatusCodeSize) &&
-            (header_line->substr(0, kSizeStatusLineMarker) == kStatusCodeLineMarker)) {
-            it = header_line;
-            break;
+size_t NbHttpHandler::GetStatusLineMarkerSize(size_t line_index) const {
+    size_t line_offset = header_lines_[line_index].first;
+    size_t line_length = header_lines_[line_index].second;
+    for (const auto &marker : kStatusLineMarkers) {
+        if ((line_length > marker.size() + kStatusCodeSize) &&
+            (header_buffer_.compare(line_offset, marker.size(), marker) == 0)) {
+            return marker.size();
         }
+    }
+    return 0;
+}
 
-        // デクリメント前に脱出条件評価
-        if (header_line == response_headers_.begin()) {
-            break;
+size_t NbHttpHandler::SearchStatusLine() const {
+    //ステータスラインを後方検索
+    // PROXYを使用する場合、HTTP CONNECTの情報も取得してしまうため
+    for (size_t line_index = header_lines_.size(); line_index > 0; --line_index) {
+        if (GetStatusLineMarkerSize(line_index - 1) > 0) {
+            return line_index - 1;
         }
     }
-
-    return it;
+    return header_lines_.size();
 }
 
-vector<string>::iterator NbHttpHandler::ParseStatusLine(int *status_code, string *reason_phrase) {
-    vector<string>::iterator status_line = SearchStatusLine();
+size_t NbHttpHandler::ParseStatusLine(int *status_code, string *reason_phrase) const {
+    size_t status_line = SearchStatusLine();
 
-    if (status_line == response_headers_.end()) {
+    if (status_line == header_lines_.size()) {
         NBLOG(ERROR) << "There is no status line.";
         return status_line;
     }
 
-    string statusCodeStr = status_line->substr(kSizeStatusLineMarker, kStatusCodeSize);
+    size_t marker_size = GetStatusLineMarkerSize(status_line);
+    size_t line_offset = header_lines_[status_line].first;
+    size_t line_length = header_lines_[status_line].second;
+    const char *line = header_buffer_.data() + line_offset;
+
     if (status_code) {
-        *status_code = std::atoi(statusCodeStr.c_str());
+        *status_code = 0;
+        for (size_t i = marker_size; i < marker_size + kStatusCodeSize; ++i) {
+            if (line[i] < '0' || line[i] > '9') {
+                break;
+            }
+            *status_code = *status_code * 10 + (line[i] - '0');
+        }
     }
 
-    if (reason_phrase && (status_line->length() > kSizeStatusLineMarker + kStatusCodeSize + 1) &&
-        ((*status_line)[kSizeStatusLineMarker + kStatusCodeSize] == ' ')) {
-        *reason_phrase = status_line->substr(kSizeStatusLineMarker + kStatusCodeSize + 1);
+    if (reason_phrase && (line_length > marker_size + kStatusCodeSize + 1) &&
+        (line[marker_size + kStatusCodeSize] == ' ')) {
+        size_t phrase_offset = marker_size + kStatusCodeSize + 1;
+        size_t phrase_length = line_length - phrase_offset;
         // remove \r\n at the tail
-        if (reason_phrase->length() >= 2) {
-            *reason_phrase = reason_phrase->substr(0, reason_phrase->length() - 2);
+        if (phrase_length >= 2) {
+            reason_phrase->assign(line + phrase_offset, phrase_length - 2);
         } else {
             // 異常値(改行コード(CRLF)は必須)
             // ただし、ステータスコードの取得は成功とする
@@ -132,6 +185,6 @@ vector<string>::iterator NbHttpHandler::ParseStatusLine(int *status_code, string
         }
     }
 
-    return ++status_line;
+    return status_line + 1;
 }
 }  // namespace necbaas
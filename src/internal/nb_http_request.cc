@@ -28,6 +28,14 @@ const string &NbHttpRequest::GetBody() const { return body_; }
 
 const string &NbHttpRequest::GetProxy() const { return proxy_; }
 
+void NbHttpRequest::SetHedgeable(bool hedgeable) { hedgeable_ = hedgeable; }
+
+bool NbHttpRequest::IsHedgeable() const { return hedgeable_; }
+
+void NbHttpRequest::SetBodyCompressible(bool compressible) { body_compressible_ = compressible; }
+
+bool NbHttpRequest::IsBodyCompressible() const { return body_compressible_; }
+
 void NbHttpRequest::Dump() const {
     if (!NbLogger::IsRestLogEnabled()) {
         // RESTログ有効時のみ実行
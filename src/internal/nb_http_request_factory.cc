@@ -89,6 +89,16 @@ NbHttpRequestFactory &NbHttpRequestFactory::SessionNone() {
     return *this;
 }
 
+NbHttpRequestFactory &NbHttpRequestFactory::Hedgeable() {
+    hedgeable_ = true;
+    return *this;
+}
+
+NbHttpRequestFactory &NbHttpRequestFactory::CompressibleBody() {
+    body_compressible_ = true;
+    return *this;
+}
+
 NbHttpRequest NbHttpRequestFactory::Build() {
     auto url_params = CreateRequestParams();
     // end_point_url_の最後の'/'
@@ -118,7 +128,10 @@ NbHttpRequest NbHttpRequestFactory::Build() {
         }
     }
 
-    return NbHttpRequest(url, request_method_, header_list, body_, proxy_);
+    NbHttpRequest request(url, request_method_, header_list, body_, proxy_);
+    request.SetHedgeable(hedgeable_);
+    request.SetBodyCompressible(body_compressible_);
+    return request;
 }
 
 NbResultCode NbHttpRequestFactory::GetError() const { return error_; }
@@ -0,0 +1,37 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_http_stream_handler.h"
+#include "necbaas/internal/nb_logger.h"
+
+namespace necbaas {
+
+NbHttpStreamHandler::NbHttpStreamHandler(Sink sink) : sink_(std::move(sink)) {}
+
+NbHttpStreamHandler::~NbHttpStreamHandler() {}
+
+bool NbHttpStreamHandler::IsAborted() const { return aborted_; }
+
+size_t NbHttpStreamHandler::WriteCallback(char *buffer, size_t size, size_t nmemb) {
+    size_t write_size = size * nmemb;
+
+    if (tmp_status_code_ == 0) {
+        ParseStatusLine(&tmp_status_code_, nullptr);
+    }
+    if (tmp_status_code_ / 100 != 2) {
+        // エラーの場合は基底クラスを実行
+        NBLOG(ERROR) << "response failed code: " << tmp_status_code_;
+        return NbHttpHandler::WriteCallback(buffer, size, nmemb);
+    }
+
+    if (write_size > 0 && sink_ && !sink_(buffer, write_size)) {
+        // 出力先の要求により処理中断
+        NBLOG(ERROR) << "Response sink aborted.";
+        aborted_ = true;
+        return 0;
+    }
+
+    return write_size;
+}
+}  // namespace necbaas
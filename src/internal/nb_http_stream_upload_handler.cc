@@ -0,0 +1,33 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_http_stream_upload_handler.h"
+#include <curl/curl.h>
+#include "necbaas/internal/nb_logger.h"
+
+namespace necbaas {
+
+NbHttpStreamUploadHandler::NbHttpStreamUploadHandler(Producer producer) : producer_(std::move(producer)) {}
+
+NbHttpStreamUploadHandler::~NbHttpStreamUploadHandler() {}
+
+bool NbHttpStreamUploadHandler::IsAborted() const { return aborted_; }
+
+size_t NbHttpStreamUploadHandler::ReadCallback(void *buffer, size_t size, size_t nmemb) {
+    if (!producer_) {
+        return 0;
+    }
+
+    size_t buffer_size = size * nmemb;
+    int64_t produced = producer_(static_cast<char *>(buffer), buffer_size);
+    if (produced < 0 || static_cast<uint64_t>(produced) > buffer_size) {
+        // 生成関数の要求、または不正なサイズにより処理中断
+        NBLOG(ERROR) << "Request producer aborted. size:" << produced;
+        aborted_ = true;
+        return CURL_READFUNC_ABORT;
+    }
+
+    return static_cast<size_t>(produced);
+}
+}  // namespace necbaas
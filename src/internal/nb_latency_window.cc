@@ -0,0 +1,52 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_latency_window.h"
+#include <algorithm>
+
+namespace necbaas {
+
+NbLatencyWindow::NbLatencyWindow(int window_size) {
+    Resize(window_size);
+}
+
+void NbLatencyWindow::Resize(int window_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_.assign((window_size > 0) ? window_size : 1, 0);
+    next_ = 0;
+    count_ = 0;
+}
+
+void NbLatencyWindow::Add(int64_t latency_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    latencies_[next_] = latency_ms;
+    next_ = (next_ + 1) % latencies_.size();
+    if (count_ < latencies_.size()) {
+        ++count_;
+    }
+}
+
+int NbLatencyWindow::GetCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(count_);
+}
+
+int64_t NbLatencyWindow::GetPercentile(int percentile) {
+    std::vector<int64_t> sorted;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (count_ == 0) {
+            return 0;
+        }
+        sorted.assign(latencies_.begin(), latencies_.begin() + count_);
+    }
+
+    // 最近傍順位法(nearest-rank)
+    percentile = std::max(0, std::min(100, percentile));
+    size_t rank = (sorted.size() * percentile + 99) / 100;
+    size_t index = (rank > 0) ? rank - 1 : 0;
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+} //namespace necbaas
@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_metrics_registry.h"
+#include <limits>
+#include <vector>
+
+namespace necbaas {
+
+NbMetricsRegistry::NbMetricsRegistry() {
+    Reset();
+}
+
+void NbMetricsRegistry::Record(NbOperation operation, const NbResult<NbHttpResponse> &result, int64_t elapsed_us) {
+    int operation_index = static_cast<int>(operation);
+    int code_index = static_cast<int>(result.GetResultCode());
+    if (operation_index < 0 || operation_index >= kOperationNum || code_index < 0 || code_index >= kResultCodeNum) {
+        return;
+    }
+    Metrics &metrics = metrics_[operation_index];
+
+    // 集計値同士の整合は取得時にも保証しないため、全てrelaxedで更新する
+    metrics.result_counts[code_index].fetch_add(1, std::memory_order_relaxed);
+
+    const NbTransferInfo &transfer_info = result.GetTransferInfo();
+    metrics.bytes_sent.fetch_add(transfer_info.request_size + transfer_info.upload_size, std::memory_order_relaxed);
+    metrics.bytes_received.fetch_add(transfer_info.response_header_size + transfer_info.download_size,
+                                     std::memory_order_relaxed);
+
+    elapsed_us = (elapsed_us > 0) ? elapsed_us : 0;
+    metrics.latency_counts[NbLatencyHistogram::GetBucketIndex(elapsed_us)].fetch_add(1, std::memory_order_relaxed);
+    metrics.latency_sum.fetch_add(elapsed_us, std::memory_order_relaxed);
+
+    int64_t current = metrics.latency_min.load(std::memory_order_relaxed);
+    while (elapsed_us < current &&
+           !metrics.latency_min.compare_exchange_weak(current, elapsed_us, std::memory_order_relaxed)) {
+    }
+    current = metrics.latency_max.load(std::memory_order_relaxed);
+    while (elapsed_us > current &&
+           !metrics.latency_max.compare_exchange_weak(current, elapsed_us, std::memory_order_relaxed)) {
+    }
+}
+
+void NbMetricsRegistry::GetStatistics(NbStatistics *statistics) const {
+    statistics->operations.clear();
+
+    for (int i = 0; i < kOperationNum; ++i) {
+        const Metrics &metrics = metrics_[i];
+        NbOperationStatistics operation_statistics;
+        for (int code = 0; code < kResultCodeNum; ++code) {
+            uint64_t count = metrics.result_counts[code].load(std::memory_order_relaxed);
+            if (count == 0) {
+                continue;
+            }
+            operation_statistics.result_counts[static_cast<NbResultCode>(code)] = count;
+            operation_statistics.request_count += count;
+            if (code != static_cast<int>(NbResultCode::NB_OK)) {
+                operation_statistics.error_count += count;
+            }
+        }
+        if (operation_statistics.request_count == 0) {
+            continue;
+        }
+        operation_statistics.bytes_sent = metrics.bytes_sent.load(std::memory_order_relaxed);
+        operation_statistics.bytes_received = metrics.bytes_received.load(std::memory_order_relaxed);
+
+        std::vector<uint64_t> counts(NbLatencyHistogram::kBucketNum);
+        for (int bucket = 0; bucket < NbLatencyHistogram::kBucketNum; ++bucket) {
+            counts[bucket] = metrics.latency_counts[bucket].load(std::memory_order_relaxed);
+        }
+        int64_t min = metrics.latency_min.load(std::memory_order_relaxed);
+        operation_statistics.latency.Set(counts, metrics.latency_sum.load(std::memory_order_relaxed),
+                                         (min == std::numeric_limits<int64_t>::max()) ? 0 : min,
+                                         metrics.latency_max.load(std::memory_order_relaxed));
+
+        statistics->operations[static_cast<NbOperation>(i)] = std::move(operation_statistics);
+    }
+}
+
+void NbMetricsRegistry::Reset() {
+    for (auto &metrics : metrics_) {
+        for (auto &count : metrics.result_counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+        metrics.bytes_sent.store(0, std::memory_order_relaxed);
+        metrics.bytes_received.store(0, std::memory_order_relaxed);
+        metrics.latency_sum.store(0, std::memory_order_relaxed);
+        metrics.latency_min.store(std::numeric_limits<int64_t>::max(), std::memory_order_relaxed);
+        metrics.latency_max.store(0, std::memory_order_relaxed);
+        for (auto &count : metrics.latency_counts) {
+            count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+} //namespace necbaas
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_rest_async_engine.h"
+#include <unistd.h>
+#include <fcntl.h>
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <atomic>
+#include "necbaas/internal/nb_rest_executor.h"
+#include "necbaas/internal/nb_logger.h"
+
+namespace necbaas {
+
+using std::unique_ptr;
+using std::shared_ptr;
+
+// イベント待ちの最大時間(ミリ秒)
+static const int kLoopWaitTimeoutMs = 1000;
+
+// イベントループ共有データ
+// pending, stop, executor_setup はmutexで保護する。それ以外はイベントループスレッドのみがアクセスする。
+struct NbRestAsyncEngine::Context {
+    // 転送単位
+    struct Transfer {
+        Transfer(const NbHttpRequest &request, int timeout, Callback callback)
+            : request(request), timeout(timeout), callback(std::move(callback)) {}
+
+        NbHttpRequest request;                  /*!< HTTPリクエスト */
+        int timeout;                            /*!< RESTタイムアウト(秒) */
+        Callback callback;                      /*!< 完了コールバック */
+        unique_ptr<NbRestExecutor> executor;    /*!< 転送に使用するRestExecutor */
+    };
+
+    explicit Context(int http_connection_max) : idle_max(http_connection_max) {
+        multi = curl_multi_init();
+        if (multi) {
+            // 同時接続数を制限する。超過分はCURL内部で接続の空き待ちとなる
+            curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, static_cast<long>(http_connection_max));
+            curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, static_cast<long>(http_connection_max));
+            // HTTP/2接続では複数の転送を多重化する
+            curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        }
+        if (pipe(wakeup_pipe) == 0) {
+            fcntl(wakeup_pipe[0], F_SETFL, fcntl(wakeup_pipe[0], F_GETFL) | O_NONBLOCK);
+            fcntl(wakeup_pipe[1], F_SETFL, fcntl(wakeup_pipe[1], F_GETFL) | O_NONBLOCK);
+        } else {
+            NBLOG(ERROR) << "pipe create error.";
+            wakeup_pipe[0] = wakeup_pipe[1] = -1;
+        }
+    }
+
+    ~Context() {
+        if (multi) {
+            curl_multi_cleanup(multi);
+        }
+        for (auto fd : wakeup_pipe) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+    }
+
+    // イベントループを起こす
+    void Wakeup() {
+        if (wakeup_pipe[1] >= 0) {
+            char dummy = 0;
+            // パイプが満杯(EAGAIN)の場合は既に起床要求済みのため無視する
+            ssize_t ret = write(wakeup_pipe[1], &dummy, 1);
+            (void)ret;
+        }
+    }
+
+    // 起床要求を読み捨てる
+    void DrainWakeup() {
+        if (wakeup_pipe[0] >= 0) {
+            char buf[64];
+            while (read(wakeup_pipe[0], buf, sizeof(buf)) > 0) {
+            }
+        }
+    }
+
+    // 転送開始
+    void Start(unique_ptr<Transfer> transfer) {
+        if (!multi) {
+            NBLOG(ERROR) << "curl multi handle is not available.";
+            Finish(*transfer, NbResult<NbHttpResponse>(NbResultCode::NB_ERROR_CURL_FATAL));
+            return;
+        }
+
+        if (idle_executors.empty()) {
+            transfer->executor.reset(new NbRestExecutor());
+        } else {
+            transfer->executor = std::move(idle_executors.back());
+            idle_executors.pop_back();
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (executor_setup) {
+                executor_setup(transfer->executor.get());
+            }
+        }
+
+        NbResultCode result_code = transfer->executor->PrepareAsyncRequest(transfer->request, transfer->timeout);
+        if (result_code != NbResultCode::NB_OK) {
+            Finish(*transfer, NbResult<NbHttpResponse>(result_code));
+            Recycle(std::move(transfer->executor));
+            return;
+        }
+
+        CURL *handle = transfer->executor->GetCurlHandle();
+        CURLMcode multi_code = curl_multi_add_handle(multi, handle);
+        if (multi_code != CURLM_OK) {
+            NBLOG(ERROR) << "curl_multi_add_handle error code:" << static_cast<int>(multi_code);
+            Finish(*transfer, NbResult<NbHttpResponse>(NbResultCode::NB_ERROR_CURL_FATAL));
+            Recycle(std::move(transfer->executor));
+            return;
+        }
+        active[handle] = std::move(transfer);
+    }
+
+    // 完了した転送を回収し、コールバックを呼び出す
+    void CollectCompleted() {
+        CURLMsg *message;
+        int remaining = 0;
+        while ((message = curl_multi_info_read(multi, &remaining)) != nullptr) {
+            if (message->msg != CURLMSG_DONE) {
+                continue;
+            }
+            // remove後はmessageが無効になるため、先に取り出す
+            CURL *handle = message->easy_handle;
+            CURLcode curl_code = message->data.result;
+            curl_multi_remove_handle(multi, handle);
+
+            auto it = active.find(handle);
+            if (it == active.end()) {
+                NBLOG(ERROR) << "Unknown transfer completed.";
+                continue;
+            }
+            unique_ptr<Transfer> transfer = std::move(it->second);
+            active.erase(it);
+
+            Finish(*transfer, transfer->executor->CompleteAsyncRequest(curl_code));
+            Recycle(std::move(transfer->executor));
+        }
+    }
+
+    // 帯域制限で一時停止した転送のうち、再開時刻を過ぎたものを再開する
+    // 戻り値は次の再開時刻までの時間(ミリ秒、最大kLoopWaitTimeoutMs)
+    int ResumePaused() {
+        int wait_ms = kLoopWaitTimeoutMs;
+        auto now = std::chrono::steady_clock::now();
+        for (auto &entry : active) {
+            NbRestExecutor *executor = entry.second->executor.get();
+            if (!executor->IsTransferPaused()) {
+                continue;
+            }
+            if (executor->GetResumeTime() <= now) {
+                executor->ResumeTransfer();
+                // 再開直後に再度一時停止した場合は、新しい再開時刻を反映する
+                if (!executor->IsTransferPaused()) {
+                    continue;
+                }
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(executor->GetResumeTime() - now);
+            wait_ms = std::max(0, std::min(wait_ms, static_cast<int>(remaining.count()) + 1));
+        }
+        return wait_ms;
+    }
+
+    // 全転送のキャンセル
+    void CancelAll() {
+        for (auto &entry : active) {
+            curl_multi_remove_handle(multi, entry.first);
+            Finish(*entry.second, NbResult<NbHttpResponse>(NbResultCode::NB_ERROR_CANCELED));
+        }
+        active.clear();
+
+        std::deque<unique_ptr<Transfer>> canceled;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            canceled.swap(pending);
+        }
+        for (auto &transfer : canceled) {
+            Finish(*transfer, NbResult<NbHttpResponse>(NbResultCode::NB_ERROR_CANCELED));
+        }
+    }
+
+    // コールバック呼び出し
+    void Finish(Transfer &transfer, NbResult<NbHttpResponse> result) {
+        if (!transfer.callback) {
+            return;
+        }
+        try {
+            transfer.callback(std::move(result));
+        }
+        catch (...) {
+            // アプリケーションの例外でイベントループを止めない
+            NBLOG(ERROR) << "Exception thrown from async callback.";
+        }
+    }
+
+    // RestExecutorを再利用のため保持する
+    void Recycle(unique_ptr<NbRestExecutor> executor) {
+        if (executor && static_cast<int>(idle_executors.size()) < idle_max) {
+            idle_executors.push_back(std::move(executor));
+        }
+    }
+
+    CURLM *multi{nullptr};                                  /*!< CURLマルチハンドル */
+    int wakeup_pipe[2];                                     /*!< 起床通知用パイプ */
+    std::mutex mutex;                                       /*!< pending, stop, executor_setup 用Mutex */
+    std::deque<unique_ptr<Transfer>> pending;               /*!< 開始待ちの転送 */
+    bool stop{false};                                       /*!< 停止要求 */
+    std::map<CURL *, unique_ptr<Transfer>> active;          /*!< 実行中の転送 */
+    std::vector<unique_ptr<NbRestExecutor>> idle_executors; /*!< 再利用待ちRestExecutor */
+    int idle_max;                                           /*!< 再利用待ちRestExecutorの保持数上限 */
+    std::function<void(NbRestExecutor *)> executor_setup;   /*!< RestExecutor設定関数(mutexで保護) */
+    std::atomic<std::thread::id> loop_thread_id{};          /*!< イベントループスレッドID */
+};
+
+NbRestAsyncEngine::NbRestAsyncEngine(int http_connection_max)
+    : context_(std::make_shared<Context>(http_connection_max)) {}
+
+NbRestAsyncEngine::~NbRestAsyncEngine() {
+    {
+        std::lock_guard<std::mutex> lock(context_->mutex);
+        context_->stop = true;
+    }
+    context_->Wakeup();
+
+    if (loop_thread_.joinable()) {
+        if (loop_thread_.get_id() == std::this_thread::get_id()) {
+            // 完了コールバック内で破棄された場合は自スレッドをjoinできないため切り離す
+            // イベントループは共有データを保持しているため、安全に終了できる
+            loop_thread_.detach();
+        } else {
+            loop_thread_.join();
+        }
+    }
+}
+
+void NbRestAsyncEngine::Submit(const NbHttpRequest &request, int timeout, Callback callback) {
+    unique_ptr<Context::Transfer> transfer(new Context::Transfer(request, timeout, std::move(callback)));
+    {
+        std::lock_guard<std::mutex> lock(context_->mutex);
+        context_->pending.push_back(std::move(transfer));
+        if (!loop_thread_.joinable()) {
+            loop_thread_ = std::thread(&NbRestAsyncEngine::RunLoop, context_);
+        }
+    }
+    context_->Wakeup();
+}
+
+void NbRestAsyncEngine::SetExecutorSetup(std::function<void(NbRestExecutor *)> setup) {
+    std::lock_guard<std::mutex> lock(context_->mutex);
+    context_->executor_setup = std::move(setup);
+}
+
+bool NbRestAsyncEngine::IsLoopThread() const {
+    return context_->loop_thread_id == std::this_thread::get_id();
+}
+
+void NbRestAsyncEngine::RunLoop(shared_ptr<Context> context) {
+    NBLOG(TRACE) << "Async engine loop started.";
+    context->loop_thread_id = std::this_thread::get_id();
+
+    while (true) {
+        std::deque<unique_ptr<Context::Transfer>> submitted;
+        {
+            std::lock_guard<std::mutex> lock(context->mutex);
+            if (context->stop) {
+                break;
+            }
+            submitted.swap(context->pending);
+        }
+
+        for (auto &transfer : submitted) {
+            context->Start(std::move(transfer));
+        }
+
+        if (!context->multi) {
+            // 転送は全てStart()でエラー通知済み。次の登録まで待つ
+            context->DrainWakeup();
+            usleep(kLoopWaitTimeoutMs * 1000);
+            continue;
+        }
+
+        int running = 0;
+        curl_multi_perform(context->multi, &running);
+        context->CollectCompleted();
+        int wait_ms = context->ResumePaused();
+
+        // ソケットのイベント、一時停止した転送の再開時刻、または新規登録・停止要求による起床を待つ
+        curl_waitfd wakeup_fd;
+        wakeup_fd.fd = context->wakeup_pipe[0];
+        wakeup_fd.events = CURL_WAIT_POLLIN;
+        wakeup_fd.revents = 0;
+        int numfds = 0;
+        curl_multi_wait(context->multi, &wakeup_fd, (wakeup_fd.fd >= 0) ? 1 : 0, wait_ms, &numfds);
+        context->DrainWakeup();
+    }
+
+    context->CancelAll();
+    NBLOG(TRACE) << "Async engine loop stopped.";
+}
+}  // namespace necbaas
@@ -3,17 +3,87 @@
  */
 
 #include "necbaas/internal/nb_rest_executor.h"
+#include <algorithm>
 #include <curlpp/Options.hpp>
 #include "necbaas/internal/nb_logger.h"
 #include "necbaas/internal/nb_http_file_upload_handler.h"
 #include "necbaas/internal/nb_http_file_download_handler.h"
+#include "necbaas/internal/nb_http_stream_handler.h"
+#include "necbaas/internal/nb_http_stream_upload_handler.h"
 #include "necbaas/internal/nb_utility.h"
 
 namespace necbaas {
 
 using std::string;
 
-NbRestExecutor::NbRestExecutor() {}
+// 帯域制限時の1回あたりの転送サイズ(100ms分、最小1KB)
+static size_t GetThrottleChunkSize(int64_t rate) {
+    return static_cast<size_t>(std::max<int64_t>(rate / 10, 1024));
+}
+
+// リクエストヘッダの有無(ヘッダ名は大文字小文字を区別しない)
+static bool HasRequestHeader(const NbHttpRequest &request, const string &name) {
+    for (const auto &header : request.GetHeaders()) {
+        size_t colon = header.find(':');
+        if (colon != string::npos && NbUtility::CompareCaseInsensitiveString(header.data(), colon, name)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// 転送情報取得
+static NbTransferInfo GetCurlTransferInfo(CURL *handle) {
+    NbTransferInfo info;
+#if LIBCURL_VERSION_NUM >= 0x073d00
+    // マイクロ秒単位の取得はlibcurl 7.61.0以降で対応
+    const std::pair<CURLINFO, int64_t *> times[] = {
+        {CURLINFO_NAMELOOKUP_TIME_T, &info.name_lookup_time_us},
+        {CURLINFO_CONNECT_TIME_T, &info.connect_time_us},
+        {CURLINFO_APPCONNECT_TIME_T, &info.app_connect_time_us},
+        {CURLINFO_PRETRANSFER_TIME_T, &info.pre_transfer_time_us},
+        {CURLINFO_STARTTRANSFER_TIME_T, &info.start_transfer_time_us},
+        {CURLINFO_TOTAL_TIME_T, &info.total_time_us},
+    };
+    for (const auto &time : times) {
+        curl_off_t value = 0;
+        if (curl_easy_getinfo(handle, time.first, &value) == CURLE_OK) {
+            *time.second = value;
+        }
+    }
+#else
+    const std::pair<CURLINFO, int64_t *> times[] = {
+        {CURLINFO_NAMELOOKUP_TIME, &info.name_lookup_time_us},
+        {CURLINFO_CONNECT_TIME, &info.connect_time_us},
+        {CURLINFO_APPCONNECT_TIME, &info.app_connect_time_us},
+        {CURLINFO_PRETRANSFER_TIME, &info.pre_transfer_time_us},
+        {CURLINFO_STARTTRANSFER_TIME, &info.start_transfer_time_us},
+        {CURLINFO_TOTAL_TIME, &info.total_time_us},
+    };
+    for (const auto &time : times) {
+        double value = 0;
+        if (curl_easy_getinfo(handle, time.first, &value) == CURLE_OK) {
+            *time.second = static_cast<int64_t>(value * 1000000);
+        }
+    }
+#endif
+
+    long request_size = 0;
+    long header_size = 0;
+    curl_off_t upload_size = 0;
+    curl_off_t download_size = 0;
+    curl_easy_getinfo(handle, CURLINFO_REQUEST_SIZE, &request_size);
+    curl_easy_getinfo(handle, CURLINFO_HEADER_SIZE, &header_size);
+    curl_easy_getinfo(handle, CURLINFO_SIZE_UPLOAD_T, &upload_size);
+    curl_easy_getinfo(handle, CURLINFO_SIZE_DOWNLOAD_T, &download_size);
+    info.request_size = request_size;
+    info.response_header_size = header_size;
+    info.upload_size = upload_size;
+    info.download_size = download_size;
+    return info;
+}
+
+NbRestExecutor::NbRestExecutor() : file_download_buffer_size_(kDownloadBufferSize) {}
 NbRestExecutor::~NbRestExecutor() {}
 
 NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileUpload(const NbHttpRequest &request, const string &file_path,
@@ -21,28 +91,20 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileUpload(const NbHttpRequest &
     NBLOG(TRACE) << "Execute file upload: " << file_path;
     request.Dump();
 
-    auto file_size = NbUtility::GetFileSize(file_path);
-
     NbHttpFileUploadHandler http_handler(file_path);
     if (http_handler.IsError()) {
         //ファイルオープン失敗
         NBLOG(ERROR) << "File open error.";
         return MakeResult(http_handler, NbResultCode::NB_ERROR_OPEN_FILE);
     }
+    auto file_size = http_handler.GetFileSize();
 
     try {
+        // 送受信コールバックはSetOptCommon()でhttp_handlerに接続される
         SetOptCommon(request, http_handler, timeout);
 
-        // 送信ファイル読み出しコールバック登録
-        using namespace std::placeholders;
-        curlpp::types::ReadFunctionFunctor data_reader =
-            std::bind(&NbHttpFileUploadHandler::ReadCallback, &http_handler, _1, _2, _3);
-        curlpp_easy_.setOpt(new curlpp::Options::ReadFunction(data_reader));
-
-        // データ受信コールバック登録
-        curlpp::types::WriteFunctionFunctor data_writer =
-            std::bind(&NbHttpFileUploadHandler::WriteCallback, &http_handler, _1, _2, _3);
-        curlpp_easy_.setOpt(new curlpp::Options::WriteFunction(data_writer));
+        // 送信バッファを拡張し、読出しコールバックの呼び出し回数を減らす
+        curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_UPLOAD_BUFFERSIZE, static_cast<long>(kUploadBufferSize));
 
         // create headers
         auto request_headers = request.GetHeaders();
@@ -51,6 +113,9 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileUpload(const NbHttpRequest &
         switch (request.GetMethod()) {
             case NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT:
                 curlpp_easy_.setOpt(new curlpp::Options::Upload(true));
+                // 2GBを超えるサイズにも対応するため、64bitのオプションで指定する
+                curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_INFILESIZE_LARGE,
+                                 static_cast<curl_off_t>(file_size));
 
                 request_headers.push_back(kHeaderContentLength + ": " + std::to_string(file_size));
                 break;
@@ -58,6 +123,9 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileUpload(const NbHttpRequest &
             case NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST:
                 // new file upload
                 curlpp_easy_.setOpt(new curlpp::Options::Post(true));
+                // サイズを指定しない場合、CURLがchunked転送を併用するため指定する
+                curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_POSTFIELDSIZE_LARGE,
+                                 static_cast<curl_off_t>(file_size));
 
                 request_headers.push_back(kHeaderContentLength + ": " + std::to_string(file_size));
                 break;
@@ -104,15 +172,57 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileDownload(const NbHttpRequest
         return MakeResult(http_handler, NbResultCode::NB_ERROR_OPEN_FILE);
     }
 
+    return ExecuteFileDownloadCommon(request, request.GetHeaders(), http_handler, file_path, timeout);
+}
+
+NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileResumeDownload(const NbHttpRequest &request,
+                                                                   const string &file_path, const string &etag,
+                                                                   int timeout) {
+    NBLOG(TRACE) << "Execute file resume download: " << file_path;
+    request.Dump();
+
+    // 既存のファイルの末尾から再開する(試行毎に算出するため、リトライ時も続きから受信する)
+    std::list<string> request_headers = request.GetHeaders();
+    int64_t offset = NbUtility::GetFileSize(file_path);
+    if (offset > 0) {
+        NBLOG(INFO) << "Resume download from offset: " << offset;
+        request_headers.push_back(kHeaderRange + ": bytes=" + std::to_string(offset) + "-");
+        if (!etag.empty()) {
+            // ファイルが更新されている場合は全体を受信する
+            request_headers.push_back(kHeaderIfRange + ": \"" + etag + "\"");
+        }
+    }
+
+    NbResult<NbHttpResponse> response;
+    {
+        NbHttpFileDownloadHandler http_handler(file_path, true);
+        response = ExecuteFileDownloadCommon(request, request_headers, http_handler, file_path, timeout);
+    }
+
+    if (offset > 0 && response.IsRestError() && response.GetRestError().status_code == 416) {
+        // 既存のファイルがサーバのファイル以上のサイズのため、先頭から受信し直す
+        NBLOG(INFO) << "Range not satisfiable, restart download.";
+        NbHttpFileDownloadHandler http_handler(file_path);
+        if (http_handler.IsError()) {
+            NBLOG(ERROR) << "File open error.";
+            return MakeResult(http_handler, NbResultCode::NB_ERROR_OPEN_FILE);
+        }
+        response = ExecuteFileDownloadCommon(request, request.GetHeaders(), http_handler, file_path, timeout);
+    }
+
+    return response;
+}
+
+NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileDownloadCommon(const NbHttpRequest &request,
+                                                                   const std::list<string> &request_headers,
+                                                                   NbHttpFileDownloadHandler &http_handler,
+                                                                   const string &file_path, int timeout) {
+    http_handler.SetWriteBufferSize(std::max(file_download_buffer_size_, 0));
+    http_handler.SetSyncEnabled(file_download_sync_);
     try {
+        // 受信コールバックはSetOptCommon()でhttp_handlerに接続される
         SetOptCommon(request, http_handler, timeout);
 
-        // 受信ファイル書込みコールバック登録
-        using namespace std::placeholders;
-        curlpp::types::WriteFunctionFunctor data_writer =
-            std::bind(&NbHttpFileDownloadHandler::WriteCallback, &http_handler, _1, _2, _3);
-        curlpp_easy_.setOpt(new curlpp::Options::WriteFunction(data_writer));
-
         // ファイルダウンロードはGETのみ
         switch (request.GetMethod()) {
             case NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET:
@@ -126,7 +236,7 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileDownload(const NbHttpRequest
         }
 
         // HTTPヘッダ登録
-        curlpp_easy_.setOpt(new curlpp::Options::HttpHeader(request.GetHeaders()));
+        curlpp_easy_.setOpt(new curlpp::Options::HttpHeader(request_headers));
 
         // HTTPリクエスト実行
         Execute();
@@ -134,7 +244,9 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileDownload(const NbHttpRequest
     catch (const curlpp::LibcurlRuntimeError &ex) {
         int code = static_cast<int>(ex.whatCode());
         NBLOG(ERROR) << "LibcurlRuntimeError error detected code:" << code;
-        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_RUNTIME);
+        // ハンドラが中断した場合(書込みエラー、再開位置の不一致)はダウンロードエラーとする
+        return MakeResult(http_handler, http_handler.IsError() ? NbResultCode::NB_ERROR_FILE_DOWNLOAD
+                                                               : NbResultCode::NB_ERROR_CURL_RUNTIME);
     }
     catch (const curlpp::LibcurlLogicError &ex) {
         int code = static_cast<int>(ex.whatCode());
@@ -148,6 +260,13 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileDownload(const NbHttpRequest
 
     NbResult<NbHttpResponse> response = MakeResult(http_handler, NbResultCode::NB_OK);
 
+    // 書込みバッファの残りをファイルに反映してからサイズを検証する
+    if (response.IsSuccess() && !http_handler.Finish()) {
+        NBLOG(ERROR) << "File write error.";
+        response.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+        return response;
+    }
+
     //ダウンロードしたファイルサイズの検証
     if (response.IsSuccess() && !ValidateFileSize(response.GetSuccessData(), file_path)) {
         NBLOG(ERROR) << "A file size is different.";
@@ -158,18 +277,17 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteFileDownload(const NbHttpRequest
 }
 
 bool NbRestExecutor::ValidateFileSize(const NbHttpResponse &response, const string &file_path) const {
-    int header_value = 0;
+    int64_t header_value = 0;
 
-    auto &headers = response.GetHeaders();
-    auto x_content_length = headers.find(kHeaderXContentLength);
-    if (x_content_length == headers.end()) {
+    string x_content_length;
+    if (!response.GetHeader(kHeaderXContentLength, &x_content_length)) {
         // X-Content-Lengthヘッダは必須
         NBLOG(ERROR) << "There is no X-Content-Length.";
         return false;
     }
-    header_value = std::atoi(x_content_length->second.c_str());
+    header_value = std::strtoll(x_content_length.c_str(), nullptr, 10);
 
-    int file_size = NbUtility::GetFileSize(file_path);
+    int64_t file_size = NbUtility::GetFileSize(file_path);
 
     return (header_value == file_size);
 }
@@ -181,34 +299,145 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteRequest(const NbHttpRequest &req
     NbHttpHandler http_handler;
 
     try {
+        SetOptRequest(request, http_handler, timeout);
+        SetOptAcceptEncoding(request);
+
+        // HTTPリクエスト実行
+        Execute();
+    }
+    catch (const curlpp::LibcurlRuntimeError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlRuntimeError error detected code:" << code;
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_RUNTIME);
+    }
+    catch (const curlpp::LibcurlLogicError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlLogicError error detected code:" << code;
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_LOGIC);
+    }
+    catch (...) {
+        NBLOG(ERROR) << "unexpected error detected";
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_FATAL);
+    }
+
+    return MakeResult(http_handler, NbResultCode::NB_OK);
+}
+
+NbResult<NbHttpResponse> NbRestExecutor::ExecuteStreamRequest(const NbHttpRequest &request,
+                                                              std::function<bool(const char *, size_t)> sink,
+                                                              int timeout) {
+    NBLOG(TRACE) << "Execute stream request.";
+    request.Dump();
+
+    NbHttpStreamHandler http_handler(std::move(sink));
+
+    try {
+        SetOptRequest(request, http_handler, timeout);
+
+        // HTTPリクエスト実行
+        Execute();
+    }
+    catch (const curlpp::LibcurlRuntimeError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlRuntimeError error detected code:" << code;
+        // 出力先の要求による中断
+        if (http_handler.IsAborted()) {
+            return MakeResult(http_handler, NbResultCode::NB_ERROR_CANCELED);
+        }
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_RUNTIME);
+    }
+    catch (const curlpp::LibcurlLogicError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlLogicError error detected code:" << code;
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_LOGIC);
+    }
+    catch (...) {
+        NBLOG(ERROR) << "unexpected error detected";
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_FATAL);
+    }
+
+    return MakeResult(http_handler, NbResultCode::NB_OK);
+}
+
+NbResult<NbHttpResponse> NbRestExecutor::ExecuteStreamUpload(const NbHttpRequest &request,
+                                                             std::function<int64_t(char *, size_t)> producer,
+                                                             int64_t content_length, int timeout) {
+    NBLOG(TRACE) << "Execute stream upload. size:" << content_length;
+    request.Dump();
+
+    NbHttpStreamUploadHandler http_handler(std::move(producer));
+
+    try {
+        // 送受信コールバックはSetOptCommon()でhttp_handlerに接続される
         SetOptCommon(request, http_handler, timeout);
 
-        // データ受信コールバック登録
-        using namespace std::placeholders;
-        curlpp::types::WriteFunctionFunctor data_writer =
-            std::bind(&NbHttpHandler::WriteCallback, &http_handler, _1, _2, _3);
-        curlpp_easy_.setOpt(new curlpp::Options::WriteFunction(data_writer));
+        auto request_headers = request.GetHeaders();
 
+        // アップロードはPUT・POSTのみ
         switch (request.GetMethod()) {
-            case NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET:
-                curlpp_easy_.setOpt(new curlpp::Options::HttpGet(true));
-                break;
             case NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT:
-                curlpp_easy_.setOpt(new curlpp::Options::CustomRequest("PUT"));
-                curlpp_easy_.setOpt(new curlpp::Options::PostFields(request.GetBody()));
-                curlpp_easy_.setOpt(new curlpp::Options::PostFieldSize(request.GetBody().length()));
+                curlpp_easy_.setOpt(new curlpp::Options::Upload(true));
                 break;
+
             case NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST:
                 curlpp_easy_.setOpt(new curlpp::Options::Post(true));
-                curlpp_easy_.setOpt(new curlpp::Options::PostFields(request.GetBody()));
-                curlpp_easy_.setOpt(new curlpp::Options::PostFieldSize(request.GetBody().length()));
-                break;
-            case NbHttpRequestMethod::HTTP_REQUEST_TYPE_DELETE:
-                curlpp_easy_.setOpt(new curlpp::Options::CustomRequest("DELETE"));
                 break;
+
+            default: {
+                NBLOG(ERROR) << "Unexpected request type";
+                return MakeResult(http_handler, NbResultCode::NB_FATAL);
+            }
+        }
+
+        if (content_length >= 0) {
+            // Content-LengthはCURLが付与する
+            CURLoption option = (request.GetMethod() == NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT)
+                                    ? CURLOPT_INFILESIZE_LARGE : CURLOPT_POSTFIELDSIZE_LARGE;
+            curl_easy_setopt(curlpp_easy_.getHandle(), option, static_cast<curl_off_t>(content_length));
+        } else {
+            // サイズ不明の場合はchunked転送(HTTP/2ではCURLがDATAフレームで送信する)
+            request_headers.push_back(kHeaderTransferEncoding + ": " + kHeaderTransferEncodingChunked);
         }
 
         // HTTPヘッダ登録
+        curlpp_easy_.setOpt(new curlpp::Options::HttpHeader(request_headers));
+
+        // HTTPリクエスト実行
+        Execute();
+    }
+    catch (const curlpp::LibcurlRuntimeError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlRuntimeError error detected code:" << code;
+        // 生成関数の要求による中断
+        if (http_handler.IsAborted()) {
+            return MakeResult(http_handler, NbResultCode::NB_ERROR_CANCELED);
+        }
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_RUNTIME);
+    }
+    catch (const curlpp::LibcurlLogicError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlLogicError error detected code:" << code;
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_LOGIC);
+    }
+    catch (...) {
+        NBLOG(ERROR) << "unexpected error detected";
+        return MakeResult(http_handler, NbResultCode::NB_ERROR_CURL_FATAL);
+    }
+
+    return MakeResult(http_handler, NbResultCode::NB_OK);
+}
+
+NbResult<NbHttpResponse> NbRestExecutor::Connect(const NbHttpRequest &request, int timeout) {
+    NBLOG(TRACE) << "Connect: " << request.GetUrl();
+
+    NbHttpHandler http_handler;
+
+    try {
+        // 送受信コールバックはSetOptCommon()でhttp_handlerに接続される
+        SetOptCommon(request, http_handler, timeout);
+
+        // HEADリクエスト(NoBodyは次回リクエストのResetOptRequest()、またはreset()で解除される)
+        curlpp_easy_.setOpt(new curlpp::Options::NoBody(true));
         curlpp_easy_.setOpt(new curlpp::Options::HttpHeader(request.GetHeaders()));
 
         // HTTPリクエスト実行
@@ -232,37 +461,458 @@ NbResult<NbHttpResponse> NbRestExecutor::ExecuteRequest(const NbHttpRequest &req
     return MakeResult(http_handler, NbResultCode::NB_OK);
 }
 
+NbResultCode NbRestExecutor::PrepareAsyncRequest(const NbHttpRequest &request, int timeout) {
+    NBLOG(TRACE) << "Prepare async request.";
+    request.Dump();
+
+    // ハンドラは転送完了(CompleteAsyncRequest)まで保持する
+    async_handler_.reset(new NbHttpHandler());
+    async_transfer_ = true;
+    paused_ = false;
+    resume_time_ = std::chrono::steady_clock::time_point();
+
+    try {
+        SetOptRequest(request, *async_handler_, timeout);
+        SetOptAcceptEncoding(request);
+    }
+    catch (const curlpp::LibcurlRuntimeError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlRuntimeError error detected code:" << code;
+        return NbResultCode::NB_ERROR_CURL_RUNTIME;
+    }
+    catch (const curlpp::LibcurlLogicError &ex) {
+        int code = static_cast<int>(ex.whatCode());
+        NBLOG(ERROR) << "LibcurlLogicError error detected code:" << code;
+        return NbResultCode::NB_ERROR_CURL_LOGIC;
+    }
+    catch (...) {
+        NBLOG(ERROR) << "unexpected error detected";
+        return NbResultCode::NB_ERROR_CURL_FATAL;
+    }
+
+    return NbResultCode::NB_OK;
+}
+
+CURL *NbRestExecutor::GetCurlHandle() const {
+    return curlpp_easy_.getHandle();
+}
+
+NbResult<NbHttpResponse> NbRestExecutor::CompleteAsyncRequest(CURLcode curl_code) {
+    if (!async_handler_) {
+        NBLOG(ERROR) << "Async request is not prepared.";
+        return NbResult<NbHttpResponse>(NbResultCode::NB_FATAL);
+    }
+
+    NbResultCode result_code = NbResultCode::NB_OK;
+    if (curl_code != CURLE_OK) {
+        // 同期実行時のLibcurlRuntimeErrorに相当
+        NBLOG(ERROR) << "LibcurlRuntimeError error detected code:" << static_cast<int>(curl_code);
+        result_code = NbResultCode::NB_ERROR_CURL_RUNTIME;
+    }
+
+    NbResult<NbHttpResponse> result = MakeResult(*async_handler_, result_code);
+    async_handler_.reset();
+    string().swap(async_body_);
+    async_body_paced_ = false;
+    async_transfer_ = false;
+    paused_ = false;
+    return result;
+}
+
+bool NbRestExecutor::IsTransferPaused() const {
+    return paused_;
+}
+
+std::chrono::steady_clock::time_point NbRestExecutor::GetResumeTime() const {
+    return resume_time_;
+}
+
+void NbRestExecutor::ResumeTransfer() {
+    if (!paused_) {
+        return;
+    }
+    paused_ = false;
+    // 再開時に送受信コールバックが呼ばれ、再度一時停止する場合がある
+    curl_easy_pause(curlpp_easy_.getHandle(), CURLPAUSE_CONT);
+}
+
+bool NbRestExecutor::PauseIfWaiting() {
+    if (std::chrono::steady_clock::now() >= resume_time_) {
+        return false;
+    }
+    paused_ = true;
+    return true;
+}
+
+void NbRestExecutor::ReserveBandwidth(NbTokenBucket &limiter, int64_t size) {
+    int64_t wait = limiter.Reserve(size);
+    if (wait > 0) {
+        resume_time_ = std::chrono::steady_clock::now() + std::chrono::milliseconds(wait);
+    }
+}
+
+void NbRestExecutor::SetOptRequest(const NbHttpRequest &request, NbHttpHandler &http_handler, int timeout) {
+    // 受信コールバックはSetOptCommon()でhttp_handlerに接続される
+    SetOptCommon(request, http_handler, timeout);
+
+    auto request_headers = request.GetHeaders();
+    const string *body = &request.GetBody();
+    string compressed_body;
+
+    switch (request.GetMethod()) {
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET:
+            curlpp_easy_.setOpt(new curlpp::Options::HttpGet(true));
+            break;
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT:
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST:
+            request_body_size_ = body->size();
+            if (IsRequestCompressionTarget(request) && NbUtility::GzipCompress(*body, &compressed_body)) {
+                body = &compressed_body;
+                request_headers.push_back(kHeaderContentEncoding + ": " + kHeaderContentEncodingGzip);
+            }
+            if (request.GetMethod() == NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT) {
+                curlpp_easy_.setOpt(new curlpp::Options::CustomRequest("PUT"));
+            } else {
+                curlpp_easy_.setOpt(new curlpp::Options::Post(true));
+            }
+            if (upload_limiter_ && async_transfer_) {
+                // 非同期実行ではイベントループで待機できないため、ボディを送信コールバックで分割して送信し、
+                // 帯域不足時は一時停止する
+                async_body_.assign(*body);
+                async_body_offset_ = 0;
+                async_body_paced_ = true;
+                curlpp_easy_.setOpt(new curlpp::Options::Post(true));
+                curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_POSTFIELDSIZE_LARGE,
+                                 static_cast<curl_off_t>(body->size()));
+                // 再送時(接続切断等)はボディの先頭から送信し直す
+                curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_SEEKFUNCTION, &NbRestExecutor::SeekCallback);
+                curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_SEEKDATA, this);
+                // 100-continueの待ち合わせを行わない
+                request_headers.push_back("Expect:");
+                break;
+            }
+            if (upload_limiter_) {
+                // POSTFIELDSは送信コールバックを経由しないため、送信前に取得する
+                upload_limiter_->Acquire(body->size());
+            }
+            curlpp_easy_.setOpt(new curlpp::Options::PostFields(*body));
+            curlpp_easy_.setOpt(new curlpp::Options::PostFieldSize(body->length()));
+            break;
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_DELETE:
+            curlpp_easy_.setOpt(new curlpp::Options::CustomRequest("DELETE"));
+            break;
+    }
+
+    // HTTPヘッダ登録
+    curlpp_easy_.setOpt(new curlpp::Options::HttpHeader(request_headers));
+}
+
+void NbRestExecutor::SetOptAcceptEncoding(const NbHttpRequest &request) {
+    // 応答圧縮(CURLが対応する全方式を提示し、受信データは自動で展開される)
+    // Range指定時は範囲が圧縮後のデータに対するものとなるため、ファイルダウンロードと同様に使用しない
+    if (response_compression_ && !HasRequestHeader(request, kHeaderRange)) {
+        curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_ACCEPT_ENCODING, "");
+    }
+}
+
+bool NbRestExecutor::IsRequestCompressionTarget(const NbHttpRequest &request) const {
+    // 呼び出し元が圧縮対象に設定したリクエストのみ(サーバが圧縮を受け付けるAPIに限る)
+    return request.IsBodyCompressible() && request_compression_threshold_ > 0 &&
+           request.GetBody().size() >= static_cast<size_t>(request_compression_threshold_);
+}
+
 void NbRestExecutor::SetOptCommon(const NbHttpRequest &request, NbHttpHandler &http_handler, int timeout) {
-    // CURLオプションリセット
-    curlpp_easy_.reset();
+    // 送受信コールバックの転送先
+    current_handler_ = &http_handler;
+    async_body_paced_ = false;
+    request_body_size_ = 0;
+    read_size_ = 0;
+    write_size_ = 0;
+
+    int curl_timeout = (timeout < 0 ? kRestTimeoutDefault : timeout);
+
+    if (!connection_reuse_ || !persistent_options_set_) {
+        // CURLオプションリセット
+        curlpp_easy_.reset();
+        SetOptPersistent();
+        persistent_options_set_ = connection_reuse_;
+    } else {
+        // 前回リクエストのHTTPメソッド関連オプションを初期状態に戻す
+        ResetOptRequest();
+    }
 
     // URL
     curlpp_easy_.setOpt(new curlpp::Options::Url(request.GetUrl()));
 
-    // HTTPヘッダ受信コールバック登録
+    // 接続再利用モードでは、Proxy・タイムアウトは変更があった場合のみ再設定する
+    if (!connection_reuse_ || request.GetProxy() != current_proxy_ || curl_timeout != current_timeout_) {
+        // Proxy設定
+        // 空文字でも設定する(明示的にProxy未使用)
+        curlpp_easy_.setOpt(new curlpp::Options::Proxy(request.GetProxy()));
+
+        // タイムアウト設定
+        curlpp_easy_.setOpt(new curlpp::Options::Timeout(curl_timeout));
+
+        current_proxy_ = request.GetProxy();
+        current_timeout_ = curl_timeout;
+    }
+
+    // 帯域制限中は受信バッファを縮小し、受信コールバック1回あたりの待機時間を短くする
+    long receive_buffer_size = CURL_MAX_WRITE_SIZE;
+    if (download_limiter_) {
+        int64_t rate = download_limiter_->GetRate();
+        if (rate > 0) {
+            receive_buffer_size = std::min<long>(GetThrottleChunkSize(rate), CURL_MAX_WRITE_SIZE);
+        }
+    }
+    curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_BUFFERSIZE, receive_buffer_size);
+
+    // CURLログ設定
+    curlpp_easy_.setOpt(new curlpp::Options::Verbose(NbLogger::IsDebugLogEnabled()));
+}
+
+void NbRestExecutor::SetOptPersistent() {
+    // 送受信コールバック登録
+    // 転送先はcurrent_handler_のため、リクエスト毎の再登録は不要
     using namespace std::placeholders;
     curlpp::types::WriteFunctionFunctor header_writer =
-        std::bind(&NbHttpHandler::WriteHeaderCallback, &http_handler, _1, _2, _3);
+        std::bind(&NbRestExecutor::WriteHeaderCallback, this, _1, _2, _3);
     curlpp_easy_.setOpt(new curlpp::Options::HeaderFunction(header_writer));
 
-    // Proxy設定
-    // 空文字でも設定する(明示的にProxy未使用)
-    curlpp_easy_.setOpt(new curlpp::Options::Proxy(request.GetProxy()));
+    curlpp::types::WriteFunctionFunctor data_writer =
+        std::bind(&NbRestExecutor::WriteCallback, this, _1, _2, _3);
+    curlpp_easy_.setOpt(new curlpp::Options::WriteFunction(data_writer));
+
+    curlpp::types::ReadFunctionFunctor data_reader =
+        std::bind(&NbRestExecutor::ReadCallback, this, _1, _2, _3);
+    curlpp_easy_.setOpt(new curlpp::Options::ReadFunction(data_reader));
 
-    // タイムアウト設定
-    curlpp_easy_.setOpt(new curlpp::Options::Timeout(timeout < 0 ? kRestTimeoutDefault : timeout));
     // タイムアウト用にシグナルは使用しない
     curlpp_easy_.setOpt(new curlpp::Options::NoSignal(true));
 
-    // CURLログ設定
-    curlpp_easy_.setOpt(new curlpp::Options::Verbose(NbLogger::IsDebugLogEnabled()));
+    // 転送中断要求の確認
+    curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_XFERINFOFUNCTION, &NbRestExecutor::ProgressCallback);
+    curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_XFERINFODATA, this);
+    curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_NOPROGRESS, 0L);
+
+    if (connection_reuse_) {
+        // アイドル中の接続をTCP keep-aliveで維持する
+        curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_TCP_KEEPALIVE, 1L);
+    }
+
+    // 共有キャッシュ(未設定の場合は共有を解除する)
+    curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_SHARE, curl_share_ ? curl_share_->GetHandle() : nullptr);
+
+    if (http2_) {
+        // HTTP/2はTLS接続時のみ使用し、非対応サーバではHTTP/1.1にフォールバックする
+        curlpp_easy_.setOpt(new curlpp::Options::HttpVersion(CURL_HTTP_VERSION_2TLS));
+        // マルチハンドル実行時に、新規接続より既存接続への多重化を優先する
+        curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_PIPEWAIT, 1L);
+    }
+}
+
+void NbRestExecutor::ResetOptRequest() {
+    CURL *handle = curlpp_easy_.getHandle();
+    curl_easy_setopt(handle, CURLOPT_CUSTOMREQUEST, static_cast<char *>(nullptr));
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDS, static_cast<char *>(nullptr));
+    curl_easy_setopt(handle, CURLOPT_POSTFIELDSIZE, -1L);
+    curl_easy_setopt(handle, CURLOPT_INFILESIZE, -1L);
+    curl_easy_setopt(handle, CURLOPT_UPLOAD, 0L);
+    curl_easy_setopt(handle, CURLOPT_SEEKFUNCTION, static_cast<curl_seek_callback>(nullptr));
+    curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, static_cast<char *>(nullptr));
+    // HTTPGETはPOST, NOBODYも解除する
+    curl_easy_setopt(handle, CURLOPT_HTTPGET, 1L);
+}
+
+size_t NbRestExecutor::WriteHeaderCallback(char *buffer, size_t size, size_t nmemb) {
+    return current_handler_->WriteHeaderCallback(buffer, size, nmemb);
+}
+
+size_t NbRestExecutor::WriteCallback(char *buffer, size_t size, size_t nmemb) {
+    if (download_limiter_ && async_transfer_ && PauseIfWaiting()) {
+        // 一時停止中のデータは、再開時に同じ内容で再度通知される
+        return CURL_WRITEFUNC_PAUSE;
+    }
+    size_t written = current_handler_->WriteCallback(buffer, size, nmemb);
+    write_size_ += written;
+    if (download_limiter_) {
+        if (async_transfer_) {
+            ReserveBandwidth(*download_limiter_, written);
+        } else {
+            download_limiter_->Acquire(written);
+        }
+    }
+    return written;
+}
+
+size_t NbRestExecutor::ReadCallback(char *buffer, size_t size, size_t nmemb) {
+    if (upload_limiter_ && async_transfer_ && PauseIfWaiting()) {
+        return CURL_READFUNC_PAUSE;
+    }
+    if (upload_limiter_ && size > 0) {
+        // 帯域制限中は1回に読出すサイズを制限する
+        int64_t rate = upload_limiter_->GetRate();
+        if (rate > 0) {
+            nmemb = std::min(nmemb, std::max<size_t>(GetThrottleChunkSize(rate) / size, 1));
+        }
+    }
+    size_t read = 0;
+    if (async_body_paced_) {
+        // 非同期実行のボディ(送信サイズはrequest_body_size_で計上済み)
+        read = std::min(size * nmemb, async_body_.size() - async_body_offset_);
+        async_body_.copy(buffer, read, async_body_offset_);
+        async_body_offset_ += read;
+    } else {
+        read = current_handler_->ReadCallback(buffer, size, nmemb);
+    }
+    // CURL_READFUNC_ABORT/PAUSEは送信サイズに含めない
+    if (read <= size * nmemb) {
+        if (!async_body_paced_) {
+            read_size_ += read;
+        }
+        if (upload_limiter_) {
+            if (async_transfer_) {
+                ReserveBandwidth(*upload_limiter_, read);
+            } else {
+                upload_limiter_->Acquire(read);
+            }
+        }
+    }
+    return read;
+}
+
+int NbRestExecutor::SeekCallback(void *userptr, curl_off_t offset, int origin) {
+    NbRestExecutor *executor = static_cast<NbRestExecutor *>(userptr);
+    if (origin != SEEK_SET || offset < 0 || static_cast<size_t>(offset) > executor->async_body_.size()) {
+        return CURL_SEEKFUNC_CANTSEEK;
+    }
+    executor->async_body_offset_ = static_cast<size_t>(offset);
+    return CURL_SEEKFUNC_OK;
+}
+
+int NbRestExecutor::ProgressCallback(void *userptr, curl_off_t dltotal, curl_off_t dlnow,
+                                     curl_off_t ultotal, curl_off_t ulnow) {
+    NbRestExecutor *executor = static_cast<NbRestExecutor *>(userptr);
+    return executor->cancel_requested_ ? 1 : 0;
+}
+
+void NbRestExecutor::Cancel() {
+    cancel_requested_ = true;
+}
+
+void NbRestExecutor::ClearCancel() {
+    cancel_requested_ = false;
+}
+
+bool NbRestExecutor::IsConnectionReuse() const {
+    return connection_reuse_;
+}
+
+void NbRestExecutor::SetConnectionReuse(bool reuse) {
+    if (reuse != connection_reuse_) {
+        connection_reuse_ = reuse;
+        // 次回リクエストでオプションを再構築する
+        persistent_options_set_ = false;
+    }
+}
+
+const std::shared_ptr<NbCurlShare> &NbRestExecutor::GetCurlShare() const {
+    return curl_share_;
+}
+
+void NbRestExecutor::SetCurlShare(std::shared_ptr<NbCurlShare> share) {
+    if (share != curl_share_) {
+        // 旧キャッシュを解放する前にCURLハンドルから切り離す(curl_easy_reset()では切り離されない)
+        curl_easy_setopt(curlpp_easy_.getHandle(), CURLOPT_SHARE, static_cast<CURLSH *>(nullptr));
+        curl_share_ = std::move(share);
+        // 次回リクエストでオプションを再構築する
+        persistent_options_set_ = false;
+    }
+}
+
+bool NbRestExecutor::IsResponseCompression() const {
+    return response_compression_;
+}
+
+void NbRestExecutor::SetResponseCompression(bool compression) {
+    response_compression_ = compression;
+}
+
+int NbRestExecutor::GetRequestCompressionThreshold() const {
+    return request_compression_threshold_;
+}
+
+void NbRestExecutor::SetRequestCompressionThreshold(int threshold) {
+    request_compression_threshold_ = threshold;
+}
+
+int NbRestExecutor::GetFileDownloadBufferSize() const {
+    return file_download_buffer_size_;
+}
+
+void NbRestExecutor::SetFileDownloadBufferSize(int size) {
+    file_download_buffer_size_ = size;
+}
+
+bool NbRestExecutor::IsFileDownloadSync() const {
+    return file_download_sync_;
+}
+
+void NbRestExecutor::SetFileDownloadSync(bool sync) {
+    file_download_sync_ = sync;
+}
+
+const std::shared_ptr<NbTokenBucket> &NbRestExecutor::GetUploadLimiter() const {
+    return upload_limiter_;
+}
+
+const std::shared_ptr<NbTokenBucket> &NbRestExecutor::GetDownloadLimiter() const {
+    return download_limiter_;
+}
+
+void NbRestExecutor::SetBandwidthLimiter(std::shared_ptr<NbTokenBucket> upload,
+                                         std::shared_ptr<NbTokenBucket> download) {
+    upload_limiter_ = std::move(upload);
+    download_limiter_ = std::move(download);
+}
+
+bool NbRestExecutor::IsHttp2() const {
+    return http2_;
+}
+
+void NbRestExecutor::SetHttp2(bool http2) {
+    if (http2 != http2_) {
+        http2_ = http2;
+        // 次回リクエストでオプションを再構築する
+        persistent_options_set_ = false;
+    }
 }
 
 NbResult<NbHttpResponse> NbRestExecutor::MakeResult(NbHttpHandler &http_handler, NbResultCode result_code) {
+    // 中断要求による転送エラー
+    if (result_code == NbResultCode::NB_ERROR_CURL_RUNTIME && cancel_requested_) {
+        result_code = NbResultCode::NB_ERROR_CANCELED;
+    }
     NbResult<NbHttpResponse> result(result_code);
 
     NbHttpResponse response = http_handler.Parse();
 
+    // 新規接続数が0の場合は、既存の接続を再利用している
+    long connects = 0;
+    if (response.GetStatusCode() != 0 &&
+        curl_easy_getinfo(curlpp_easy_.getHandle(), CURLINFO_NUM_CONNECTS, &connects) == CURLE_OK) {
+        response.SetConnectionReused(connects == 0);
+    }
+
+    // 転送情報はエラー時も設定する
+    NbTransferInfo transfer_info = GetCurlTransferInfo(curlpp_easy_.getHandle());
+    result.SetTransferInfo(transfer_info);
+    response.SetTransferInfo(transfer_info);
+
+    // 送受信サイズ(転送サイズはCURLが計測した圧縮状態のボディサイズ)
+    response.SetTransferSize(request_body_size_ + read_size_, transfer_info.upload_size,
+                             write_size_, transfer_info.download_size);
+
     // エラーが発生していてもステータスコードを受信している場合はRestErrorに上書きする
     // ただし、ステータスコードが300未満の場合はFatalエラーを優先する。
     if (result.IsFatalError() && response.GetStatusCode() < 300) {
@@ -271,7 +921,7 @@ NbResult<NbHttpResponse> NbRestExecutor::MakeResult(NbHttpHandler &http_handler,
     }
 
     response.Dump();
-    result.SetSuccessData(response);
+    result.SetSuccessData(std::move(response));
 
     // ステータスコード取得失敗の場合は、不正レスポンス
     if (result.GetSuccessData().GetStatusCode() == 0) {
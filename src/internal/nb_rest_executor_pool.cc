@@ -3,43 +3,187 @@
  */
 
 #include "necbaas/internal/nb_rest_executor_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <functional>
 #include "necbaas/internal/nb_logger.h"
 
 namespace necbaas {
 
 using std::string;
 
-NbRestExecutorPool::NbRestExecutorPool(int http_connection_max) : creatable_num_(http_connection_max) {}
+// シャード数の上限
+static const unsigned int kShardMax = 16;
+
+NbRestExecutorPool::NbRestExecutorPool(int http_connection_max) : creatable_num_(http_connection_max) {
+    // シャード数はCPU数とし、HTTP同時接続数最大値・上限値を超えないようにする
+    unsigned int shard_num = std::min(std::max(std::thread::hardware_concurrency(), 1u), kShardMax);
+    if (http_connection_max > 0) {
+        shard_num = std::min(shard_num, static_cast<unsigned int>(http_connection_max));
+    }
+    shard_num_ = shard_num;
+    shards_.reset(new Shard[shard_num_]);
+}
 
 NbRestExecutorPool::~NbRestExecutorPool() {
-    NbRestExecutor *rest_executor;
-    while (!idle_stack_.empty()) {
-        rest_executor = idle_stack_.top();
-        idle_stack_.pop();
-        delete rest_executor;
+    for (size_t i = 0; i < shard_num_; ++i) {
+        for (auto rest_executor : shards_[i].idle) {
+            delete rest_executor;
+        }
     }
 }
 
 NbRestExecutor *NbRestExecutorPool::PopRestExecutor() {
-    std::lock_guard<std::mutex> lock(stack_mutex_);
+    return PopRestExecutor(0);
+}
+
+NbRestExecutor *NbRestExecutorPool::PopRestExecutor(int wait_timeout) {
     NbRestExecutor *rest_executor = nullptr;
-    if (idle_stack_.empty()) {
-        if (creatable_num_ > 0) {
-            rest_executor = new NbRestExecutor();
-            --creatable_num_;
-        } else {
-            NBLOG(ERROR) << "HTTP Connection Over";
-        }
+    // 先に待ち合わせているスレッドがある場合は追い越さない
+    if (waiter_num_ == 0) {
+        rest_executor = TakeIdleRestExecutor();
+    }
+    if (!rest_executor) {
+        rest_executor = CreateRestExecutor();
+    }
+    if (!rest_executor && wait_timeout > 0) {
+        rest_executor = WaitRestExecutor(wait_timeout);
+    }
+
+    // 統計情報はシャード毎に集計し、スレッド間でキャッシュラインを共有しない
+    Shard &shard = GetShard();
+    if (rest_executor) {
+        shard.acquired_count.fetch_add(1, std::memory_order_relaxed);
     } else {
-        rest_executor = idle_stack_.top();
-        idle_stack_.pop();
+        shard.failed_count.fetch_add(1, std::memory_order_relaxed);
+        NBLOG(ERROR) << "HTTP Connection Over";
     }
 
     return rest_executor;
 }
 
+NbRestExecutor *NbRestExecutorPool::TryPopRestExecutor() {
+    NbRestExecutor *rest_executor = nullptr;
+    // 先に待ち合わせているスレッドがある場合は追い越さない
+    if (waiter_num_ == 0) {
+        rest_executor = TakeIdleRestExecutor();
+    }
+    if (!rest_executor) {
+        rest_executor = CreateRestExecutor();
+    }
+
+    if (rest_executor) {
+        GetShard().acquired_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return rest_executor;
+}
+
 void NbRestExecutorPool::PushRestExecutor(NbRestExecutor *rest_executor) {
-    std::lock_guard<std::mutex> lock(stack_mutex_);
-    idle_stack_.push(rest_executor);
+    bool waiting;
+    {
+        Shard &shard = GetShard();
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.idle.push_back(rest_executor);
+        // シャードのロック中に確認し、待ち合わせ登録直後の取りこぼしを防ぐ
+        waiting = (waiter_num_ > 0);
+    }
+
+    if (waiting) {
+        std::lock_guard<std::mutex> lock(waiter_mutex_);
+        HandOverToWaiters();
+    }
+}
+
+NbRestExecutorPoolStatistics NbRestExecutorPool::GetStatistics() {
+    std::lock_guard<std::mutex> lock(waiter_mutex_);
+    NbRestExecutorPoolStatistics statistics = wait_statistics_;
+    for (size_t i = 0; i < shard_num_; ++i) {
+        statistics.acquired_count += shards_[i].acquired_count;
+        statistics.failed_count += shards_[i].failed_count;
+    }
+    return statistics;
+}
+
+NbRestExecutorPool::Shard &NbRestExecutorPool::GetShard() {
+    return shards_[std::hash<std::thread::id>()(std::this_thread::get_id()) % shard_num_];
+}
+
+NbRestExecutor *NbRestExecutorPool::TakeIdleRestExecutor() {
+    Shard *own = &GetShard();
+    {
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (!own->idle.empty()) {
+            NbRestExecutor *rest_executor = own->idle.back();
+            own->idle.pop_back();
+            return rest_executor;
+        }
+    }
+
+    for (size_t i = 0; i < shard_num_; ++i) {
+        Shard &shard = shards_[i];
+        if (&shard == own) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (!shard.idle.empty()) {
+            NbRestExecutor *rest_executor = shard.idle.back();
+            shard.idle.pop_back();
+            return rest_executor;
+        }
+    }
+    return nullptr;
+}
+
+NbRestExecutor *NbRestExecutorPool::CreateRestExecutor() {
+    int creatable = creatable_num_;
+    while (creatable > 0) {
+        if (creatable_num_.compare_exchange_weak(creatable, creatable - 1)) {
+            return new NbRestExecutor();
+        }
+    }
+    return nullptr;
+}
+
+NbRestExecutor *NbRestExecutorPool::WaitRestExecutor(int wait_timeout) {
+    std::unique_lock<std::mutex> lock(waiter_mutex_);
+    auto start = std::chrono::steady_clock::now();
+    Waiter waiter;
+    waiters_.push_back(&waiter);
+    ++waiter_num_;
+
+    // 登録前に返却されたRestExecutorを引き渡す
+    HandOverToWaiters();
+
+    waiter.cond.wait_until(lock, start + std::chrono::milliseconds(wait_timeout),
+                           [&waiter] { return waiter.rest_executor != nullptr; });
+    if (!waiter.rest_executor) {
+        // タイムアウト時はキューから自身を取り除く
+        waiters_.erase(std::find(waiters_.begin(), waiters_.end(), &waiter));
+        --waiter_num_;
+    }
+
+    uint64_t wait_time_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    ++wait_statistics_.waited_count;
+    wait_statistics_.total_wait_time_us += wait_time_us;
+    wait_statistics_.max_wait_time_us = std::max(wait_statistics_.max_wait_time_us, wait_time_us);
+
+    return waiter.rest_executor;
+}
+
+void NbRestExecutorPool::HandOverToWaiters() {
+    while (!waiters_.empty()) {
+        NbRestExecutor *rest_executor = TakeIdleRestExecutor();
+        if (!rest_executor) {
+            break;
+        }
+        // 先頭の待ち合わせに直接引き渡す
+        Waiter *waiter = waiters_.front();
+        waiters_.pop_front();
+        --waiter_num_;
+        waiter->rest_executor = rest_executor;
+        waiter->cond.notify_one();
+    }
 }
 }  // namespace necbaas
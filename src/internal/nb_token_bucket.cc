@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/internal/nb_token_bucket.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace necbaas {
+
+NbTokenBucket::NbTokenBucket() : last_refill_(std::chrono::steady_clock::now()) {}
+
+int64_t NbTokenBucket::GetRate() const {
+    return rate_;
+}
+
+void NbTokenBucket::SetRate(int64_t rate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Refill();
+    if (rate <= 0) {
+        rate_ = 0;
+        tokens_ = 0;
+        return;
+    }
+    if (rate_ == 0) {
+        // 制限なしからの変更では1秒分を蓄積した状態から開始する
+        tokens_ = static_cast<double>(rate);
+    } else {
+        tokens_ = std::min(tokens_, static_cast<double>(rate));
+    }
+    rate_ = rate;
+}
+
+bool NbTokenBucket::IsLimited() const {
+    return rate_ > 0;
+}
+
+void NbTokenBucket::Acquire(int64_t tokens) {
+    if (rate_ <= 0 || tokens <= 0) {
+        return;
+    }
+    double wait_sec;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Refill();
+        if (rate_ <= 0) {
+            return;
+        }
+        tokens_ -= tokens;
+        if (tokens_ >= 0) {
+            return;
+        }
+        wait_sec = -tokens_ / rate_.load();
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(wait_sec));
+}
+
+int64_t NbTokenBucket::Reserve(int64_t tokens) {
+    if (rate_ <= 0 || tokens <= 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    Refill();
+    int64_t rate = rate_;
+    if (rate <= 0) {
+        return 0;
+    }
+    tokens_ -= tokens;
+    if (tokens_ >= 0) {
+        return 0;
+    }
+    // 1ミリ秒未満の不足分も切り上げ、補充前に次の転送を行わないようにする
+    return static_cast<int64_t>(std::ceil(-tokens_ * 1000 / rate));
+}
+
+void NbTokenBucket::Refill() {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed_sec = std::chrono::duration<double>(now - last_refill_).count();
+    last_refill_ = now;
+    int64_t rate = rate_;
+    if (rate > 0) {
+        tokens_ = std::min(tokens_ + elapsed_sec * rate, static_cast<double>(rate));
+    }
+}
+} //namespace necbaas
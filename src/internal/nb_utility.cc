@@ -3,7 +3,9 @@
  */
 
 #include "necbaas/internal/nb_utility.h"
+#include <sys/stat.h>
 #include <fstream>
+#include <zlib.h>
 #include "necbaas/internal/nb_logger.h"
 
 namespace necbaas {
@@ -40,18 +42,14 @@ string TmToDateString(const std::tm &time) {
     return time_string;
 }
 
-int GetFileSize(const std::string &file_name) {
-    std::ifstream file_stream(file_name, std::ios::ate | std::ios::binary);
-    if (!file_stream) {
+int64_t GetFileSize(const std::string &file_name) {
+    struct stat file_stat;
+    if (stat(file_name.c_str(), &file_stat) != 0) {
         // ファイルオープンエラー
         NBLOG(ERROR) << "File open error.";
         return 0;
     }
-    file_stream.seekg(0, std::fstream::end);
-    auto eof_pos = file_stream.tellg();
-    file_stream.seekg(0, std::fstream::beg);
-    auto beg_pos = file_stream.tellg();
-    return (int)(eof_pos - beg_pos);
+    return static_cast<int64_t>(file_stat.st_size);
 }
 
 NbJsonType ConvertJsonType(Json::ValueType json_type) {
@@ -79,5 +77,41 @@ bool CompareCaseInsensitiveString(std::string str1, std::string str2) {
     std::transform(str2.begin(), str2.end(), str2.begin(), ::tolower);
     return (str1 == str2);
 }
+
+bool CompareCaseInsensitiveString(const char *str1, size_t length1, const std::string &str2) {
+    if (length1 != str2.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < length1; ++i) {
+        if (::tolower(static_cast<unsigned char>(str1[i])) != ::tolower(static_cast<unsigned char>(str2[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool GzipCompress(const string &data, string *compressed) {
+    z_stream stream{};
+    // windowBitsに16を加算するとgzip形式で出力する
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        NBLOG(ERROR) << "deflateInit2 error.";
+        return false;
+    }
+
+    compressed->resize(deflateBound(&stream, data.size()));
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    stream.avail_in = data.size();
+    stream.next_out = reinterpret_cast<Bytef *>(&(*compressed)[0]);
+    stream.avail_out = compressed->size();
+
+    int ret = deflate(&stream, Z_FINISH);
+    deflateEnd(&stream);
+    if (ret != Z_STREAM_END) {
+        NBLOG(ERROR) << "deflate error: " << ret;
+        return false;
+    }
+    compressed->resize(stream.total_out);
+    return true;
+}
 }  // namespace NbUtility
 }  // namespace necbaas
@@ -3,6 +3,8 @@
  */
 
 #include "necbaas/nb_api_gateway.h"
+#include <unistd.h>
+#include <cerrno>
 #include "necbaas/internal/nb_utility.h"
 #include "necbaas/internal/nb_logger.h"
 
@@ -23,70 +25,161 @@ NbApiGateway::~NbApiGateway() {}
 NbResult<NbHttpResponse> NbApiGateway::ExecuteCustomApi(const std::string &body) {
     NBLOG(TRACE) << __func__;
 
-    NbResult<NbHttpResponse> result;
+    NbResultCode result_code = CheckRequest(!body.empty());
+    if (result_code != NbResultCode::NB_OK) {
+        return NbResult<NbHttpResponse>(result_code);
+    }
+
+    return service_->ExecuteRequest(
+        [this, &body](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateRequest(body, &request_factory);
+        }, timeout_, NbOperation::CUSTOM_API);
+}
+
+NbResult<NbHttpResponse> NbApiGateway::ExecuteCustomApi(const std::vector<char> &body) {
+    string body_string(body.begin(), body.end());
+    return ExecuteCustomApi(body_string);
+}
+
+NbResult<NbHttpResponse> NbApiGateway::ExecuteCustomApi(const std::string &body, ResponseSink sink) {
+    NBLOG(TRACE) << __func__;
+
+    NbResultCode result_code = CheckRequest(!body.empty());
+    if (result_code != NbResultCode::NB_OK) {
+        return NbResult<NbHttpResponse>(result_code);
+    }
+
+    return service_->ExecuteStreamRequest(
+        [this, &body](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateRequest(body, &request_factory);
+        }, std::move(sink), timeout_, NbOperation::CUSTOM_API);
+}
+
+NbResult<NbHttpResponse> NbApiGateway::ExecuteCustomApi(const std::string &body, int fd) {
+    return ExecuteCustomApi(body, [fd](const char *data, size_t size) -> bool {
+        while (size > 0) {
+            ssize_t written = write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                NBLOG(ERROR) << "write error errno:" << errno;
+                return false;
+            }
+            data += written;
+            size -= written;
+        }
+        return true;
+    });
+}
+
+NbResult<NbHttpResponse> NbApiGateway::ExecuteCustomApi(RequestProducer producer, int64_t content_length) {
+    NBLOG(TRACE) << __func__;
+
+    if (http_method_ != NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST &&
+        http_method_ != NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT) {
+        // ボディを送信しないメソッドはproducerを使用しない
+        return ExecuteCustomApi(string());
+    }
+
+    NbResultCode result_code = CheckRequest(true);
+    if (result_code != NbResultCode::NB_OK) {
+        return NbResult<NbHttpResponse>(result_code);
+    }
+
+    return service_->ExecuteStreamUpload(
+        [this](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateRequest(string(), &request_factory, true);
+        }, std::move(producer), content_length, timeout_, NbOperation::CUSTOM_API);
+}
+
+std::future<NbResult<NbHttpResponse>> NbApiGateway::ExecuteCustomApiAsync(const std::string &body,
+                                                                          AsyncCallback callback) {
+    NBLOG(TRACE) << __func__;
+
+    NbAsyncResult<NbHttpResponse> async_result(callback);
+    std::future<NbResult<NbHttpResponse>> future = async_result.GetFuture();
+
+    NbResultCode result_code = CheckRequest(!body.empty());
+    if (result_code != NbResultCode::NB_OK) {
+        async_result.Complete(NbResult<NbHttpResponse>(result_code));
+        return future;
+    }
 
+    service_->ExecuteRequestAsync(
+        [this, &body](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateRequest(body, &request_factory);
+        }, timeout_,
+        [async_result](NbResult<NbHttpResponse> rest_result) {
+            async_result.Complete(rest_result);
+        }, NbOperation::CUSTOM_API);
+    return future;
+}
+
+std::future<NbResult<NbHttpResponse>> NbApiGateway::ExecuteCustomApiAsync(const std::vector<char> &body,
+                                                                          AsyncCallback callback) {
+    string body_string(body.begin(), body.end());
+    return ExecuteCustomApiAsync(body_string, callback);
+}
+
+NbResultCode NbApiGateway::CheckRequest(bool has_body) {
     if (api_name_.empty()) {
         //エラー処理
-        result.SetResultCode(NbResultCode::NB_ERROR_API_NAME);
         NBLOG(ERROR) << "Api name is empty.";
-        return result;
+        return NbResultCode::NB_ERROR_API_NAME;
     }
 
     //Content-Typeのチェック
-    if (!CheckContentType(body)) {
+    if (!CheckContentType(has_body)) {
         //エラー処理
-        result.SetResultCode(NbResultCode::NB_ERROR_CONTENT_TYPE);
         NBLOG(ERROR) << "Content-Type is empty.";
-        return result;
+        return NbResultCode::NB_ERROR_CONTENT_TYPE;
     }
 
-    return service_->ExecuteRequest(
-        [this, &body](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
-            switch (http_method_) {
-                case NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET:
-                    request_factory.Get(kApigwUrl)
-                                   .Params(parameters_)
-                                   .Headers(headers_);
-                    break;
-                case NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST:
-                    request_factory.Post(kApigwUrl)
-                                   .Headers(headers_)
-                                   .Body(body);
-                    AppendContentType(body, &request_factory);
-                    break;
-                case NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT:
-                    request_factory.Put(kApigwUrl)
-                                   .Headers(headers_)
-                                   .Body(body);
-                    AppendContentType(body, &request_factory);
-                    break;
-                case NbHttpRequestMethod::HTTP_REQUEST_TYPE_DELETE:
-                    request_factory.Delete(kApigwUrl)
-                                   .Params(parameters_)
-                                   .Headers(headers_);
-                    break;
-            }
-            return  request_factory.AppendPath("/" + api_name_ + subpath_)
-                                   .Build();
-        }, timeout_);
+    return NbResultCode::NB_OK;
 }
 
-NbResult<NbHttpResponse> NbApiGateway::ExecuteCustomApi(const std::vector<char> &body) {
-    string body_string(body.begin(), body.end());
-    return ExecuteCustomApi(body_string);
+NbHttpRequest NbApiGateway::CreateRequest(const string &body, NbHttpRequestFactory *request_factory,
+                                          bool streaming) {
+    switch (http_method_) {
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET:
+            request_factory->Get(kApigwUrl)
+                            .Params(parameters_)
+                            .Headers(headers_);
+            break;
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST:
+            request_factory->Post(kApigwUrl)
+                            .Headers(headers_)
+                            .Body(body);
+            AppendContentType(streaming || !body.empty(), request_factory);
+            break;
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT:
+            request_factory->Put(kApigwUrl)
+                            .Headers(headers_)
+                            .Body(body);
+            AppendContentType(streaming || !body.empty(), request_factory);
+            break;
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_DELETE:
+            request_factory->Delete(kApigwUrl)
+                            .Params(parameters_)
+                            .Headers(headers_);
+            break;
+    }
+    return  request_factory->AppendPath("/" + api_name_ + subpath_)
+                            .Build();
 }
 
-bool NbApiGateway::CheckContentType(const string &body) {
+bool NbApiGateway::CheckContentType(bool has_body) {
     if (http_method_ == NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST ||
         http_method_ == NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT) {
-        return (body.empty() || !content_type_.empty());
+        return (!has_body || !content_type_.empty());
     }
 
     return true;
 }
 
-void NbApiGateway::AppendContentType(const string &body, NbHttpRequestFactory *request_factory) {
-    if (!body.empty()) {
+void NbApiGateway::AppendContentType(bool has_body, NbHttpRequestFactory *request_factory) {
+    if (has_body) {
         // content_type_が空でないことはチェック済の想定
         request_factory->AppendHeader(kHeaderContentType, content_type_);
     }
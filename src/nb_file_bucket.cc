@@ -3,8 +3,21 @@
  */
 
 #include "necbaas/nb_file_bucket.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <thread>
 #include <curlpp/cURLpp.hpp>
 #include "necbaas/internal/nb_logger.h"
+#include "necbaas/internal/nb_utility.h"
 
 namespace necbaas {
 
@@ -12,6 +25,61 @@ using std::string;
 using std::vector;
 using std::shared_ptr;
 
+// ジョブをconcurrency個のスレッドで分担して実行し、結果を集計する
+// REST Executorの空きが無いジョブは、wait_timeout(秒)まで空きを待って再実行する
+template <typename T, typename Job>
+static NbFileTransferResult<T> ExecuteTransferJobs(const vector<Job> &jobs, int concurrency, int wait_timeout,
+                                                   const std::function<NbResult<T>(const Job &)> &transfer,
+                                                   const std::function<int64_t(const T &)> &get_size) {
+    NbFileTransferResult<T> transfer_result;
+    transfer_result.results.resize(jobs.size());
+    auto start = std::chrono::steady_clock::now();
+
+    int thread_count = std::min<int64_t>(std::min(concurrency, kHttpConnectionMax), jobs.size());
+    thread_count = std::max(thread_count, 1);
+    std::atomic<size_t> next_job{0};
+    auto worker = [&] {
+        for (size_t i = next_job++; i < jobs.size(); i = next_job++) {
+            auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(wait_timeout);
+            NbResult<T> result = transfer(jobs[i]);
+            // 同時接続数オーバーは送信前に失敗しているため、再実行しても重複しない
+            while (result.GetResultCode() == NbResultCode::NB_ERROR_CONNECTION_OVER &&
+                   std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(kTransferJobRetryInterval));
+                result = transfer(jobs[i]);
+            }
+            transfer_result.results[i] = std::move(result);
+        }
+    };
+    vector<std::thread> threads;
+    for (int i = 1; i < thread_count; ++i) {
+        threads.emplace_back(worker);
+    }
+    // 呼び出し元のスレッドも1つ分のジョブを処理する
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (const auto &result : transfer_result.results) {
+        if (result.IsSuccess()) {
+            ++transfer_result.success_count;
+            transfer_result.total_bytes += get_size(result.GetSuccessData());
+        } else {
+            ++transfer_result.failure_count;
+        }
+    }
+    transfer_result.elapsed_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    if (transfer_result.elapsed_time_ms > 0) {
+        transfer_result.bytes_per_second = transfer_result.total_bytes * 1000 / transfer_result.elapsed_time_ms;
+    }
+    NBLOG(INFO) << "Transfer files: " << transfer_result.success_count << " succeeded, "
+                << transfer_result.failure_count << " failed, " << transfer_result.total_bytes << " bytes, "
+                << transfer_result.elapsed_time_ms << " ms";
+    return transfer_result;
+}
+
 // コンストラクタ
 NbFileBucket::NbFileBucket(const shared_ptr<NbService> &service, const string &bucket_name)
     : service_(service), bucket_name_(bucket_name) {}
@@ -24,35 +92,51 @@ NbResult<int> NbFileBucket::DownloadFile(const string &file_name, const string &
 
     NbResult<int> result;
 
-    if (file_name.empty() || file_path.empty()) {
-        //エラー処理
-        result.SetResultCode(NbResultCode::NB_ERROR_INVALID_ARGUMENT);
-        NBLOG(ERROR) << "File name or file path is empty.";
-        return result;
+    NbResult<int64_t> download_result = DownloadLargeFile(file_name, file_path);
+
+    result.SetResultCode(download_result.GetResultCode());
+    result.SetRestInfo(download_result);
+
+    if (download_result.IsSuccess()) {
+        int64_t file_size = download_result.GetSuccessData();
+        if (file_size > std::numeric_limits<int>::max()) {
+            NBLOG(ERROR) << "File size exceeds int range. Use DownloadLargeFile(). size:" << file_size;
+            result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+        } else {
+            result.SetSuccessData(static_cast<int>(file_size));
+        }
+    } else if (download_result.IsRestError()) {
+        result.SetRestError(download_result.GetRestError());
     }
 
-    if (bucket_name_.empty()) {
-        //エラー処理
-        result.SetResultCode(NbResultCode::NB_ERROR_BUCKET_NAME);
-        NBLOG(ERROR) << "Bucket name is empty.";
+    return result;
+}
+
+NbResult<int64_t> NbFileBucket::DownloadLargeFile(const string &file_name, const string &file_path) {
+    NBLOG(TRACE) << __func__;
+
+    NbResult<int64_t> result;
+
+    NbResultCode result_code = CheckDownload(file_name, !file_path.empty());
+    if (result_code != NbResultCode::NB_OK) {
+        result.SetResultCode(result_code);
         return result;
     }
 
     NbResult<NbHttpResponse> rest_result = service_->ExecuteFileDownload(
         [this, &file_name](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
-            return request_factory.Get(kFilesPath)
-                                  .AppendPath("/" + bucket_name_ + "/" + curlpp::escape(file_name))
-                                  .Build();
+            return CreateDownloadRequest(file_name, &request_factory);
         }, file_path, timeout_);
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
-        int file_size = 0;
-        auto headers = rest_result.GetSuccessData().GetHeaders();
-        auto x_content_length = headers.find(kHeaderXContentLength);
-        if (x_content_length != headers.end()) {
-            file_size = std::atoi(x_content_length->second.c_str());
+        int64_t file_size = 0;
+        string x_content_length;
+        if (rest_result.GetSuccessData().GetHeader(kHeaderXContentLength, &x_content_length)) {
+            file_size = std::strtoll(x_content_length.c_str(), nullptr, 10);
         }
         result.SetSuccessData(file_size);
     } else if (rest_result.IsRestError()) {
@@ -62,6 +146,262 @@ NbResult<int> NbFileBucket::DownloadFile(const string &file_name, const string &
     return result;
 }
 
+NbResult<int64_t> NbFileBucket::DownloadFile(const string &file_name, char *buffer, size_t capacity) {
+    NBLOG(TRACE) << __func__;
+
+    NbResult<int64_t> result;
+
+    NbResultCode result_code = CheckDownload(file_name, buffer != nullptr);
+    if (result_code != NbResultCode::NB_OK) {
+        result.SetResultCode(result_code);
+        return result;
+    }
+
+    size_t size = 0;
+    NbResult<NbHttpResponse> rest_result = service_->ExecuteBufferDownload(
+        [this, &file_name](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateDownloadRequest(file_name, &request_factory);
+        }, buffer, capacity, &size, timeout_);
+
+    result.SetResultCode(rest_result.GetResultCode());
+
+    result.SetRestInfo(rest_result);
+
+    if (rest_result.IsSuccess()) {
+        if (!ValidateDownloadSize(rest_result.GetSuccessData(), size)) {
+            result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+            return result;
+        }
+        result.SetSuccessData(static_cast<int64_t>(size));
+    } else if (rest_result.IsRestError()) {
+        result.SetRestError(rest_result.GetRestError());
+    }
+
+    return result;
+}
+
+NbResult<int64_t> NbFileBucket::DownloadFile(const string &file_name, vector<char> *buffer) {
+    NBLOG(TRACE) << __func__;
+
+    NbResult<int64_t> result;
+
+    NbResultCode result_code = CheckDownload(file_name, buffer != nullptr);
+    if (result_code != NbResultCode::NB_OK) {
+        result.SetResultCode(result_code);
+        return result;
+    }
+
+    NbResult<NbHttpResponse> rest_result = service_->ExecuteRequest(
+        [this, &file_name](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateDownloadRequest(file_name, &request_factory);
+        }, timeout_, NbOperation::FILE_DOWNLOAD);
+
+    result.SetResultCode(rest_result.GetResultCode());
+
+    result.SetRestInfo(rest_result);
+
+    if (rest_result.IsSuccess()) {
+        size_t size = rest_result.GetSuccessData().GetBody().size();
+        if (!ValidateDownloadSize(rest_result.GetSuccessData(), size)) {
+            result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+            return result;
+        }
+        result.SetSuccessData(static_cast<int64_t>(size));
+        // 受信バッファは複製せずに移動する
+        *buffer = std::move(rest_result).GetSuccessData().GetBody();
+    } else if (rest_result.IsRestError()) {
+        result.SetRestError(rest_result.GetRestError());
+    }
+
+    return result;
+}
+
+NbResult<int64_t> NbFileBucket::DownloadFile(const NbFileMetadata &metadata, const string &file_path,
+                                         int parallel_count) {
+    NBLOG(TRACE) << __func__;
+
+    NbResult<int64_t> result;
+
+    const string &file_name = metadata.GetFileName();
+    NbResultCode result_code = CheckDownload(file_name, !file_path.empty());
+    if (result_code == NbResultCode::NB_OK && (parallel_count < 1 || metadata.GetLength() < 0)) {
+        NBLOG(ERROR) << "Parallel count or file size is invalid.";
+        result_code = NbResultCode::NB_ERROR_INVALID_ARGUMENT;
+    }
+    if (result_code != NbResultCode::NB_OK) {
+        result.SetResultCode(result_code);
+        return result;
+    }
+
+    int64_t file_size = metadata.GetLength();
+    int64_t segment_count = std::min<int64_t>({parallel_count, kHttpConnectionMax, file_size / kRangeSegmentSizeMin});
+    if (segment_count <= 1) {
+        return DownloadLargeFile(file_name, file_path);
+    }
+
+    // 範囲の転送に使用するREST Executorを先に確保し、空きが足りない場合は分割数を減らす
+    auto start = std::chrono::steady_clock::now();
+    vector<NbRestExecutor *> executors = service_->ReserveRestExecutors(static_cast<int>(segment_count));
+    if (executors.size() <= 1) {
+        NBLOG(INFO) << "Not enough executors for parallel download. reserved:" << executors.size();
+        service_->ReleaseRestExecutors(executors);
+        return DownloadLargeFile(file_name, file_path);
+    }
+    segment_count = executors.size();
+
+    int fd = open(file_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        NBLOG(ERROR) << "File open error errno:" << errno;
+        service_->ReleaseRestExecutors(executors);
+        result.SetResultCode(NbResultCode::NB_ERROR_OPEN_FILE);
+        return result;
+    }
+    // 各範囲を該当位置に書き込むため、ファイルサイズを確定する
+    if (ftruncate(fd, file_size) != 0) {
+        NBLOG(ERROR) << "ftruncate error errno:" << errno;
+        close(fd);
+        service_->ReleaseRestExecutors(executors);
+        result.SetResultCode(NbResultCode::NB_ERROR_OPEN_FILE);
+        return result;
+    }
+
+    // 範囲ごとに予約したREST Executorで並行してダウンロードする
+    int64_t segment_size = (file_size + segment_count - 1) / segment_count;
+    vector<NbResult<NbHttpResponse>> rest_results(segment_count);
+    vector<std::thread> threads;
+    for (int64_t i = 0; i < segment_count; ++i) {
+        int64_t offset = i * segment_size;
+        int64_t length = std::min(segment_size, file_size - offset);
+        NbRestExecutor *executor = executors[i];
+        threads.emplace_back([this, &file_name, &rest_results, executor, fd, i, offset, length] {
+            rest_results[i] = service_->ExecuteRangeDownload(
+                [this, &file_name, offset, length](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+                    request_factory.Get(kFilesPath)
+                                   .AppendPath("/" + bucket_name_ + "/" + curlpp::escape(file_name))
+                                   .AppendHeader(kHeaderRange, "bytes=" + std::to_string(offset) + "-" +
+                                                               std::to_string(offset + length - 1));
+                    return request_factory.Build();
+                }, executor, fd, offset, length, timeout_);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    service_->ReleaseRestExecutors(executors);
+
+    // サーバのファイルサイズがメタデータと異なる場合(メタデータが古い場合)は、ファイルが不完全となるためエラーとする
+    for (auto &rest_result : rest_results) {
+        if (!rest_result.IsSuccess()) {
+            continue;
+        }
+        string x_content_length;
+        if (!rest_result.GetSuccessData().GetHeader(kHeaderXContentLength, &x_content_length) ||
+            std::strtoll(x_content_length.c_str(), nullptr, 10) != file_size) {
+            NBLOG(ERROR) << "A file size is different. X-Content-Length:" << x_content_length;
+            rest_result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+        }
+    }
+
+    // 最初に失敗した範囲の結果を返す
+    auto failed = std::find_if(rest_results.begin(), rest_results.end(),
+                               [](const NbResult<NbHttpResponse> &rest_result) { return !rest_result.IsSuccess(); });
+    const NbResult<NbHttpResponse> &rest_result = (failed != rest_results.end()) ? *failed : rest_results.front();
+
+    result.SetResultCode(rest_result.GetResultCode());
+    if (failed == rest_results.end() && service_->IsFileDownloadSyncEnabled() && fsync(fd) != 0) {
+        NBLOG(ERROR) << "fsync error errno:" << errno;
+        result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+    }
+    close(fd);
+
+    // 統計情報は範囲毎ではなく1回のダウンロードとして記録し、転送量は全範囲の合計とする
+    NbResult<NbHttpResponse> statistics_result(result.GetResultCode());
+    NbTransferInfo transfer_info = rest_result.GetTransferInfo();
+    transfer_info.request_size = 0;
+    transfer_info.response_header_size = 0;
+    transfer_info.upload_size = 0;
+    transfer_info.download_size = 0;
+    for (const auto &segment_result : rest_results) {
+        const NbTransferInfo &segment_info = segment_result.GetTransferInfo();
+        transfer_info.request_size += segment_info.request_size;
+        transfer_info.response_header_size += segment_info.response_header_size;
+        transfer_info.upload_size += segment_info.upload_size;
+        transfer_info.download_size += segment_info.download_size;
+    }
+    statistics_result.SetTransferInfo(transfer_info);
+    service_->RecordStatistics(NbOperation::FILE_DOWNLOAD, statistics_result, start);
+
+    result.SetRestInfo(rest_result);
+
+    if (result.IsSuccess()) {
+        result.SetSuccessData(file_size);
+    } else if (rest_result.IsRestError()) {
+        result.SetRestError(rest_result.GetRestError());
+    }
+
+    return result;
+}
+
+NbResult<int64_t> NbFileBucket::ResumeDownloadFile(const NbFileMetadata &metadata, const string &file_path) {
+    NBLOG(TRACE) << __func__;
+
+    NbResult<int64_t> result;
+
+    const string &file_name = metadata.GetFileName();
+    NbResultCode result_code = CheckDownload(file_name, !file_path.empty());
+    if (result_code != NbResultCode::NB_OK) {
+        result.SetResultCode(result_code);
+        return result;
+    }
+
+    // 保存済みのデータが別のファイル(更新前)のものであれば破棄する
+    const string &file_etag = metadata.GetFileETag();
+    string etag_path = file_path + kResumeETagFileSuffix;
+    bool resumable = false;
+    {
+        std::ifstream etag_stream(etag_path);
+        string saved_etag;
+        std::getline(etag_stream, saved_etag);
+        resumable = (etag_stream.is_open() && saved_etag == file_etag);
+    }
+    if (!resumable) {
+        std::ofstream file_stream(file_path, std::ios::out | std::ios::binary | std::ios::trunc);
+        std::ofstream etag_stream(etag_path, std::ios::out | std::ios::trunc);
+        etag_stream << file_etag;
+        if (!file_stream || !etag_stream) {
+            NBLOG(ERROR) << "File open error.";
+            result.SetResultCode(NbResultCode::NB_ERROR_OPEN_FILE);
+            return result;
+        }
+    }
+
+    NbResult<NbHttpResponse> rest_result = service_->ExecuteFileResumeDownload(
+        [this, &file_name](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateDownloadRequest(file_name, &request_factory);
+        }, file_path, file_etag, timeout_);
+
+    result.SetResultCode(rest_result.GetResultCode());
+
+    result.SetRestInfo(rest_result);
+
+    if (rest_result.IsSuccess()) {
+        // 保存したファイルが完全であることを確認してから、再開用のETagを破棄する
+        string x_content_length;
+        if (!rest_result.GetSuccessData().GetHeader(kHeaderXContentLength, &x_content_length) ||
+            std::strtoll(x_content_length.c_str(), nullptr, 10) != NbUtility::GetFileSize(file_path)) {
+            NBLOG(ERROR) << "A file size is different. X-Content-Length:" << x_content_length;
+            result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+            return result;
+        }
+        std::remove(etag_path.c_str());
+        result.SetSuccessData(std::strtoll(x_content_length.c_str(), nullptr, 10));
+    } else if (rest_result.IsRestError()) {
+        result.SetRestError(rest_result.GetRestError());
+    }
+
+    return result;
+}
+
 NbResult<NbFileMetadata> NbFileBucket::UploadNewFile(const string &file_name, const string &file_path,
                                                      const string &content_type, const string &acl,
                                                      bool cache_disable) {
@@ -85,30 +425,10 @@ NbResult<NbFileMetadata> NbFileBucket::UploadNewFile(const string &file_name, co
 
     NbResult<NbHttpResponse> rest_result = service_->ExecuteFileUpload(
         [this, &file_name, &content_type, &acl, cache_disable](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
-            request_factory.Post(kFilesPath)
-                           .AppendPath("/" + bucket_name_ + "/" + curlpp::escape(file_name))
-                           .AppendHeader(kHeaderContentType, content_type);
-            if (!acl.empty()) {
-                request_factory.AppendHeader(kHeaderXAcl, acl);
-            }
-            if (cache_disable) {
-                request_factory.AppendParam(kKeyCacheDisabled, "true");
-            }
-            return request_factory.Build();
+            return CreateUploadNewRequest(file_name, content_type, acl, cache_disable, &request_factory);
         }, file_path, timeout_);
 
-    result.SetResultCode(rest_result.GetResultCode());
-
-    if (rest_result.IsSuccess()) {
-        const NbHttpResponse &http_response = rest_result.GetSuccessData();
-        NbJsonObject json(http_response.GetBody());
-        NbFileMetadata metadata(bucket_name_, json);
-        result.SetSuccessData(metadata);
-    } else if (rest_result.IsRestError()) {
-        result.SetRestError(rest_result.GetRestError());
-    }
-
-    return result;
+    return MakeUploadResult(rest_result);
 }
 
 NbResult<NbFileMetadata> NbFileBucket::UploadNewFile(const string &file_name, const string &file_path,
@@ -123,6 +443,47 @@ NbResult<NbFileMetadata> NbFileBucket::UploadNewFile(const string &file_name, co
     return UploadNewFile(file_name, file_path, content_type, "", cache_disable);
 }
 
+NbResult<NbFileMetadata> NbFileBucket::UploadNewFile(const string &file_name, const char *data, size_t size,
+                                                     const string &content_type, const string &acl,
+                                                     bool cache_disable) {
+    NBLOG(TRACE) << __func__;
+
+    NbResult<NbFileMetadata> result;
+
+    if (file_name.empty() || (data == nullptr && size > 0) || content_type.empty()) {
+        //エラー処理
+        result.SetResultCode(NbResultCode::NB_ERROR_INVALID_ARGUMENT);
+        NBLOG(ERROR) << "File name or data or Content-Type is empty.";
+        return result;
+    }
+
+    if (bucket_name_.empty()) {
+        //エラー処理
+        result.SetResultCode(NbResultCode::NB_ERROR_BUCKET_NAME);
+        NBLOG(ERROR) << "Bucket name is empty.";
+        return result;
+    }
+
+    NbResult<NbHttpResponse> rest_result = service_->ExecuteBufferUpload(
+        [this, &file_name, &content_type, &acl, cache_disable](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateUploadNewRequest(file_name, content_type, acl, cache_disable, &request_factory);
+        }, data, size, timeout_);
+
+    return MakeUploadResult(rest_result);
+}
+
+NbResult<NbFileMetadata> NbFileBucket::UploadNewFile(const string &file_name, const char *data, size_t size,
+                                                     const string &content_type, const NbAcl &acl,
+                                                     bool cache_disable) {
+    string acl_string = acl.ToJsonObject().ToJsonString();
+    return UploadNewFile(file_name, data, size, content_type, acl_string, cache_disable);
+}
+
+NbResult<NbFileMetadata> NbFileBucket::UploadNewFile(const string &file_name, const char *data, size_t size,
+                                                     const string &content_type, bool cache_disable) {
+    return UploadNewFile(file_name, data, size, content_type, string(), cache_disable);
+}
+
 NbResult<NbFileMetadata> NbFileBucket::UploadUpdateFile(const string &file_path, const NbFileMetadata &metadata) {
     return UploadUpdateFile(metadata.GetFileName(), file_path, metadata.GetContentType(),
                             metadata.GetMetaETag(), metadata.GetFileETag());
@@ -151,32 +512,44 @@ NbResult<NbFileMetadata> NbFileBucket::UploadUpdateFile(const string &file_name,
 
     NbResult<NbHttpResponse> rest_result = service_->ExecuteFileUpload(
         [this, &file_name, &content_type, &meta_etag, &file_etag](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
-            request_factory.Put(kFilesPath)
-                           .AppendPath("/" + bucket_name_ + "/" + curlpp::escape(file_name));
-            if (!content_type.empty()) {
-                request_factory.AppendHeader(kHeaderContentType, content_type);
-            }
-            if (!meta_etag.empty()) {
-                request_factory.AppendParam(kKeyMetaETag, meta_etag);
-            }
-            if (!file_etag.empty()) {
-                request_factory.AppendParam(kKeyFileETag, file_etag);
-            }
-            return request_factory.Build();
+            return CreateUploadUpdateRequest(file_name, content_type, meta_etag, file_etag, &request_factory);
         }, file_path, timeout_);
 
-    result.SetResultCode(rest_result.GetResultCode());
+    return MakeUploadResult(rest_result);
+}
 
-    if (rest_result.IsSuccess()) {
-        const NbHttpResponse &http_response = rest_result.GetSuccessData();
-        NbJsonObject json(http_response.GetBody());
-        NbFileMetadata metadata(bucket_name_ ,json);
-        result.SetSuccessData(metadata);
-    } else if (rest_result.IsRestError()) {
-        result.SetRestError(rest_result.GetRestError());
+NbResult<NbFileMetadata> NbFileBucket::UploadUpdateFile(const char *data, size_t size, const NbFileMetadata &metadata) {
+    return UploadUpdateFile(metadata.GetFileName(), data, size, metadata.GetContentType(),
+                            metadata.GetMetaETag(), metadata.GetFileETag());
+}
+
+NbResult<NbFileMetadata> NbFileBucket::UploadUpdateFile(const string &file_name, const char *data, size_t size,
+                                                        const string &content_type, const string &meta_etag,
+                                                        const string &file_etag) {
+    NBLOG(TRACE) << __func__;
+
+    NbResult<NbFileMetadata> result;
+
+    if (file_name.empty() || (data == nullptr && size > 0)) {
+        //エラー処理
+        result.SetResultCode(NbResultCode::NB_ERROR_INVALID_ARGUMENT);
+        NBLOG(ERROR) << "File name or data is empty.";
+        return result;
     }
 
-    return result;
+    if (bucket_name_.empty()) {
+        //エラー処理
+        result.SetResultCode(NbResultCode::NB_ERROR_BUCKET_NAME);
+        NBLOG(ERROR) << "Bucket name is empty.";
+        return result;
+    }
+
+    NbResult<NbHttpResponse> rest_result = service_->ExecuteBufferUpload(
+        [this, &file_name, &content_type, &meta_etag, &file_etag](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateUploadUpdateRequest(file_name, content_type, meta_etag, file_etag, &request_factory);
+        }, data, size, timeout_);
+
+    return MakeUploadResult(rest_result);
 }
 
 NbResult<NbFileMetadata> NbFileBucket::DeleteFile(const NbFileMetadata &metadata, bool delete_mark) {
@@ -218,10 +591,12 @@ NbResult<NbFileMetadata> NbFileBucket::DeleteFile(const string &file_name, const
                 request_factory.AppendParam(kKeyDeleteMark, "1");
             }
             return request_factory.Build();
-        }, timeout_);
+        }, timeout_, NbOperation::FILE_DELETE);
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
         NbJsonObject json(http_response.GetBody());
@@ -257,10 +632,12 @@ NbResult<vector<NbFileMetadata>> NbFileBucket::GetFiles(bool published, bool del
                 request_factory.AppendParam(kKeyDeleteMark, "1");
             }
             return request_factory.Build();
-        }, timeout_);
+        }, timeout_, NbOperation::FILE_LIST);
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
         NbJsonObject json(http_response.GetBody());
@@ -278,6 +655,117 @@ NbResult<vector<NbFileMetadata>> NbFileBucket::GetFiles(bool published, bool del
     return result;
 }
 
+NbResultCode NbFileBucket::CheckDownload(const string &file_name, bool has_output) const {
+    if (file_name.empty() || !has_output) {
+        //エラー処理
+        NBLOG(ERROR) << "File name or output is empty.";
+        return NbResultCode::NB_ERROR_INVALID_ARGUMENT;
+    }
+
+    if (bucket_name_.empty()) {
+        //エラー処理
+        NBLOG(ERROR) << "Bucket name is empty.";
+        return NbResultCode::NB_ERROR_BUCKET_NAME;
+    }
+
+    return NbResultCode::NB_OK;
+}
+
+NbHttpRequest NbFileBucket::CreateDownloadRequest(const string &file_name,
+                                                  NbHttpRequestFactory *request_factory) const {
+    return request_factory->Get(kFilesPath)
+                           .AppendPath("/" + bucket_name_ + "/" + curlpp::escape(file_name))
+                           .Build();
+}
+
+NbHttpRequest NbFileBucket::CreateUploadNewRequest(const string &file_name, const string &content_type,
+                                                   const string &acl, bool cache_disable,
+                                                   NbHttpRequestFactory *request_factory) const {
+    request_factory->Post(kFilesPath)
+                    .AppendPath("/" + bucket_name_ + "/" + curlpp::escape(file_name))
+                    .AppendHeader(kHeaderContentType, content_type);
+    if (!acl.empty()) {
+        request_factory->AppendHeader(kHeaderXAcl, acl);
+    }
+    if (cache_disable) {
+        request_factory->AppendParam(kKeyCacheDisabled, "true");
+    }
+    return request_factory->Build();
+}
+
+NbHttpRequest NbFileBucket::CreateUploadUpdateRequest(const string &file_name, const string &content_type,
+                                                      const string &meta_etag, const string &file_etag,
+                                                      NbHttpRequestFactory *request_factory) const {
+    request_factory->Put(kFilesPath)
+                    .AppendPath("/" + bucket_name_ + "/" + curlpp::escape(file_name));
+    if (!content_type.empty()) {
+        request_factory->AppendHeader(kHeaderContentType, content_type);
+    }
+    if (!meta_etag.empty()) {
+        request_factory->AppendParam(kKeyMetaETag, meta_etag);
+    }
+    if (!file_etag.empty()) {
+        request_factory->AppendParam(kKeyFileETag, file_etag);
+    }
+    return request_factory->Build();
+}
+
+NbResult<NbFileMetadata> NbFileBucket::MakeUploadResult(const NbResult<NbHttpResponse> &rest_result) const {
+    NbResult<NbFileMetadata> result;
+
+    result.SetResultCode(rest_result.GetResultCode());
+
+    result.SetRestInfo(rest_result);
+
+    if (rest_result.IsSuccess()) {
+        const NbHttpResponse &http_response = rest_result.GetSuccessData();
+        NbJsonObject json(http_response.GetBody());
+        NbFileMetadata metadata(bucket_name_, json);
+        result.SetSuccessData(metadata);
+    } else if (rest_result.IsRestError()) {
+        result.SetRestError(rest_result.GetRestError());
+    }
+
+    return result;
+}
+
+bool NbFileBucket::ValidateDownloadSize(const NbHttpResponse &response, size_t size) const {
+    string x_content_length;
+    if (!response.GetHeader(kHeaderXContentLength, &x_content_length)) {
+        // X-Content-Lengthヘッダは必須
+        NBLOG(ERROR) << "There is no X-Content-Length.";
+        return false;
+    }
+    if (std::strtoull(x_content_length.c_str(), nullptr, 10) != size) {
+        NBLOG(ERROR) << "A file size is different.";
+        return false;
+    }
+    return true;
+}
+
+NbFileTransferResult<NbFileMetadata> NbFileBucket::UploadFiles(const vector<NbFileUploadJob> &jobs, int concurrency) {
+    NBLOG(TRACE) << __func__;
+
+    return ExecuteTransferJobs<NbFileMetadata, NbFileUploadJob>(
+        jobs, concurrency, timeout_,
+        [this](const NbFileUploadJob &job) {
+            if (job.acl) {
+                return UploadNewFile(job.file_name, job.file_path, job.content_type, *job.acl, job.cache_disable);
+            }
+            return UploadNewFile(job.file_name, job.file_path, job.content_type, job.cache_disable);
+        },
+        [](const NbFileMetadata &metadata) { return metadata.GetLength(); });
+}
+
+NbFileTransferResult<int64_t> NbFileBucket::DownloadFiles(const vector<NbFileDownloadJob> &jobs, int concurrency) {
+    NBLOG(TRACE) << __func__;
+
+    return ExecuteTransferJobs<int64_t, NbFileDownloadJob>(
+        jobs, concurrency, timeout_,
+        [this](const NbFileDownloadJob &job) { return DownloadLargeFile(job.file_name, job.file_path); },
+        [](const int64_t &size) { return size; });
+}
+
 int NbFileBucket::GetTimeout() const {
     return timeout_;
 }
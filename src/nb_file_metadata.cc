@@ -17,7 +17,7 @@ NbFileMetadata::NbFileMetadata(const std::string &bucket_name, const NbJsonObjec
     file_name_ = json.GetString(kKeyFilename);
     content_type_ = json.GetString(kKeyContentType);
     acl_ = NbAcl(json.GetJsonObject(kKeyAcl));
-    length_ = json.GetInt(kKeyLength);
+    length_ = json.GetInt64(kKeyLength);
     created_time_ = json.GetString(kKeyCreatedAt);
     updated_time_ = json.GetString(kKeyUpdatedAt);
     meta_etag_ = json.GetString(kKeyMetaETag);
@@ -41,7 +41,7 @@ const NbAcl &NbFileMetadata::GetAcl() const {
     return acl_;
 }
 
-int NbFileMetadata::GetLength() const {
+int64_t NbFileMetadata::GetLength() const {
     return length_;
 }
 
@@ -5,6 +5,7 @@
 #include "necbaas/nb_http_response.h"
 #include "necbaas/internal/nb_logger.h"
 #include "necbaas/internal/nb_constants.h"
+#include "necbaas/internal/nb_utility.h"
 
 namespace necbaas {
 
@@ -14,10 +15,30 @@ using std::multimap;
 
 NbHttpResponse::NbHttpResponse() {};
 
-NbHttpResponse::NbHttpResponse(int status_code, const string &reason_phrase,
-                               const multimap<string, string> &headers,
-                               const vector<char> &body) 
-        : status_code_(status_code), reason_phrase_(reason_phrase), headers_(headers), body_(body) {}
+NbHttpResponse::NbHttpResponse(int status_code, string reason_phrase, multimap<string, string> headers,
+                               vector<char> body)
+        : status_code_(status_code), reason_phrase_(std::move(reason_phrase)), body_(std::move(body)) {
+    // GetHeader()で検索できるよう、格納領域にも設定する
+    header_fields_.reserve(headers.size());
+    for (const auto &header : headers) {
+        HeaderField field;
+        field.name_offset = header_buffer_.size();
+        field.name_length = header.first.size();
+        header_buffer_.append(header.first);
+        field.value_offset = header_buffer_.size();
+        field.value_length = header.second.size();
+        header_buffer_.append(header.second);
+        header_fields_.push_back(field);
+    }
+    headers_.headers = std::move(headers);
+    headers_.created = true;
+}
+
+NbHttpResponse::NbHttpResponse(int status_code, string reason_phrase, string header_buffer,
+                               vector<HeaderField> header_fields, vector<char> body)
+        : status_code_(status_code), reason_phrase_(std::move(reason_phrase)),
+          header_buffer_(std::move(header_buffer)), header_fields_(std::move(header_fields)),
+          body_(std::move(body)) {}
 
 NbHttpResponse::~NbHttpResponse() {};
 
@@ -30,13 +51,80 @@ const string &NbHttpResponse::GetReasonPhrase() const {
 }
 
 const multimap<string, string> &NbHttpResponse::GetHeaders() const {
-    return headers_;
+    if (!headers_.created.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(headers_.mutex);
+        if (!headers_.created.load(std::memory_order_relaxed)) {
+            for (const auto &field : header_fields_) {
+                headers_.headers.emplace(header_buffer_.substr(field.name_offset, field.name_length),
+                                         header_buffer_.substr(field.value_offset, field.value_length));
+            }
+            headers_.created.store(true, std::memory_order_release);
+        }
+    }
+    return headers_.headers;
 }
 
-const vector<char> &NbHttpResponse::GetBody() const {
+bool NbHttpResponse::GetHeader(const string &name, string *value) const {
+    for (const auto &field : header_fields_) {
+        if (NbUtility::CompareCaseInsensitiveString(header_buffer_.data() + field.name_offset, field.name_length,
+                                                    name)) {
+            if (value) {
+                value->assign(header_buffer_, field.value_offset, field.value_length);
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+const vector<char> &NbHttpResponse::GetBody() const & {
     return body_;
 }
 
+vector<char> NbHttpResponse::GetBody() && {
+    return std::move(body_);
+}
+
+bool NbHttpResponse::IsConnectionReused() const {
+    return connection_reused_;
+}
+
+void NbHttpResponse::SetConnectionReused(bool reused) {
+    connection_reused_ = reused;
+}
+
+int64_t NbHttpResponse::GetRequestBodySize() const {
+    return request_body_size_;
+}
+
+int64_t NbHttpResponse::GetRequestTransferSize() const {
+    return request_transfer_size_;
+}
+
+int64_t NbHttpResponse::GetResponseBodySize() const {
+    return response_body_size_;
+}
+
+int64_t NbHttpResponse::GetResponseTransferSize() const {
+    return response_transfer_size_;
+}
+
+void NbHttpResponse::SetTransferSize(int64_t request_body_size, int64_t request_transfer_size,
+                                     int64_t response_body_size, int64_t response_transfer_size) {
+    request_body_size_ = request_body_size;
+    request_transfer_size_ = request_transfer_size;
+    response_body_size_ = response_body_size;
+    response_transfer_size_ = response_transfer_size;
+}
+
+const NbTransferInfo &NbHttpResponse::GetTransferInfo() const {
+    return transfer_info_;
+}
+
+void NbHttpResponse::SetTransferInfo(const NbTransferInfo &transfer_info) {
+    transfer_info_ = transfer_info;
+}
+
 void NbHttpResponse::Dump() const {
     if (!NbLogger::IsRestLogEnabled()) {
         //RESTログ有効時のみ実行
@@ -45,10 +133,16 @@ void NbHttpResponse::Dump() const {
 
     NBLOG(INFO) << "[response][status-code] " << status_code_;
     NBLOG(INFO) << "[response][reason-phrase] " << reason_phrase_;
-
-    auto &headers = GetHeaders();
-    for (auto i: GetHeaders()) {
-        NBLOG(INFO) << "[response][header] " << i.first << ": " << i.second;
+    NBLOG(INFO) << "[response][time(us)] namelookup:" << transfer_info_.name_lookup_time_us
+                << " connect:" << transfer_info_.connect_time_us
+                << " appconnect:" << transfer_info_.app_connect_time_us
+                << " pretransfer:" << transfer_info_.pre_transfer_time_us
+                << " starttransfer:" << transfer_info_.start_transfer_time_us
+                << " total:" << transfer_info_.total_time_us;
+
+    for (const auto &field : header_fields_) {
+        NBLOG(INFO) << "[response][header] " << header_buffer_.substr(field.name_offset, field.name_length) << ": "
+                    << header_buffer_.substr(field.value_offset, field.value_length);
     }
     
     const vector<string> text_types{"application/json",
@@ -56,13 +150,13 @@ void NbHttpResponse::Dump() const {
                                     "text/html",
                                     "text/xml"};
 
-    auto content_type = headers.find(kHeaderContentType);
-    if (content_type == headers.end()) {
+    string content_type;
+    if (!GetHeader(kHeaderContentType, &content_type)) {
         return;
     }
 
     for (auto text_type : text_types) {
-        if (content_type->second.compare(0, text_type.size(), text_type) == 0) {
+        if (content_type.compare(0, text_type.size(), text_type) == 0) {
             //テキスト形式のみBody部を出力
             NBLOG(INFO) << "[response][body] " << string(GetBody().begin(), GetBody().end());
             break; 
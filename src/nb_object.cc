@@ -50,15 +50,18 @@ NbResult<NbObject> NbObject::PartUpdateObject(const NbJsonObject &json) {
             request_factory.Put(kObjectsPath)
                            .AppendPath("/" + bucket_name_ + "/" + object_id_)
                            .AppendHeader(kHeaderContentType, kHeaderContentTypeJson)
-                           .Body(json.ToJsonString());
+                           .Body(json.ToJsonString())
+                           .CompressibleBody();
             if (!etag_.empty()) {
                 request_factory.AppendParam(kKeyETag, etag_);
             }
             return request_factory.Build();
-        }, timeout_);
+        }, timeout_, NbOperation::OBJECT_SAVE);
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
         NbJsonObject response_json(http_response.GetBody());
@@ -101,10 +104,12 @@ NbResult<NbObject> NbObject::DeleteObject(bool delete_mark) {
                 request_factory.AppendParam(kKeyDeleteMark, "1");
             }
             return request_factory.Build();
-        }, timeout_);
+        }, timeout_, NbOperation::OBJECT_DELETE);
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
         NbJsonObject json_obj(http_response.GetBody());
@@ -128,56 +133,97 @@ NbResult<NbObject> NbObject::DeleteObject(bool delete_mark) {
 NbResult<NbObject> NbObject::Save(bool acl) {
     NBLOG(TRACE) << __func__;
 
-    NbResult<NbObject> result;
+    if (bucket_name_.empty()) {
+        //エラー処理
+        NBLOG(ERROR) << "Bucket name is empty.";
+        return NbResult<NbObject>(NbResultCode::NB_ERROR_BUCKET_NAME);
+    }
+
+    NbResult<NbHttpResponse> rest_result = service_->ExecuteRequest(
+        [this, acl](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateSaveRequest(acl, &request_factory);
+        }, timeout_, NbOperation::OBJECT_SAVE);
+
+    return MakeSaveResult(rest_result, this);
+}
+
+std::future<NbResult<NbObject>> NbObject::SaveAsync(bool acl, SaveCallback callback) const {
+    NBLOG(TRACE) << __func__;
+
+    NbAsyncResult<NbObject> async_result(callback);
+    std::future<NbResult<NbObject>> future = async_result.GetFuture();
 
     if (bucket_name_.empty()) {
         //エラー処理
-        result.SetResultCode(NbResultCode::NB_ERROR_BUCKET_NAME);
         NBLOG(ERROR) << "Bucket name is empty.";
-        return result;
+        async_result.Complete(NbResult<NbObject>(NbResultCode::NB_ERROR_BUCKET_NAME));
+        return future;
     }
 
+    // 自インスタンスは更新せず、保存結果はコピーに反映して通知する
+    // サービスは弱参照とする(結果経由でイベントループスレッド上で最後の参照が解放された場合は、
+    // NbService::DeleteService()が別スレッドで破棄する)
+    NbObject saved_object(*this);
+    saved_object.service_.reset();
+    std::weak_ptr<NbService> service = service_;
+    service_->ExecuteRequestAsync(
+        [this, acl](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return CreateSaveRequest(acl, &request_factory);
+        }, timeout_,
+        [async_result, saved_object, service](NbResult<NbHttpResponse> rest_result) mutable {
+            saved_object.service_ = service.lock();
+            async_result.Complete(MakeSaveResult(rest_result, &saved_object));
+        }, NbOperation::OBJECT_SAVE);
+    return future;
+}
+
+NbHttpRequest NbObject::CreateSaveRequest(bool acl, NbHttpRequestFactory *request_factory) const {
     NbJsonObject json(*this);
     RemoveReservationFields(&json);
 
-    NbResult<NbHttpResponse> rest_result = service_->ExecuteRequest(
-        [this, &json, acl](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
-            if (object_id_.empty()) { //新規
-                if (acl) {
-                    json.PutJsonObject(kKeyAcl, acl_.ToJsonObject());
-                }
-
-                request_factory.Post(kObjectsPath)
-                               .AppendPath("/" + bucket_name_)
-                               .AppendHeader(kHeaderContentType, kHeaderContentTypeJson)
-                               .Body(json.ToJsonString());
-            } else { //更新
-                json.PutJsonObject(kKeyAcl, acl_.ToJsonObject());
-                if (!created_time_.empty()) {
-                    json[kKeyCreatedAt] = created_time_;
-                }
-
-                NbJsonObject json_full;
-                json_full.PutJsonObject("$full_update", json);
-
-                request_factory.Put(kObjectsPath)
-                               .AppendPath("/" + bucket_name_ + "/" + object_id_)
-                               .AppendHeader(kHeaderContentType, kHeaderContentTypeJson)
-                               .Body(json_full.ToJsonString());
-                if (!etag_.empty()) {
-                    request_factory.AppendParam(kKeyETag, etag_);
-                }
-            }
-            return request_factory.Build();
-        }, timeout_);
+    if (object_id_.empty()) { //新規
+        if (acl) {
+            json.PutJsonObject(kKeyAcl, acl_.ToJsonObject());
+        }
+
+        request_factory->Post(kObjectsPath)
+                        .AppendPath("/" + bucket_name_)
+                        .AppendHeader(kHeaderContentType, kHeaderContentTypeJson)
+                        .Body(json.ToJsonString())
+                        .CompressibleBody();
+    } else { //更新
+        json.PutJsonObject(kKeyAcl, acl_.ToJsonObject());
+        if (!created_time_.empty()) {
+            json[kKeyCreatedAt] = created_time_;
+        }
+
+        NbJsonObject json_full;
+        json_full.PutJsonObject("$full_update", json);
+
+        request_factory->Put(kObjectsPath)
+                        .AppendPath("/" + bucket_name_ + "/" + object_id_)
+                        .AppendHeader(kHeaderContentType, kHeaderContentTypeJson)
+                        .Body(json_full.ToJsonString())
+                        .CompressibleBody();
+        if (!etag_.empty()) {
+            request_factory->AppendParam(kKeyETag, etag_);
+        }
+    }
+    return request_factory->Build();
+}
+
+NbResult<NbObject> NbObject::MakeSaveResult(const NbResult<NbHttpResponse> &rest_result, NbObject *object) {
+    NbResult<NbObject> result;
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
         NbJsonObject response_json(http_response.GetBody());
-        SetCurrentParam(response_json);
-        result.SetSuccessData(*this);
+        object->SetCurrentParam(response_json);
+        result.SetSuccessData(*object);
     } else if (rest_result.IsRestError()) {
         result.SetRestError(rest_result.GetRestError());
     }
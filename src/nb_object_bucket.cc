@@ -40,15 +40,18 @@ NbResult<NbObject> NbObjectBucket::GetObject(const string &object_id, bool delet
     NbResult<NbHttpResponse> rest_result = service_->ExecuteRequest(
         [this, &object_id, delete_mark](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
             request_factory.Get(kObjectsPath)
-                           .AppendPath("/" + bucket_name_ + "/" + object_id);
+                           .AppendPath("/" + bucket_name_ + "/" + object_id)
+                           .Hedgeable();
             if (delete_mark) {
                 request_factory.AppendParam(kKeyDeleteMark, "1");
             }
             return request_factory.Build();
-        }, timeout_);
+        }, timeout_, NbOperation::OBJECT_GET);
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
         NbJsonObject json(http_response.GetBody());
@@ -65,25 +68,66 @@ NbResult<NbObject> NbObjectBucket::GetObject(const string &object_id, bool delet
 NbResult<vector<NbObject>> NbObjectBucket::Query(const NbQuery &query, int *count) {
     NBLOG(TRACE) << __func__;
 
-    NbResult<vector<NbObject>> result;
-
     if (bucket_name_.empty()) {
         //エラー処理
-        result.SetResultCode(NbResultCode::NB_ERROR_BUCKET_NAME);
         NBLOG(ERROR) << "Bucket name is empty.";
-        return result;
+        return NbResult<vector<NbObject>>(NbResultCode::NB_ERROR_BUCKET_NAME);
     }
 
     NbResult<NbHttpResponse> rest_result = service_->ExecuteRequest(
+        [this, &query, count](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
+            return request_factory.Get(kObjectsPath)
+                           .AppendPath("/" + bucket_name_)
+                           .Params(GetParams(query, count))
+                           .Hedgeable()
+                           .Build();
+        }, timeout_, NbOperation::OBJECT_QUERY);
+
+    return MakeQueryResult(service_, bucket_name_, rest_result, count);
+}
+
+std::future<NbResult<vector<NbObject>>> NbObjectBucket::QueryAsync(const NbQuery &query, int *count,
+                                                                   QueryCallback callback) {
+    NBLOG(TRACE) << __func__;
+
+    NbAsyncResult<vector<NbObject>> async_result(callback);
+    std::future<NbResult<vector<NbObject>>> future = async_result.GetFuture();
+
+    if (bucket_name_.empty()) {
+        //エラー処理
+        NBLOG(ERROR) << "Bucket name is empty.";
+        async_result.Complete(NbResult<vector<NbObject>>(NbResultCode::NB_ERROR_BUCKET_NAME));
+        return future;
+    }
+
+    // 完了時にバケットインスタンスが存在しない場合に備え、サービスとバケット名はコピーする
+    // サービスは弱参照とする(結果経由でイベントループスレッド上で最後の参照が解放された場合は、
+    // NbService::DeleteService()が別スレッドで破棄する)
+    std::weak_ptr<NbService> service = service_;
+    string bucket_name = bucket_name_;
+    service_->ExecuteRequestAsync(
         [this, &query, count](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
             return request_factory.Get(kObjectsPath)
                            .AppendPath("/" + bucket_name_)
                            .Params(GetParams(query, count))
                            .Build();
-        }, timeout_);
+        }, timeout_,
+        [async_result, service, bucket_name, count](NbResult<NbHttpResponse> rest_result) {
+            async_result.Complete(MakeQueryResult(service.lock(), bucket_name, rest_result, count));
+        }, NbOperation::OBJECT_QUERY);
+    return future;
+}
+
+NbResult<vector<NbObject>> NbObjectBucket::MakeQueryResult(const shared_ptr<NbService> &service,
+                                                           const string &bucket_name,
+                                                           const NbResult<NbHttpResponse> &rest_result,
+                                                           int *count) {
+    NbResult<vector<NbObject>> result;
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
         NbJsonObject json(http_response.GetBody());
@@ -91,7 +135,7 @@ NbResult<vector<NbObject>> NbObjectBucket::Query(const NbQuery &query, int *coun
         //"results"配列型を取得
         NbJsonArray query_results_array = json.GetJsonArray(kKeyResults);
 
-        NbObject object(service_, bucket_name_);
+        NbObject object(service, bucket_name);
         vector<NbObject> vector_object;
         for (int i = 0; i < query_results_array.GetSize(); i++) {
             //results"配列からJson Objectを取り出し、NbObjectの配列を構築
@@ -3,6 +3,15 @@
  */
 
 #include "necbaas/nb_service.h"
+#include <future>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <cerrno>
+#include <unistd.h>
 #include <curlpp/cURLpp.hpp>
 #include "necbaas/internal/nb_logger.h"
 
@@ -13,11 +22,106 @@ using std::shared_ptr;
 
 static std::mutex mutex_curl;
 
+// リトライ対象の判定
+static bool IsRetryable(const NbRetryPolicy &policy, const NbHttpRequest &request,
+                        const NbResult<NbHttpResponse> &result) {
+    switch (request.GetMethod()) {
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET:
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT:
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_DELETE:
+            break;
+        case NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST:
+            if (!policy.retry_post) {
+                return false;
+            }
+            break;
+        default:
+            return false;
+    }
+
+    switch (result.GetResultCode()) {
+        case NbResultCode::NB_ERROR_CURL_RUNTIME:
+            return true;
+        case NbResultCode::NB_ERROR_RESPONSE: {
+            int status_code = result.GetRestError().status_code;
+            return status_code == 502 || status_code == 503 || status_code == 504;
+        }
+        default:
+            return false;
+    }
+}
+
+// サーキットブレーカーで失敗として記録するか判定
+static bool IsCircuitFailure(const NbResult<NbHttpResponse> &result) {
+    switch (result.GetResultCode()) {
+        case NbResultCode::NB_ERROR_CURL_RUNTIME:
+            return true;
+        case NbResultCode::NB_ERROR_RESPONSE:
+            return result.GetRestError().status_code >= 500;
+        default:
+            return false;
+    }
+}
+
+// ヘッジリクエストの共有データ
+struct NbService::HedgeState {
+    HedgeState(const NbHttpRequest *request, int timeout) : request(request), timeout(timeout) {}
+
+    const NbHttpRequest *request;               /*!< HTTPリクエスト(処理結果の確定前のみ有効) */
+    const int timeout;                          /*!< RESTタイムアウト(秒) */
+    std::mutex mutex;                           /*!< 共有データ用Mutex */
+    std::condition_variable cond;               /*!< 完了通知 */
+    bool done{false};                           /*!< 処理結果が確定した */
+    bool hedge_pending{true};                   /*!< 重複送信の要否が未決定(タイマー満了前、かつ最初の転送の完了処理前) */
+    NbResult<NbHttpResponse> result;            /*!< 採用した転送の処理結果 */
+    NbResult<NbHttpResponse> failure;           /*!< リトライ可能なエラーで完了した転送の処理結果 */
+    std::vector<NbRestExecutor *> running;      /*!< 転送中のREST Executor */
+
+    // 他の転送の完了を待たずに採用できる処理結果か判定
+    // 接続失敗などのリトライ可能なエラーは、成功し得る他の転送を中断しないよう採用しない
+    static bool IsAcceptable(const NbHttpRequest &request, const NbResult<NbHttpResponse> &result) {
+        return result.IsSuccess() || !IsRetryable(NbRetryPolicy(), request, result);
+    }
+
+    // 全ての転送がリトライ可能なエラーで完了した場合、最後のエラーを処理結果とする
+    // mutexをロックして呼び出すこと
+    void CompleteIfFailed() {
+        if (!done && !hedge_pending && running.empty()) {
+            done = true;
+            result = std::move(failure);
+        }
+    }
+};
+
+// リトライ間隔(ミリ秒)の算出
+// 指数バックオフの上限値の後半50%からランダムに選び、同時に失敗したクライアントのリトライを分散させる
+static int CalcBackoff(const NbRetryPolicy &policy, int retry_count) {
+    static thread_local std::mt19937 engine(std::random_device{}());
+
+    double backoff = policy.initial_backoff_ms * std::pow(policy.backoff_multiplier, retry_count);
+    int upper = static_cast<int>(std::min(backoff, static_cast<double>(policy.max_backoff_ms)));
+    if (upper <= 0) {
+        return 0;
+    }
+    std::uniform_int_distribution<int> distribution(upper / 2, upper);
+    return distribution(engine);
+}
+
 // サービス生成
 shared_ptr<NbService> NbService::CreateService(const string &endpoint_url, const string &tenant_id,
                                                const string &app_id, const string &app_key, const string &proxy) {
     NBLOG(TRACE) << __func__;
-    return shared_ptr<NbService>(new NbService(endpoint_url, tenant_id, app_id, app_key, proxy));
+    return shared_ptr<NbService>(new NbService(endpoint_url, tenant_id, app_id, app_key, proxy),
+                                 &NbService::DeleteService);
+}
+
+void NbService::DeleteService(NbService *service) {
+    if (service->IsAsyncLoopThread()) {
+        // 完了コールバックや結果オブジェクト経由でループスレッド上で最後の参照が解放された
+        std::thread([service] { delete service; }).detach();
+    } else {
+        delete service;
+    }
 }
 
 void NbService::SetDebugLogEnabled(bool flag) {
@@ -32,6 +136,18 @@ void NbService::SetRestLogEnabled(bool flag) {
     NbLogger::SetRestLogEnabled(flag);
 }
 
+shared_ptr<NbService> NbService::CreateService(const string &endpoint_url, const string &tenant_id,
+                                               const string &app_id, const string &app_key, const string &proxy,
+                                               int warm_up_num, bool warm_up_background) {
+    shared_ptr<NbService> service = CreateService(endpoint_url, tenant_id, app_id, app_key, proxy);
+    if (warm_up_background) {
+        service->WarmUpAsync(warm_up_num);
+    } else {
+        service->WarmUp(warm_up_num);
+    }
+    return service;
+}
+
 // コンストラクタ
 NbService::NbService(const string &endpoint_url, const string &tenant_id, const string &app_id,
                      const string &app_key, const string &proxy)
@@ -39,10 +155,41 @@ NbService::NbService(const string &endpoint_url, const string &tenant_id, const
     // curl_global_init()がスレッドセーフでないため、排他する
     std::lock_guard<std::mutex> lock(mutex_curl);
     curlpp::initialize();
+    curl_share_ = std::make_shared<NbCurlShare>();
 }
 
 // デストラクタ
 NbService::~NbService() {
+    // 事前接続の完了を待つ
+    {
+        std::lock_guard<std::mutex> lock(warm_up_mutex_);
+        if (warm_up_thread_.joinable()) {
+            if (warm_up_thread_.get_id() == std::this_thread::get_id()) {
+                // 完了コールバック内で破棄された場合は自スレッドをjoinできないため切り離す
+                warm_up_thread_.detach();
+            } else {
+                warm_up_thread_.join();
+            }
+        }
+    }
+
+    // 重複送信タイマーを停止し、ヘッジリクエストの転送完了を待つ(採用されなかった転送は中断済み)
+    {
+        std::lock_guard<std::mutex> lock(hedge_timer_mutex_);
+        hedge_timer_stop_ = true;
+        hedge_timer_cond_.notify_all();
+    }
+    if (hedge_timer_thread_.joinable()) {
+        hedge_timer_thread_.join();
+    }
+    {
+        std::unique_lock<std::mutex> lock(hedge_worker_mutex_);
+        hedge_worker_cond_.wait(lock, [this] { return hedge_worker_num_ == 0; });
+    }
+
+    // 実行中の非同期リクエストを中断し、curl_global_cleanup()前にマルチハンドルを解放する
+    async_engine_.reset();
+
     // curl_global_cleanup()がスレッドセーフでないため、排他する
     std::lock_guard<std::mutex> lock(mutex_curl);
     curlpp::terminate();
@@ -69,6 +216,133 @@ const string &NbService::GetProxy() const {
     return proxy_;
 }
 
+int NbService::GetConnectionWaitTimeout() const {
+    return connection_wait_timeout_;
+}
+
+void NbService::SetConnectionWaitTimeout(int timeout) {
+    connection_wait_timeout_ = (timeout > 0) ? timeout : 0;
+}
+
+NbRestExecutorPoolStatistics NbService::GetConnectionPoolStatistics() {
+    return rest_executor_pool_.GetStatistics();
+}
+
+bool NbService::IsConnectionReuseEnabled() const {
+    return connection_reuse_enabled_;
+}
+
+void NbService::SetConnectionReuseEnabled(bool flag) {
+    connection_reuse_enabled_ = flag;
+}
+
+bool NbService::IsHttp2Enabled() const {
+    return http2_enabled_;
+}
+
+void NbService::SetHttp2Enabled(bool flag) {
+    http2_enabled_ = flag;
+}
+
+bool NbService::IsResponseCompressionEnabled() const {
+    return response_compression_enabled_;
+}
+
+void NbService::SetResponseCompressionEnabled(bool flag) {
+    response_compression_enabled_ = flag;
+}
+
+int NbService::GetRequestCompressionThreshold() const {
+    return request_compression_threshold_;
+}
+
+void NbService::SetRequestCompressionThreshold(int threshold) {
+    request_compression_threshold_ = (threshold > 0) ? threshold : 0;
+}
+
+int NbService::GetFileDownloadBufferSize() const {
+    return file_download_buffer_size_;
+}
+
+void NbService::SetFileDownloadBufferSize(int size) {
+    file_download_buffer_size_ = (size > 0) ? size : 0;
+}
+
+bool NbService::IsFileDownloadSyncEnabled() const {
+    return file_download_sync_enabled_;
+}
+
+void NbService::SetFileDownloadSyncEnabled(bool flag) {
+    file_download_sync_enabled_ = flag;
+}
+
+int64_t NbService::GetUploadBandwidthLimit() const {
+    return upload_limiter_->GetRate();
+}
+
+void NbService::SetUploadBandwidthLimit(int64_t bytes_per_second) {
+    upload_limiter_->SetRate(bytes_per_second);
+}
+
+int64_t NbService::GetDownloadBandwidthLimit() const {
+    return download_limiter_->GetRate();
+}
+
+void NbService::SetDownloadBandwidthLimit(int64_t bytes_per_second) {
+    download_limiter_->SetRate(bytes_per_second);
+}
+
+int NbService::GetRequestRateLimit() const {
+    return static_cast<int>(request_limiter_.GetRate());
+}
+
+void NbService::SetRequestRateLimit(int requests_per_second) {
+    request_limiter_.SetRate(requests_per_second);
+}
+
+bool NbService::IsProcessCacheShareEnabled() const {
+    return process_cache_share_enabled_;
+}
+
+void NbService::SetProcessCacheShareEnabled(bool flag) {
+    // 払い出し中のExecutorは旧キャッシュを保持するため、次回払い出し時に切り替わる
+    process_cache_share_enabled_ = flag;
+    std::atomic_store(&curl_share_, flag ? NbCurlShare::GetProcessShare() : std::make_shared<NbCurlShare>());
+}
+
+NbRetryPolicy NbService::GetRetryPolicy() {
+    std::lock_guard<std::mutex> lock(retry_policy_mutex_);
+    return retry_policy_;
+}
+
+void NbService::SetRetryPolicy(const NbRetryPolicy &policy) {
+    std::lock_guard<std::mutex> lock(retry_policy_mutex_);
+    retry_policy_ = policy;
+}
+
+NbCircuitBreakerPolicy NbService::GetCircuitBreakerPolicy() {
+    return circuit_breaker_.GetPolicy();
+}
+
+void NbService::SetCircuitBreakerPolicy(const NbCircuitBreakerPolicy &policy) {
+    circuit_breaker_.SetPolicy(policy);
+}
+
+NbCircuitBreakerState NbService::GetCircuitBreakerState() {
+    return circuit_breaker_.GetState();
+}
+
+NbHedgePolicy NbService::GetHedgePolicy() {
+    std::lock_guard<std::mutex> lock(hedge_policy_mutex_);
+    return hedge_policy_;
+}
+
+void NbService::SetHedgePolicy(const NbHedgePolicy &policy) {
+    std::lock_guard<std::mutex> lock(hedge_policy_mutex_);
+    hedge_policy_ = policy;
+    hedge_latency_.Resize(policy.window_size);
+}
+
 NbSessionToken NbService::GetSessionToken() {
     std::lock_guard<std::mutex> lock(session_token_mutex_);
     return session_token_;
@@ -84,13 +358,115 @@ void NbService::ClearSessionToken() {
 }
 
 NbRestExecutor *NbService::PopRestExecutor() {
-    return rest_executor_pool_.PopRestExecutor();
+    return AcquireRestExecutor(connection_wait_timeout_);
+}
+
+NbRestExecutor *NbService::AcquireRestExecutor(int wait_timeout) {
+    return SetUpRestExecutor(rest_executor_pool_.PopRestExecutor(wait_timeout));
+}
+
+NbRestExecutor *NbService::TryAcquireRestExecutor() {
+    return SetUpRestExecutor(rest_executor_pool_.TryPopRestExecutor());
+}
+
+NbRestExecutor *NbService::SetUpRestExecutor(NbRestExecutor *executor) {
+    if (executor) {
+        ApplyExecutorSettings(executor);
+        executor->SetCurlShare(std::atomic_load(&curl_share_));
+    }
+    return executor;
+}
+
+void NbService::ApplyExecutorSettings(NbRestExecutor *executor) {
+    executor->SetConnectionReuse(connection_reuse_enabled_);
+    executor->SetHttp2(http2_enabled_);
+    executor->SetResponseCompression(response_compression_enabled_);
+    executor->SetRequestCompressionThreshold(request_compression_threshold_);
+    executor->SetFileDownloadBufferSize(file_download_buffer_size_);
+    executor->SetFileDownloadSync(file_download_sync_enabled_);
+    executor->SetBandwidthLimiter(upload_limiter_, download_limiter_);
 }
 
 void NbService::PushRestExecutor(NbRestExecutor *executor) {
     rest_executor_pool_.PushRestExecutor(executor);
 }
 
+void NbService::SubmitAsyncRequest(const NbHttpRequest &request, int timeout, NbRestAsyncEngine::Callback callback) {
+    NbRestAsyncEngine *engine;
+    {
+        std::lock_guard<std::mutex> lock(async_engine_mutex_);
+        if (!async_engine_) {
+            async_engine_.reset(new NbRestAsyncEngine(kHttpConnectionMax));
+            // 接続キャッシュはマルチハンドルで共有されるため、共有キャッシュは設定しない
+            async_engine_->SetExecutorSetup([this](NbRestExecutor *executor) { ApplyExecutorSettings(executor); });
+        }
+        engine = async_engine_.get();
+    }
+    engine->Submit(request, timeout, std::move(callback));
+}
+
+bool NbService::IsAsyncLoopThread() {
+    std::lock_guard<std::mutex> lock(async_engine_mutex_);
+    return async_engine_ && async_engine_->IsLoopThread();
+}
+
+NbWarmUpResult NbService::WarmUp(int connection_num) {
+    NBLOG(TRACE) << __func__ << " num:" << connection_num;
+    auto start = std::chrono::steady_clock::now();
+    NbWarmUpResult warm_up_result;
+
+    // 空き待ちはしない(実行中のREST APIが返却を待っている場合に追い越さない)
+    std::vector<NbRestExecutor *> executors;
+    for (int i = 0; i < connection_num; ++i) {
+        NbRestExecutor *executor = AcquireRestExecutor(0);
+        if (!executor) {
+            break;
+        }
+        executors.push_back(executor);
+    }
+
+    // 接続先はEndpoint URI(パスは問わないため、APIは実行しない)
+    NbHttpRequest request(endpoint_url_, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), string(), proxy_);
+    std::vector<NbResult<NbHttpResponse>> results(executors.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < executors.size(); ++i) {
+        threads.emplace_back([&executors, &results, &request, i] {
+            results[i] = executors[i]->Connect(request, kWarmUpTimeoutDefault);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (size_t i = 0; i < executors.size(); ++i) {
+        if (results[i].IsFatalError()) {
+            ++warm_up_result.failed_count;
+        } else {
+            ++warm_up_result.connected_count;
+        }
+        PushRestExecutor(executors[i]);
+    }
+
+    warm_up_result.elapsed_time_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    NBLOG(INFO) << "Warm up connected:" << warm_up_result.connected_count << " failed:"
+                << warm_up_result.failed_count << " elapsed(ms):" << warm_up_result.elapsed_time_ms;
+    return warm_up_result;
+}
+
+void NbService::WarmUpAsync(int connection_num, std::function<void(const NbWarmUpResult &)> callback) {
+    std::lock_guard<std::mutex> lock(warm_up_mutex_);
+    if (warm_up_thread_.joinable()) {
+        warm_up_thread_.join();
+    }
+    warm_up_thread_ = std::thread([this, connection_num, callback] {
+        NbWarmUpResult warm_up_result = WarmUp(connection_num);
+        if (callback) {
+            callback(warm_up_result);
+        }
+    });
+}
+
 NbHttpRequestFactory NbService::GetHttpRequestFactory() {
     std::lock_guard<std::mutex> lock(session_token_mutex_);
     return NbHttpRequestFactory(endpoint_url_, tenant_id_, app_id_, app_key_,
@@ -99,7 +475,8 @@ NbHttpRequestFactory NbService::GetHttpRequestFactory() {
 
 NbResult<NbHttpResponse> NbService::ExecuteCommon(
     std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
-    std::function<NbResult<NbHttpResponse>(NbRestExecutor *, const NbHttpRequest &)> executor_method) {
+    std::function<NbResult<NbHttpResponse>(NbRestExecutor *, const NbHttpRequest &)> executor_method,
+    bool retryable, NbRestExecutor *reserved_executor) {
                                                 
     NbResult<NbHttpResponse> result;
     //HTTPリクエスト作成
@@ -113,38 +490,491 @@ NbResult<NbHttpResponse> NbService::ExecuteCommon(
     //呼び元のリクエスト作成関数を実行
     NbHttpRequest request = create_request(request_factory);
 
+    return ExecutePooled(request, executor_method, retryable, reserved_executor);
+}
+
+NbResult<NbHttpResponse> NbService::ExecutePooled(
+    const NbHttpRequest &request,
+    std::function<NbResult<NbHttpResponse>(NbRestExecutor *, const NbHttpRequest &)> executor_method,
+    bool retryable, NbRestExecutor *reserved_executor) {
+
+    NbResult<NbHttpResponse> result;
+    // 遮断中はREST Executorを払い出さない
+    if (!circuit_breaker_.IsCallPermitted()) {
+        result.SetResultCode(NbResultCode::NB_ERROR_CIRCUIT_OPEN);
+        return result;
+    }
+
     //リクエスト実行
+    if (reserved_executor) {
+        // 予約済みのREST Executorは呼び出し元が返却する
+        return ExecuteWithRetry(request, [reserved_executor, &executor_method, &request] {
+            return executor_method(reserved_executor, request);
+        }, retryable);
+    }
     NbRestExecutor *executor = PopRestExecutor();
     if (!executor) {
         // 同時接続数オーバー
         result.SetResultCode(NbResultCode::NB_ERROR_CONNECTION_OVER);
         return result;
     }
-    result = executor_method(executor, request);
+    // リトライは同じExecutorで行い、他スレッドに接続を明け渡さない
+    result = ExecuteWithRetry(request, [executor, &executor_method, &request] {
+        return executor_method(executor, request);
+    }, retryable);
     PushRestExecutor(executor);
     return result;
 }
 
-NbResult<NbHttpResponse> NbService::ExecuteRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request, int timeout) {
-    return ExecuteCommon(create_request, 
+NbResult<NbHttpResponse> NbService::ExecuteWithRetry(const NbHttpRequest &request,
+                                                     std::function<NbResult<NbHttpResponse>()> attempt,
+                                                     bool retryable) {
+    NbRetryPolicy policy = GetRetryPolicy();
+    auto start = std::chrono::steady_clock::now();
+    int retry_count = 0;
+
+    auto guarded_attempt = [this, &attempt] {
+        if (!circuit_breaker_.TryAcquire()) {
+            NBLOG(INFO) << "Circuit breaker is open.";
+            return NbResult<NbHttpResponse>(NbResultCode::NB_ERROR_CIRCUIT_OPEN);
+        }
+        // リトライを含め、送信毎にリクエストレート制限を適用する
+        request_limiter_.Acquire(1);
+        auto attempt_start = std::chrono::steady_clock::now();
+        NbResult<NbHttpResponse> attempt_result = attempt();
+        circuit_breaker_.OnComplete(IsCircuitFailure(attempt_result),
+                                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                                        std::chrono::steady_clock::now() - attempt_start).count());
+        return attempt_result;
+    };
+
+    NbResult<NbHttpResponse> result = guarded_attempt();
+    while (retryable && retry_count + 1 < policy.max_attempts && IsRetryable(policy, request, result)) {
+        int backoff_ms = CalcBackoff(policy, retry_count);
+        if (policy.deadline_ms > 0) {
+            auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            if (elapsed_ms + backoff_ms >= policy.deadline_ms) {
+                NBLOG(INFO) << "Retry deadline exceeded. elapsed(ms):" << elapsed_ms;
+                break;
+            }
+        }
+        ++retry_count;
+        NBLOG(INFO) << "Retry request(" << retry_count << ") after " << backoff_ms << "ms. url:" << request.GetUrl()
+                    << " result:" << static_cast<int>(result.GetResultCode());
+        std::this_thread::sleep_for(std::chrono::milliseconds(backoff_ms));
+        result = guarded_attempt();
+    }
+
+    result.SetRetryCount(retry_count);
+    return result;
+}
+
+NbResult<NbHttpResponse> NbService::ExecuteRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request, int timeout,
+                                                   NbOperation operation) {
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = DispatchRequest(create_request, timeout);
+    RecordStatistics(operation, result, start);
+    return result;
+}
+
+NbResult<NbHttpResponse> NbService::DispatchRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                    int timeout) {
+    // HTTP/2モードでは非同期実行エンジンで実行し、並行するリクエストを同一接続上に多重化する
+    // 完了コールバック内からの呼び出しはイベントループを停止させるため、プールで実行する
+    //HTTPリクエスト作成
+    NbHttpRequestFactory request_factory = GetHttpRequestFactory();
+    if (request_factory.IsError()) {
+        //request構築エラー
+        return NbResult<NbHttpResponse>(request_factory.GetError());
+    }
+    NbHttpRequest request = create_request(request_factory);
+
+    if (http2_enabled_ && !IsAsyncLoopThread()) {
+        return ExecuteWithRetry(request, [this, &request, timeout] {
+            std::promise<NbResult<NbHttpResponse>> promise;
+            std::future<NbResult<NbHttpResponse>> future = promise.get_future();
+            SubmitAsyncRequest(request, timeout, [&promise](NbResult<NbHttpResponse> result) {
+                promise.set_value(std::move(result));
+            });
+            return future.get();
+        });
+    }
+
+    NbHedgePolicy hedge_policy = GetHedgePolicy();
+    // 重複送信は、呼び出し元が対象に設定した読み取りリクエストのみ
+    if (hedge_policy.enabled && request.IsHedgeable() &&
+        request.GetMethod() == NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET) {
+        if (!circuit_breaker_.IsCallPermitted()) {
+            return NbResult<NbHttpResponse>(NbResultCode::NB_ERROR_CIRCUIT_OPEN);
+        }
+        return ExecuteWithRetry(request, [this, &request, timeout, &hedge_policy] {
+            return ExecuteHedgedRequest(request, timeout, hedge_policy);
+        });
+    }
+
+    return ExecutePooled(request,
         [timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
             return executor->ExecuteRequest(request, timeout);
         });
 }
 
+NbResult<NbHttpResponse> NbService::ExecuteHedgedRequest(const NbHttpRequest &request, int timeout,
+                                                         const NbHedgePolicy &policy) {
+    NbRestExecutor *executor = PopRestExecutor();
+    if (!executor) {
+        // 同時接続数オーバー
+        return NbResult<NbHttpResponse>(NbResultCode::NB_ERROR_CONNECTION_OVER);
+    }
+
+    // 待ち時間は直近の所要時間のパーセンタイル値
+    int64_t delay_ms = policy.default_delay_ms;
+    if (hedge_latency_.GetCount() >= policy.minimum_samples) {
+        delay_ms = hedge_latency_.GetPercentile(policy.percentile);
+    }
+    delay_ms = std::max<int64_t>(delay_ms, policy.min_delay_ms);
+
+    auto state = std::make_shared<HedgeState>(&request, timeout);
+    state->running.push_back(executor);
+    ScheduleHedge(state, std::chrono::steady_clock::now() + std::chrono::milliseconds(delay_ms));
+
+    // 最初の転送は呼び出し元スレッドで行い、スレッドは重複送信する場合のみ生成する
+    RunHedgeTransfer(state, executor, request);
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    if (state->hedge_pending) {
+        state->hedge_pending = false;
+        if (!state->done) {
+            // 待ち時間内にリトライ可能なエラーで完了した場合は、待たずに呼び出し元スレッドで重複送信する
+            // 空きが無い場合は重複送信しない(他のリクエストの接続を奪わない)
+            NbRestExecutor *hedge_executor = TryAcquireRestExecutor();
+            if (hedge_executor) {
+                state->running.push_back(hedge_executor);
+                lock.unlock();
+                NBLOG(INFO) << "Send hedged request after failure. url:" << request.GetUrl();
+                RunHedgeTransfer(state, hedge_executor, request);
+                lock.lock();
+            }
+        }
+    }
+    state->CompleteIfFailed();
+    state->cond.wait(lock, [&state] { return state->done; });
+    // 結果を受け取るのは呼び出し元のみのため、複製せずに取り出す
+    return std::move(state->result);
+}
+
+void NbService::RunHedgeTransfer(const shared_ptr<HedgeState> &state, NbRestExecutor *executor,
+                                 const NbHttpRequest &request) {
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = executor->ExecuteRequest(request, state->timeout);
+    int64_t elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->running.erase(std::find(state->running.begin(), state->running.end(), executor));
+        if (!state->done && HedgeState::IsAcceptable(request, result)) {
+            state->done = true;
+            if (result.IsSuccess()) {
+                hedge_latency_.Add(elapsed_ms);
+            }
+            state->result = std::move(result);
+            // 残りの転送を中断する
+            for (auto other : state->running) {
+                other->Cancel();
+            }
+        } else if (!state->done) {
+            // 他の転送(重複送信前を含む)の完了を待つ
+            state->failure = std::move(result);
+            state->CompleteIfFailed();
+        }
+    }
+    state->cond.notify_all();
+
+    // runningから除いた後は中断要求されないため、ここで解除する
+    executor->ClearCancel();
+    PushRestExecutor(executor);
+}
+
+void NbService::StartHedgeWorker(const shared_ptr<HedgeState> &state, NbRestExecutor *executor) {
+    {
+        std::lock_guard<std::mutex> lock(hedge_worker_mutex_);
+        ++hedge_worker_num_;
+    }
+
+    // 採用されなかった転送は呼び出し元の復帰後も継続するため、リクエストは複製して渡す
+    NbHttpRequest request = *state->request;
+    std::thread([this, state, executor, request] {
+        RunHedgeTransfer(state, executor, request);
+
+        std::lock_guard<std::mutex> lock(hedge_worker_mutex_);
+        if (--hedge_worker_num_ == 0) {
+            hedge_worker_cond_.notify_all();
+        }
+    }).detach();
+}
+
+void NbService::ScheduleHedge(const shared_ptr<HedgeState> &state, std::chrono::steady_clock::time_point deadline) {
+    std::lock_guard<std::mutex> lock(hedge_timer_mutex_);
+    if (!hedge_timer_thread_.joinable()) {
+        hedge_timer_thread_ = std::thread([this] { RunHedgeTimer(); });
+    }
+    hedge_timers_.emplace(deadline, state);
+    hedge_timer_cond_.notify_one();
+}
+
+void NbService::RunHedgeTimer() {
+    std::unique_lock<std::mutex> lock(hedge_timer_mutex_);
+    while (!hedge_timer_stop_) {
+        if (hedge_timers_.empty()) {
+            hedge_timer_cond_.wait(lock);
+            continue;
+        }
+        auto next = hedge_timers_.begin();
+        if (std::chrono::steady_clock::now() < next->first) {
+            hedge_timer_cond_.wait_until(lock, next->first);
+            continue;
+        }
+        // 呼び出し元が完了済みの場合は期限切れ
+        shared_ptr<HedgeState> state = next->second.lock();
+        hedge_timers_.erase(next);
+        if (state) {
+            lock.unlock();
+            SendHedge(state);
+            lock.lock();
+        }
+    }
+}
+
+void NbService::SendHedge(const shared_ptr<HedgeState> &state) {
+    std::lock_guard<std::mutex> lock(state->mutex);
+    if (!state->hedge_pending || state->done) {
+        return;
+    }
+    state->hedge_pending = false;
+
+    // 空きが無い場合は重複送信しない(他のリクエストの接続を奪わない)
+    NbRestExecutor *executor = TryAcquireRestExecutor();
+    if (!executor) {
+        state->CompleteIfFailed();
+        state->cond.notify_all();
+        return;
+    }
+    NBLOG(INFO) << "Send hedged request. url:" << state->request->GetUrl();
+    state->running.push_back(executor);
+    StartHedgeWorker(state, executor);
+}
+
+NbResult<NbHttpResponse> NbService::ExecuteStreamRequest(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                         std::function<bool(const char *, size_t)> sink, int timeout,
+                                                         NbOperation operation) {
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = ExecuteCommon(create_request,
+        [&sink, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
+            return executor->ExecuteStreamRequest(request, sink, timeout);
+        }, false);
+    RecordStatistics(operation, result, start);
+    return result;
+}
+
+NbResult<NbHttpResponse> NbService::ExecuteStreamUpload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                        std::function<int64_t(char *, size_t)> producer,
+                                                        int64_t content_length, int timeout, NbOperation operation) {
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = ExecuteCommon(create_request,
+        [&producer, content_length, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
+            return executor->ExecuteStreamUpload(request, producer, content_length, timeout);
+        }, false);
+    RecordStatistics(operation, result, start);
+    return result;
+}
+
 NbResult<NbHttpResponse> NbService::ExecuteFileDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
                                                         const std::string &file_path, int timeout) {
-    return ExecuteCommon(create_request,
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = ExecuteCommon(create_request,
         [&file_path, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
             return executor->ExecuteFileDownload(request, file_path, timeout);
         });
+    RecordStatistics(NbOperation::FILE_DOWNLOAD, result, start);
+    return result;
+}
+
+NbResult<NbHttpResponse> NbService::ExecuteFileResumeDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                              const std::string &file_path, const std::string &etag,
+                                                              int timeout) {
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = ExecuteCommon(create_request,
+        [&file_path, &etag, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
+            return executor->ExecuteFileResumeDownload(request, file_path, etag, timeout);
+        });
+    RecordStatistics(NbOperation::FILE_DOWNLOAD, result, start);
+    return result;
+}
+
+NbResult<NbHttpResponse> NbService::ExecuteBufferDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                          char *buffer, size_t capacity, size_t *size, int timeout) {
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = ExecuteCommon(create_request,
+        [buffer, capacity, size, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
+            // リトライ時は先頭から書き直す
+            *size = 0;
+            bool overflow = false;
+            NbResult<NbHttpResponse> attempt_result = executor->ExecuteStreamRequest(request,
+                [buffer, capacity, size, &overflow](const char *data, size_t data_size) {
+                    if (data_size > capacity - *size) {
+                        overflow = true;
+                        return false;
+                    }
+                    std::memcpy(buffer + *size, data, data_size);
+                    *size += data_size;
+                    return true;
+                }, timeout);
+            if (overflow) {
+                NBLOG(ERROR) << "Download buffer overflow. capacity:" << capacity;
+                attempt_result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+            }
+            return attempt_result;
+        });
+    RecordStatistics(NbOperation::FILE_DOWNLOAD, result, start);
+    return result;
+}
+
+NbResult<NbHttpResponse> NbService::ExecuteRangeDownload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                         NbRestExecutor *executor, int fd, int64_t offset,
+                                                         int64_t length, int timeout) {
+    return ExecuteCommon(create_request,
+        [fd, offset, length, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
+            // リトライ時は範囲の先頭から書き直す
+            int64_t written = 0;
+            bool write_error = false;
+            NbResult<NbHttpResponse> attempt_result = executor->ExecuteStreamRequest(request,
+                [fd, offset, length, &written, &write_error](const char *data, size_t size) {
+                    // 範囲外のデータ(Range非対応サーバの応答)は書き込まない
+                    if (static_cast<int64_t>(size) > length - written) {
+                        write_error = true;
+                        return false;
+                    }
+                    while (size > 0) {
+                        ssize_t result = pwrite(fd, data, size, offset + written);
+                        if (result < 0) {
+                            if (errno == EINTR) {
+                                continue;
+                            }
+                            NBLOG(ERROR) << "pwrite error errno:" << errno;
+                            write_error = true;
+                            return false;
+                        }
+                        data += result;
+                        size -= result;
+                        written += result;
+                    }
+                    return true;
+                }, timeout);
+            if (write_error || (attempt_result.IsSuccess() && written != length)) {
+                NBLOG(ERROR) << "Range download failed. offset:" << offset << " length:" << length
+                             << " written:" << written;
+                attempt_result.SetResultCode(NbResultCode::NB_ERROR_FILE_DOWNLOAD);
+            }
+            return attempt_result;
+        }, true, executor);
+}
+
+std::vector<NbRestExecutor *> NbService::ReserveRestExecutors(int max_count) {
+    std::vector<NbRestExecutor *> executors;
+    if (max_count < 1) {
+        return executors;
+    }
+    NbRestExecutor *executor = PopRestExecutor();
+    while (executor) {
+        executors.push_back(executor);
+        if (static_cast<int>(executors.size()) >= max_count) {
+            break;
+        }
+        // 他の処理のREST Executorを待たないよう、2つ目以降は空きのみ払い出す(空きが無くてもエラーとしない)
+        executor = TryAcquireRestExecutor();
+    }
+    return executors;
+}
+
+void NbService::ReleaseRestExecutors(const std::vector<NbRestExecutor *> &executors) {
+    for (auto executor : executors) {
+        PushRestExecutor(executor);
+    }
+}
+
+NbResult<NbHttpResponse> NbService::ExecuteBufferUpload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
+                                                        const char *data, size_t size, int timeout) {
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = ExecuteCommon(create_request,
+        [data, size, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
+            // リトライ時は先頭から送信し直す
+            size_t offset = 0;
+            return executor->ExecuteStreamUpload(request,
+                [data, size, &offset](char *buffer, size_t buffer_size) -> int64_t {
+                    size_t copy_size = std::min(buffer_size, size - offset);
+                    std::memcpy(buffer, data + offset, copy_size);
+                    offset += copy_size;
+                    return static_cast<int64_t>(copy_size);
+                }, static_cast<int64_t>(size), timeout);
+        });
+    RecordStatistics(NbOperation::FILE_UPLOAD, result, start);
+    return result;
 }
 
 NbResult<NbHttpResponse> NbService::ExecuteFileUpload(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request,
                                                       const std::string &file_path, int timeout) {
-    return ExecuteCommon(create_request,
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = ExecuteCommon(create_request,
         [&file_path, timeout](NbRestExecutor *executor, const NbHttpRequest &request) {
             return executor->ExecuteFileUpload(request, file_path, timeout);
         });
+    RecordStatistics(NbOperation::FILE_UPLOAD, result, start);
+    return result;
+}
+
+void NbService::ExecuteRequestAsync(std::function<NbHttpRequest(NbHttpRequestFactory &)> create_request, int timeout,
+                                    NbRestAsyncEngine::Callback callback, NbOperation operation) {
+    // 完了時に統計情報を記録してから呼び出し元のコールバックを呼び出す
+    auto start = std::chrono::steady_clock::now();
+    NbRestAsyncEngine::Callback recorded_callback = [this, operation, start, callback](NbResult<NbHttpResponse> result) {
+        RecordStatistics(operation, result, start);
+        if (callback) {
+            callback(std::move(result));
+        }
+    };
+
+    //HTTPリクエスト作成
+    NbHttpRequestFactory request_factory = GetHttpRequestFactory();
+    if (request_factory.IsError()) {
+        //request構築エラー
+        recorded_callback(NbResult<NbHttpResponse>(request_factory.GetError()));
+        return;
+    }
+
+    //呼び元のリクエスト作成関数を実行
+    NbHttpRequest request = create_request(request_factory);
+
+    //非同期実行エンジンへ登録
+    //イベントループを止めないよう、リクエストレート制限は登録前に呼び出し元スレッドで待機する
+    request_limiter_.Acquire(1);
+    SubmitAsyncRequest(request, timeout, std::move(recorded_callback));
+}
+
+NbStatistics NbService::GetStatistics() {
+    NbStatistics statistics;
+    metrics_.GetStatistics(&statistics);
+    statistics.connection_pool = rest_executor_pool_.GetStatistics();
+    return statistics;
+}
+
+void NbService::ResetStatistics() {
+    metrics_.Reset();
+}
+
+void NbService::RecordStatistics(NbOperation operation, const NbResult<NbHttpResponse> &result,
+                                 std::chrono::steady_clock::time_point start) {
+    metrics_.Record(operation, result, std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start).count());
 }
 } //namespace necbaas
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2017 NEC Corporation
+ */
+
+#include "necbaas/nb_statistics.h"
+#include <algorithm>
+
+namespace necbaas {
+
+using std::vector;
+
+// 2のべき乗区間の分割数(ビット数)
+static const int kSubBucketBits = 4;
+static const int kSubBucketNum = 1 << kSubBucketBits;
+// 分割せずに1us単位で集計する上限(この値未満は値そのものを区間番号とする)
+static const int64_t kLinearMax = kSubBucketNum * 2;
+// 集計する最大のべき乗(2^40us = 約12日。超過分は最終区間に含める)
+static const int kMaxExponent = 40;
+
+const int NbLatencyHistogram::kBucketNum;
+static_assert(NbLatencyHistogram::kBucketNum == kLinearMax + (kMaxExponent - kSubBucketBits - 1) * kSubBucketNum,
+              "kBucketNum mismatch");
+
+NbLatencyHistogram::NbLatencyHistogram() : counts_(kBucketNum, 0) {}
+
+uint64_t NbLatencyHistogram::GetCount() const {
+    return count_;
+}
+
+int64_t NbLatencyHistogram::GetMin() const {
+    return min_;
+}
+
+int64_t NbLatencyHistogram::GetMax() const {
+    return max_;
+}
+
+double NbLatencyHistogram::GetMean() const {
+    return (count_ > 0) ? static_cast<double>(sum_) / count_ : 0;
+}
+
+int64_t NbLatencyHistogram::GetPercentile(double percentile) const {
+    if (count_ == 0) {
+        return 0;
+    }
+    percentile = std::max(0.0, std::min(100.0, percentile));
+    uint64_t rank = static_cast<uint64_t>(percentile * count_ / 100 + 0.5);
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t accumulated = 0;
+    for (int i = 0; i < kBucketNum; ++i) {
+        accumulated += counts_[i];
+        if (accumulated >= rank) {
+            return std::min(GetBucketUpperBound(i), max_);
+        }
+    }
+    return max_;
+}
+
+vector<std::pair<int64_t, uint64_t>> NbLatencyHistogram::GetBuckets() const {
+    vector<std::pair<int64_t, uint64_t>> buckets;
+    for (int i = 0; i < kBucketNum; ++i) {
+        if (counts_[i] > 0) {
+            buckets.emplace_back(GetBucketUpperBound(i), counts_[i]);
+        }
+    }
+    return buckets;
+}
+
+int NbLatencyHistogram::GetBucketIndex(int64_t value_us) {
+    if (value_us < kLinearMax) {
+        return (value_us > 0) ? static_cast<int>(value_us) : 0;
+    }
+    int exponent = 63 - __builtin_clzll(static_cast<uint64_t>(value_us));
+    if (exponent >= kMaxExponent) {
+        return kBucketNum - 1;
+    }
+    // 上位kSubBucketBitsビット(先頭の1を除く)で区間内の位置を決める
+    int sub_index = static_cast<int>((value_us >> (exponent - kSubBucketBits)) & (kSubBucketNum - 1));
+    return kLinearMax + (exponent - kSubBucketBits - 1) * kSubBucketNum + sub_index;
+}
+
+int64_t NbLatencyHistogram::GetBucketUpperBound(int index) {
+    if (index < kLinearMax) {
+        return index;
+    }
+    int exponent = (index - kLinearMax) / kSubBucketNum + kSubBucketBits + 1;
+    int64_t sub_index = (index - kLinearMax) % kSubBucketNum;
+    int64_t width = static_cast<int64_t>(1) << (exponent - kSubBucketBits);
+    return ((kSubBucketNum + sub_index) << (exponent - kSubBucketBits)) + width - 1;
+}
+
+void NbLatencyHistogram::Set(const vector<uint64_t> &counts, int64_t sum_us, int64_t min_us, int64_t max_us) {
+    counts_ = counts;
+    counts_.resize(kBucketNum, 0);
+    count_ = 0;
+    for (auto count : counts_) {
+        count_ += count;
+    }
+    sum_ = sum_us;
+    min_ = min_us;
+    max_ = max_us;
+}
+} //namespace necbaas
@@ -63,10 +63,12 @@ NbResult<NbUser> NbUser::Login(const shared_ptr<NbService> &service, const strin
                                   .Body(body_json.ToJsonString())
                                   .SessionNone()
                                   .Build();
-        }, timeout);
+        }, timeout, NbOperation::LOGIN);
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {    
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
 
@@ -99,13 +101,15 @@ NbResult<NbUser> NbUser::Logout(const shared_ptr<NbService> &service, int timeou
         [](NbHttpRequestFactory &request_factory) -> NbHttpRequest {
             return request_factory.Delete(kLoginUrl)
                                   .Build();
-        }, timeout);
+        }, timeout, NbOperation::LOGOUT);
 
     // 一律セッショントークンクリア
     service->ClearSessionToken();
 
     result.SetResultCode(rest_result.GetResultCode());
 
+    result.SetRestInfo(rest_result);
+
     if (rest_result.IsSuccess()) {
         const NbHttpResponse &http_response = rest_result.GetSuccessData();
 
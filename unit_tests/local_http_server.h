@@ -0,0 +1,308 @@
+#ifndef NECBAAS_LOCALHTTPSERVER_H
+#define NECBAAS_LOCALHTTPSERVER_H
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cctype>
+#include <algorithm>
+#include <cstdint>
+
+namespace necbaas {
+
+// テスト用ローカルHTTPサーバ
+// 127.0.0.1の空きポートで待ち受け、全リクエストに固定レスポンスを返す(keep-alive対応)
+// extra_headersには追加するレスポンスヘッダを"Name: value\r\n"形式で指定する
+// SetStatusCodes()で、先頭のリクエストから順に返すステータスコードを指定できる(以降は200)
+// SetResponseDelays()で、先頭のリクエストから順に応答までの遅延(ミリ秒)を指定できる(以降は遅延なし)
+// SetBodySize()で、固定ボディの代わりに指定サイズのボディを生成して返す(大容量ファイルの疑似サーバ用)
+// 1MBを超えるリクエストボディは保持せずに読み捨て、サイズのみ記録する
+class LocalHttpServer {
+  public:
+    explicit LocalHttpServer(const std::string &body = "hello", const std::string &extra_headers = "")
+        : body_(body), extra_headers_(extra_headers) {
+        listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        int on = 1;
+        setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+        listen(listen_fd_, 128);
+        socklen_t len = sizeof(addr);
+        getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        accept_thread_ = std::thread([this] { Accept(); });
+    }
+
+    ~LocalHttpServer() {
+        shutdown(listen_fd_, SHUT_RDWR);
+        close(listen_fd_);
+        accept_thread_.join();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            stop_cond_.notify_all();
+            for (auto fd : client_fds_) {
+                shutdown(fd, SHUT_RDWR);
+            }
+        }
+        for (auto &thread : client_threads_) {
+            thread.join();
+        }
+    }
+
+    std::string GetUrl(const std::string &path = "/api/1/tenant/path") const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+
+    // 先頭のリクエストから順に返すステータスコードを設定
+    void SetStatusCodes(const std::vector<int> &status_codes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        status_codes_ = status_codes;
+    }
+
+    // 先頭のリクエストから順に応答までの遅延(ミリ秒)を設定
+    void SetResponseDelays(const std::vector<int> &delays) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        delays_ = delays;
+    }
+
+    // 生成ボディのサイズを設定(offsetの位置のデータはGetBodyByte(offset))
+    void SetBodySize(uint64_t size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        generated_body_ = true;
+        body_size_ = size;
+    }
+
+    // 生成ボディのデータ
+    static char GetBodyByte(uint64_t offset) {
+        return static_cast<char>('a' + offset % 26);
+    }
+
+    // 受け付けたTCP接続数
+    int GetConnectionCount() const {
+        return connection_count_;
+    }
+
+    // 受信したリクエスト数
+    int GetRequestCount() const {
+        return request_count_;
+    }
+
+    // 受信したリクエスト全体(ヘッダ・ボディ、受信順)
+    std::vector<std::string> GetRequests() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return requests_;
+    }
+
+    // 受信したリクエストライン(受信順)
+    std::vector<std::string> GetRequestLines() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return request_lines_;
+    }
+
+    // 受信したリクエストボディのサイズ(受信順、chunkedの場合は0)
+    std::vector<uint64_t> GetRequestBodySizes() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return request_body_sizes_;
+    }
+
+  private:
+    void Accept() {
+        while (true) {
+            int fd = accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                return;
+            }
+            ++connection_count_;
+            std::lock_guard<std::mutex> lock(mutex_);
+            client_fds_.push_back(fd);
+            client_threads_.emplace_back([this, fd] { Serve(fd); });
+        }
+    }
+
+    void Serve(int fd) {
+        std::string buffer;
+        char data[4096];
+        while (true) {
+            // ヘッダ受信
+            size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t size = read(fd, data, sizeof(data));
+                if (size <= 0) {
+                    close(fd);
+                    return;
+                }
+                buffer.append(data, size);
+            }
+            // 100-continue要求には即時応答する
+            size_t pos = buffer.find("Expect: 100-continue");
+            if (pos != std::string::npos && pos < header_end) {
+                const std::string continue_response = "HTTP/1.1 100 Continue\r\n\r\n";
+                if (write(fd, continue_response.c_str(), continue_response.size()) < 0) {
+                    close(fd);
+                    return;
+                }
+            }
+            // ボディ読み捨て(chunkedの場合は終端チャンクまで)
+            pos = buffer.find("Transfer-Encoding: chunked");
+            bool chunked = (pos != std::string::npos && pos < header_end);
+            uint64_t content_length = 0;
+            pos = buffer.find("Content-Length: ");
+            if (pos != std::string::npos && pos < header_end) {
+                content_length = std::strtoull(buffer.c_str() + pos + 16, nullptr, 10);
+            }
+            if (!chunked && content_length > kStoredBodyMax) {
+                // 大容量のボディは保持せずに読み捨てる
+                uint64_t remaining = content_length - std::min<uint64_t>(buffer.size() - header_end - 4, content_length);
+                buffer.erase(header_end + 4, content_length - remaining);
+                std::vector<char> discard(64 * 1024);
+                while (remaining > 0) {
+                    ssize_t size = read(fd, discard.data(), std::min<uint64_t>(remaining, discard.size()));
+                    if (size <= 0) {
+                        close(fd);
+                        return;
+                    }
+                    remaining -= size;
+                }
+            }
+            size_t request_size = header_end + 4 + ((content_length > kStoredBodyMax) ? 0 : content_length);
+            while (chunked) {
+                size_t last_chunk = buffer.find("\r\n0\r\n\r\n", header_end + 2);
+                if (last_chunk != std::string::npos) {
+                    request_size = last_chunk + 7;
+                    break;
+                }
+                ssize_t size = read(fd, data, sizeof(data));
+                if (size <= 0) {
+                    close(fd);
+                    return;
+                }
+                buffer.append(data, size);
+            }
+            while (buffer.size() < request_size) {
+                ssize_t size = read(fd, data, sizeof(data));
+                if (size <= 0) {
+                    close(fd);
+                    return;
+                }
+                buffer.append(data, size);
+            }
+            int status_code = 200;
+            int delay = 0;
+            bool generated_body = false;
+            uint64_t body_size = body_.size();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                request_lines_.push_back(buffer.substr(0, buffer.find("\r\n")));
+                requests_.push_back(buffer.substr(0, request_size));
+                request_body_sizes_.push_back(content_length);
+                if (generated_body_) {
+                    generated_body = true;
+                    body_size = body_size_;
+                }
+                if (requests_.size() <= status_codes_.size()) {
+                    status_code = status_codes_[requests_.size() - 1];
+                }
+                if (requests_.size() <= delays_.size()) {
+                    delay = delays_[requests_.size() - 1];
+                }
+            }
+            // HEADリクエストにはボディを返さない
+            bool head = (buffer.compare(0, 5, "HEAD ") == 0);
+            // Range指定(bytes=first-last)には該当範囲を206で返す
+            uint64_t body_offset = 0;
+            uint64_t response_size = body_size;
+            std::string range_header;
+            size_t range_pos = buffer.find("Range: bytes=");
+            if (status_code == 200 && range_pos != std::string::npos && range_pos < header_end) {
+                char *end = nullptr;
+                uint64_t first = std::strtoull(buffer.c_str() + range_pos + 13, &end, 10);
+                uint64_t last = (body_size == 0) ? 0 : body_size - 1;
+                if (*end == '-' && std::isdigit(static_cast<unsigned char>(end[1]))) {
+                    last = std::min<uint64_t>(std::strtoull(end + 1, nullptr, 10), last);
+                }
+                if (first <= last && first < body_size) {
+                    status_code = 206;
+                    body_offset = first;
+                    response_size = last - first + 1;
+                    range_header = "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) +
+                                   "/" + std::to_string(body_size) + "\r\n";
+                }
+            }
+            buffer.erase(0, request_size);
+            ++request_count_;
+
+            if (delay > 0) {
+                // 停止時は遅延を打ち切る
+                std::unique_lock<std::mutex> lock(mutex_);
+                stop_cond_.wait_for(lock, std::chrono::milliseconds(delay), [this] { return stopping_; });
+            }
+
+            std::string response = "HTTP/1.1 " + std::to_string(status_code) + " Status\r\nContent-Length: " +
+                                   std::to_string(response_size) + "\r\n" + range_header + extra_headers_ + "\r\n";
+            if (!head && !generated_body) {
+                response += body_.substr(body_offset, response_size);
+            }
+            // クライアントが切断済みの場合にSIGPIPEを発生させない
+            if (send(fd, response.c_str(), response.size(), MSG_NOSIGNAL) < 0 ||
+                (!head && generated_body && !SendGeneratedBody(fd, body_offset, response_size))) {
+                close(fd);
+                return;
+            }
+        }
+    }
+
+    // 生成ボディを分割して送信
+    bool SendGeneratedBody(int fd, uint64_t offset, uint64_t size) {
+        std::vector<char> chunk(64 * 1024);
+        while (size > 0) {
+            size_t chunk_size = std::min<uint64_t>(size, chunk.size());
+            for (size_t i = 0; i < chunk_size; ++i) {
+                chunk[i] = GetBodyByte(offset + i);
+            }
+            if (send(fd, chunk.data(), chunk_size, MSG_NOSIGNAL) < 0) {
+                return false;
+            }
+            offset += chunk_size;
+            size -= chunk_size;
+        }
+        return true;
+    }
+
+    static const uint64_t kStoredBodyMax = 1024 * 1024;
+
+    std::string body_;
+    std::string extra_headers_;
+    int listen_fd_;
+    int port_;
+    std::thread accept_thread_;
+    std::mutex mutex_;
+    std::vector<int> client_fds_;
+    std::vector<std::thread> client_threads_;
+    std::vector<std::string> request_lines_;
+    std::vector<std::string> requests_;
+    std::vector<uint64_t> request_body_sizes_;
+    std::vector<int> status_codes_;
+    std::vector<int> delays_;
+    std::condition_variable stop_cond_;
+    bool stopping_{false};
+    bool generated_body_{false};
+    uint64_t body_size_{0};
+    std::atomic<int> connection_count_{0};
+    std::atomic<int> request_count_{0};
+};
+}  // namespace necbaas
+
+#endif  // NECBAAS_LOCALHTTPSERVER_H
@@ -3,6 +3,8 @@
 #include "necbaas/nb_api_gateway.h"
 #include "necbaas/internal/nb_utility.h"
 #include "rest_api_mock.h"
+#include "local_http_server.h"
+#include <cstring>
 
 namespace necbaas {
 
@@ -402,6 +404,57 @@ TEST_F(NbApiGatewayTest, ExecuteCustomApiConnectionOver) {
     EXPECT_EQ(NbResultCode::NB_ERROR_CONNECTION_OVER, result.GetResultCode());
 }
 
+//NbApiGateway::ExecuteCustomApiAsync(POST, 全て設定)
+TEST_F(NbApiGatewayTest, ExecuteCustomApiAsync) {
+    SetExpectAsync(&PostNorm2);
+
+    shared_ptr<NbService> service(mock_service_);
+
+    NbApiGateway apigw(service, kApiname, NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST, kSubpath);
+    apigw.AddHeader("X-HEADER-KEY1", "abcdef");
+    apigw.AddParameter("where", "param1");
+    apigw.SetContentType("text/plain");
+    int callback_count = 0;
+    std::future<NbResult<NbHttpResponse>> future = apigw.ExecuteCustomApiAsync(kRequestBody,
+        [&callback_count](const NbResult<NbHttpResponse> &result) {
+            EXPECT_TRUE(result.IsSuccess());
+            ++callback_count;
+        });
+    NbResult<NbHttpResponse> result = future.get();
+
+    // 戻り値確認
+    EXPECT_EQ(1, callback_count);
+    EXPECT_TRUE(result.IsSuccess());
+    NbHttpResponse response = result.GetSuccessData();
+    EXPECT_EQ(200, response.GetStatusCode());
+    EXPECT_EQ(kResponseBody, response.GetBody());
+}
+
+//NbApiGateway::ExecuteCustomApiAsync(POST, Content-Type未設定)
+TEST_F(NbApiGatewayTest, ExecuteCustomApiAsyncContentTypeNone) {
+    shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+
+    NbApiGateway apigw(service, kApiname, NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST, kSubpath);
+    NbResult<NbHttpResponse> result = apigw.ExecuteCustomApiAsync(string(kRequestBody.begin(), kRequestBody.end())).get();
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsFatalError());
+    EXPECT_EQ(NbResultCode::NB_ERROR_CONTENT_TYPE, result.GetResultCode());
+}
+
+//NbApiGateway::ExecuteCustomApiAsync(api_name空)
+TEST(NbApiGateway, ExecuteCustomApiAsyncNameEmpty) {
+    shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+
+    NbApiGateway apigw(service, kEmpty, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, kEmpty);
+
+    NbResult<NbHttpResponse> result = apigw.ExecuteCustomApiAsync().get();
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsFatalError());
+    EXPECT_EQ(NbResultCode::NB_ERROR_API_NAME, result.GetResultCode());
+}
+
 //NbApiGateway::Headers操作
 TEST(NbApiGateway, Headers) {
     shared_ptr<NbService> service = NbService::CreateService(kEmpty, kTenantId, kAppId, kAppKey, kProxy);
@@ -540,4 +593,108 @@ TEST(NbApiGateway, Parameters) {
     apigw.ClearParameters();
     EXPECT_TRUE(apigw.GetParameters().empty());
 }
+
+//NbApiGateway::ExecuteCustomApi(レスポンスボディのストリーミング受信)
+TEST(NbApiGateway, ExecuteCustomApiSink) {
+    string body(100000, 'x');
+    LocalHttpServer server(body);
+    server.SetStatusCodes({200, 200, 500});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    NbApiGateway apigw(service, kApiname, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET);
+
+    string received;
+    NbResult<NbHttpResponse> result = apigw.ExecuteCustomApi(kEmpty, [&received](const char *data, size_t size) {
+        received.append(data, size);
+        return true;
+    });
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(200, result.GetSuccessData().GetStatusCode());
+    EXPECT_TRUE(result.GetSuccessData().GetBody().empty());
+    EXPECT_EQ(body, received);
+
+    // 中断
+    result = apigw.ExecuteCustomApi(kEmpty, [](const char *data, size_t size) {
+        return false;
+    });
+    EXPECT_EQ(NbResultCode::NB_ERROR_CANCELED, result.GetResultCode());
+
+    // エラー時は出力しない
+    bool called = false;
+    result = apigw.ExecuteCustomApi(kEmpty, [&called](const char *data, size_t size) {
+        called = true;
+        return true;
+    });
+    ASSERT_TRUE(result.IsRestError());
+    EXPECT_EQ(500, result.GetRestError().status_code);
+    EXPECT_EQ(body, result.GetRestError().reason);
+    EXPECT_FALSE(called);
+}
+
+//NbApiGateway::ExecuteCustomApi(ファイルディスクリプタ出力)
+TEST(NbApiGateway, ExecuteCustomApiFd) {
+    LocalHttpServer server("0123456789");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    NbApiGateway apigw(service, kApiname, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET);
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    NbResult<NbHttpResponse> result = apigw.ExecuteCustomApi(kEmpty, fds[1]);
+    close(fds[1]);
+    ASSERT_TRUE(result.IsSuccess());
+
+    char buf[32] = {};
+    EXPECT_EQ(10, read(fds[0], buf, sizeof(buf)));
+    EXPECT_STREQ("0123456789", buf);
+    close(fds[0]);
+
+    // 書込みエラー
+    result = apigw.ExecuteCustomApi(kEmpty, -1);
+    EXPECT_EQ(NbResultCode::NB_ERROR_CANCELED, result.GetResultCode());
+}
+
+//NbApiGateway::ExecuteCustomApi(リクエストボディ生成関数)
+TEST(NbApiGateway, ExecuteCustomApiProducer) {
+    LocalHttpServer server("OK");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    NbApiGateway apigw(service, kApiname, NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST);
+
+    string body(100000, 'x');
+    size_t offset = 0;
+    auto producer = [&body, &offset](char *buffer, size_t size) -> int64_t {
+        size_t copy_size = std::min(size, body.size() - offset);
+        std::memcpy(buffer, body.c_str() + offset, copy_size);
+        offset += copy_size;
+        return copy_size;
+    };
+
+    // Content-Type未設定
+    NbResult<NbHttpResponse> result = apigw.ExecuteCustomApi(producer, body.size());
+    EXPECT_EQ(NbResultCode::NB_ERROR_CONTENT_TYPE, result.GetResultCode());
+
+    // サイズ指定(Content-Length)
+    apigw.SetContentType("application/octet-stream");
+    result = apigw.ExecuteCustomApi(producer, body.size());
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(body.size(), offset);
+
+    // サイズ不明(chunked)
+    offset = 0;
+    result = apigw.ExecuteCustomApi(producer);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(body.size(), offset);
+
+    vector<string> requests = server.GetRequests();
+    ASSERT_EQ(2, requests.size());
+    EXPECT_NE(string::npos, requests[0].find("Content-Length: 100000\r\n"));
+    EXPECT_NE(string::npos, requests[0].find("Content-Type: application/octet-stream\r\n"));
+    EXPECT_NE(string::npos, requests[0].find(body));
+    EXPECT_NE(string::npos, requests[1].find("Transfer-Encoding: chunked\r\n"));
+    EXPECT_EQ(string::npos, requests[1].find("Content-Length:"));
+
+    // 中断
+    result = apigw.ExecuteCustomApi([](char *buffer, size_t size) -> int64_t {
+        return -1;
+    }, 10);
+    EXPECT_EQ(NbResultCode::NB_ERROR_CANCELED, result.GetResultCode());
+}
 } //namespace necbaas
@@ -0,0 +1,132 @@
+#include "gtest/gtest.h"
+#include "necbaas/internal/nb_circuit_breaker.h"
+#include <thread>
+
+namespace necbaas {
+
+static NbCircuitBreakerPolicy MakePolicy() {
+    NbCircuitBreakerPolicy policy;
+    policy.enabled = true;
+    policy.window_size = 4;
+    policy.minimum_calls = 4;
+    policy.failure_rate_threshold = 50;
+    policy.slow_call_threshold_ms = 1000;
+    policy.slow_call_rate_threshold = 100;
+    policy.open_duration_ms = 50;
+    policy.half_open_calls = 2;
+    return policy;
+}
+
+//NbCircuitBreaker(無効)
+TEST(NbCircuitBreaker, Disabled) {
+    NbCircuitBreaker breaker;
+    EXPECT_FALSE(breaker.GetPolicy().enabled);
+    for (int i = 0; i < 30; ++i) {
+        ASSERT_TRUE(breaker.TryAcquire());
+        breaker.OnComplete(true, 0);
+    }
+    EXPECT_EQ(NbCircuitBreakerState::CLOSED, breaker.GetState());
+    EXPECT_TRUE(breaker.IsCallPermitted());
+}
+
+//NbCircuitBreaker(失敗率による遮断)
+TEST(NbCircuitBreaker, OpenByFailureRate) {
+    NbCircuitBreaker breaker;
+    breaker.SetPolicy(MakePolicy());
+
+    // 最小数に達するまでは遮断しない
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(breaker.TryAcquire());
+        breaker.OnComplete(true, 0);
+    }
+    EXPECT_EQ(NbCircuitBreakerState::CLOSED, breaker.GetState());
+
+    ASSERT_TRUE(breaker.TryAcquire());
+    breaker.OnComplete(false, 0);
+    EXPECT_EQ(NbCircuitBreakerState::OPEN, breaker.GetState());
+    EXPECT_FALSE(breaker.IsCallPermitted());
+    EXPECT_FALSE(breaker.TryAcquire());
+}
+
+//NbCircuitBreaker(古い結果は判定に使用しない)
+TEST(NbCircuitBreaker, Window) {
+    NbCircuitBreaker breaker;
+    breaker.SetPolicy(MakePolicy());
+
+    // 失敗率25%
+    const bool failures[] = {true, false, false, false, false, true, false};
+    for (bool failure : failures) {
+        ASSERT_TRUE(breaker.TryAcquire());
+        breaker.OnComplete(failure, 0);
+        EXPECT_EQ(NbCircuitBreakerState::CLOSED, breaker.GetState());
+    }
+    // 直近4件のうち2件が失敗
+    ASSERT_TRUE(breaker.TryAcquire());
+    breaker.OnComplete(true, 0);
+    EXPECT_EQ(NbCircuitBreakerState::OPEN, breaker.GetState());
+}
+
+//NbCircuitBreaker(低速による遮断)
+TEST(NbCircuitBreaker, OpenBySlowCall) {
+    NbCircuitBreaker breaker;
+    breaker.SetPolicy(MakePolicy());
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(breaker.TryAcquire());
+        breaker.OnComplete(false, 1000);
+    }
+    EXPECT_EQ(NbCircuitBreakerState::OPEN, breaker.GetState());
+}
+
+//NbCircuitBreaker(試行状態から通常状態へ)
+TEST(NbCircuitBreaker, HalfOpenToClosed) {
+    NbCircuitBreaker breaker;
+    breaker.SetPolicy(MakePolicy());
+    for (int i = 0; i < 4; ++i) {
+        breaker.TryAcquire();
+        breaker.OnComplete(true, 0);
+    }
+    ASSERT_EQ(NbCircuitBreakerState::OPEN, breaker.GetState());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(NbCircuitBreakerState::HALF_OPEN, breaker.GetState());
+
+    // 試行数を超える実行は許可しない
+    ASSERT_TRUE(breaker.TryAcquire());
+    ASSERT_TRUE(breaker.TryAcquire());
+    EXPECT_FALSE(breaker.IsCallPermitted());
+    EXPECT_FALSE(breaker.TryAcquire());
+
+    breaker.OnComplete(false, 0);
+    EXPECT_EQ(NbCircuitBreakerState::HALF_OPEN, breaker.GetState());
+    breaker.OnComplete(false, 0);
+    EXPECT_EQ(NbCircuitBreakerState::CLOSED, breaker.GetState());
+
+    // 記録はクリアされている
+    for (int i = 0; i < 3; ++i) {
+        breaker.TryAcquire();
+        breaker.OnComplete(true, 0);
+    }
+    EXPECT_EQ(NbCircuitBreakerState::CLOSED, breaker.GetState());
+}
+
+//NbCircuitBreaker(試行状態から遮断状態へ)
+TEST(NbCircuitBreaker, HalfOpenToOpen) {
+    NbCircuitBreaker breaker;
+    breaker.SetPolicy(MakePolicy());
+    for (int i = 0; i < 4; ++i) {
+        breaker.TryAcquire();
+        breaker.OnComplete(true, 0);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+
+    ASSERT_TRUE(breaker.TryAcquire());
+    breaker.OnComplete(true, 0);
+    EXPECT_EQ(NbCircuitBreakerState::OPEN, breaker.GetState());
+    EXPECT_FALSE(breaker.TryAcquire());
+
+    // ポリシー設定で通常状態に戻る
+    breaker.SetPolicy(MakePolicy());
+    EXPECT_EQ(NbCircuitBreakerState::CLOSED, breaker.GetState());
+}
+} //namespace necbaas
@@ -0,0 +1,106 @@
+#include "gtest/gtest.h"
+#include "necbaas/internal/nb_curl_share.h"
+#include "necbaas/internal/nb_rest_executor.h"
+#include <curlpp/cURLpp.hpp>
+#include "local_http_server.h"
+
+namespace necbaas {
+
+using std::string;
+using std::shared_ptr;
+
+static const string kEmpty{""};
+
+class NbCurlShareTest : public ::testing::Test {
+  protected:
+    virtual void SetUp() {
+        curlpp::initialize();
+    }
+
+    virtual void TearDown() {
+        curlpp::terminate();
+    }
+};
+
+//NbCurlShare::NbCurlShare
+TEST_F(NbCurlShareTest, Constructor) {
+    NbCurlShare share;
+    EXPECT_NE(nullptr, share.GetHandle());
+}
+
+//NbCurlShare::GetProcessShare
+TEST_F(NbCurlShareTest, GetProcessShare) {
+    shared_ptr<NbCurlShare> share1 = NbCurlShare::GetProcessShare();
+    shared_ptr<NbCurlShare> share2 = NbCurlShare::GetProcessShare();
+    ASSERT_NE(nullptr, share1);
+    EXPECT_EQ(share1, share2);
+
+    // 使用中のインスタンスが無くなった場合は解放される
+    std::weak_ptr<NbCurlShare> weak = share1;
+    share1.reset();
+    share2.reset();
+    EXPECT_TRUE(weak.expired());
+    EXPECT_NE(nullptr, NbCurlShare::GetProcessShare());
+}
+
+//NbCurlShare(接続キャッシュは共有しない)
+TEST_F(NbCurlShareTest, ShareConnection) {
+    LocalHttpServer server;
+    shared_ptr<NbCurlShare> share = std::make_shared<NbCurlShare>();
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    NbRestExecutor executor1;
+    executor1.SetCurlShare(share);
+    EXPECT_EQ(share, executor1.GetCurlShare());
+    NbResult<NbHttpResponse> result = executor1.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_FALSE(result.GetSuccessData().IsConnectionReused());
+
+    // 別スレッドで同時に転送し得るため、別のExecutorとは接続を共有しない
+    NbRestExecutor executor2;
+    executor2.SetCurlShare(share);
+    result = executor2.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_FALSE(result.GetSuccessData().IsConnectionReused());
+
+    EXPECT_EQ(2, server.GetConnectionCount());
+}
+
+//NbRestExecutor::SetCurlShare(使用済みの共有キャッシュを切り替え)
+TEST_F(NbCurlShareTest, ReplaceShare) {
+    LocalHttpServer server;
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    NbRestExecutor executor;
+    shared_ptr<NbCurlShare> share = std::make_shared<NbCurlShare>();
+    executor.SetCurlShare(share);
+    ASSERT_TRUE(executor.ExecuteRequest(get, 10).IsSuccess());
+
+    // 切り替え時にCURLハンドルから切り離すため、旧キャッシュを解放できる
+    std::weak_ptr<NbCurlShare> weak = share;
+    share.reset();
+    executor.SetCurlShare(std::make_shared<NbCurlShare>());
+    EXPECT_TRUE(weak.expired());
+    EXPECT_TRUE(executor.ExecuteRequest(get, 10).IsSuccess());
+
+    executor.SetCurlShare(nullptr);
+    EXPECT_TRUE(executor.ExecuteRequest(get, 10).IsSuccess());
+}
+
+//NbCurlShare(共有なし)
+TEST_F(NbCurlShareTest, NoShare) {
+    LocalHttpServer server;
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    NbRestExecutor executor1;
+    EXPECT_EQ(nullptr, executor1.GetCurlShare());
+    ASSERT_TRUE(executor1.ExecuteRequest(get, 10).IsSuccess());
+
+    NbRestExecutor executor2;
+    NbResult<NbHttpResponse> result = executor2.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_FALSE(result.GetSuccessData().IsConnectionReused());
+
+    EXPECT_EQ(2, server.GetConnectionCount());
+}
+} //namespace necbaas
@@ -3,6 +3,13 @@
 #include "necbaas/nb_file_bucket.h"
 #include "necbaas/internal/nb_utility.h"
 #include "rest_api_mock.h"
+#include "local_http_server.h"
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <thread>
 
 namespace necbaas {
 
@@ -111,6 +118,43 @@ TEST_F(NbFileBucketTest, DownloadFile) {
     EXPECT_EQ(12345, response);
 }
 
+static NbResult<NbHttpResponse> DownloadFileLarge(const NbHttpRequest &request, const string &file_path, int timeout) {
+    NbResult<NbHttpResponse> tmp_result(NbResultCode::NB_OK);
+    std::multimap<std::string, std::string> resp_headers{{"X-Content-Length", "3221225472"}};
+    NbHttpResponse response(200, string("OK"), resp_headers, vector<char>());
+    tmp_result.SetSuccessData(response);
+
+    return tmp_result;
+}
+
+//NbFileBucketTest::DownloadLargeFile(2GB以上のファイル)
+TEST_F(NbFileBucketTest, DownloadLargeFile) {
+    SetExpectDownload(&executor_, kFilePath, &DownloadFileLarge);
+
+    shared_ptr<NbService> service(mock_service_);
+
+    NbFileBucket file_bucket(service, kBucketName);
+    NbResult<int64_t> result = file_bucket.DownloadLargeFile(kFileName, kFilePath);
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsSuccess());
+    EXPECT_EQ(3221225472LL, result.GetSuccessData());
+}
+
+//NbFileBucketTest::DownloadFile(intの範囲を超えるファイルサイズ)
+TEST_F(NbFileBucketTest, DownloadFileSizeOverflow) {
+    SetExpectDownload(&executor_, kFilePath, &DownloadFileLarge);
+
+    shared_ptr<NbService> service(mock_service_);
+
+    NbFileBucket file_bucket(service, kBucketName);
+    NbResult<int> result = file_bucket.DownloadFile(kFileName, kFilePath);
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsFatalError());
+    EXPECT_EQ(NbResultCode::NB_ERROR_FILE_DOWNLOAD, result.GetResultCode());
+}
+
 static NbResult<NbHttpResponse> DownloadFileEscape(const NbHttpRequest &request, const string &file_path, int timeout) {
     string file_name = "%E3%83%86%E3%82%B9%E3%83%88%E3%83%95%E3%82%A1%E3%82%A4%E3%83%AB";
     EXPECT_EQ(10, timeout);
@@ -256,6 +300,311 @@ TEST_F(NbFileBucketTest, DownloadFileConnectionOver) {
     EXPECT_EQ(NbResultCode::NB_ERROR_CONNECTION_OVER, result.GetResultCode());
 }
 
+//NbFileBucketTest::DownloadFile(呼び出し元バッファ)
+TEST_F(NbFileBucketTest, DownloadFileBuffer) {
+    LocalHttpServer server("0123456789", "X-Content-Length: 10\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    char buffer[32] = {};
+    NbResult<int64_t> result = file_bucket.DownloadFile(kFileName, buffer, sizeof(buffer));
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(10, result.GetSuccessData());
+    EXPECT_STREQ("0123456789", buffer);
+    EXPECT_EQ(string("GET /api/1/tenantID/files/" + kBucketName + "/" + kFileName + " HTTP/1.1"),
+              server.GetRequestLines()[0]);
+
+    // バッファサイズ不足
+    result = file_bucket.DownloadFile(kFileName, buffer, 5);
+    EXPECT_EQ(NbResultCode::NB_ERROR_FILE_DOWNLOAD, result.GetResultCode());
+
+    // パラメータ不正
+    result = file_bucket.DownloadFile(kFileName, static_cast<char *>(nullptr), 0);
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+    result = file_bucket.DownloadFile(kEmpty, buffer, sizeof(buffer));
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+}
+
+//NbFileBucketTest::DownloadFile(可変長バッファ)
+TEST_F(NbFileBucketTest, DownloadFileVector) {
+    string body(100000, 'x');
+    LocalHttpServer server(body, "X-Content-Length: 100000\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    vector<char> buffer{'a', 'b'};
+    NbResult<int64_t> result = file_bucket.DownloadFile(kFileName, &buffer);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(100000, result.GetSuccessData());
+    EXPECT_EQ(body, string(buffer.begin(), buffer.end()));
+
+    // パラメータ不正
+    result = file_bucket.DownloadFile(kFileName, static_cast<vector<char> *>(nullptr));
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+}
+
+//NbFileBucketTest::DownloadFile(可変長バッファ、サイズ不一致)
+TEST_F(NbFileBucketTest, DownloadFileVectorSizeMismatch) {
+    LocalHttpServer server("0123456789", "X-Content-Length: 20\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    vector<char> buffer;
+    NbResult<int64_t> result = file_bucket.DownloadFile(kFileName, &buffer);
+    EXPECT_EQ(NbResultCode::NB_ERROR_FILE_DOWNLOAD, result.GetResultCode());
+    EXPECT_TRUE(buffer.empty());
+}
+
+//NbFileBucketTest::DownloadFile(並列)
+TEST_F(NbFileBucketTest, DownloadFileParallel) {
+    string body;
+    for (int i = 0; body.size() < 1024 * 1024 + 10; ++i) {
+        body += std::to_string(i) + ",";
+    }
+    body.resize(1024 * 1024 + 10);
+    LocalHttpServer server(body, "X-Content-Length: " + std::to_string(body.size()) + "\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    NbJsonObject json;
+    json[kKeyFilename] = kFileName;
+    json[kKeyLength] = static_cast<int>(body.size());
+    NbFileMetadata metadata(kBucketName, json);
+
+    service->SetResponseCompressionEnabled(true);
+    NbResult<int64_t> result = file_bucket.DownloadFile(metadata, "download_parallel.dat", 4);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(body.size(), result.GetSuccessData());
+
+    // 範囲ごとに並行してリクエストする(応答圧縮は使用しない)
+    vector<string> requests = server.GetRequests();
+    ASSERT_EQ(4, requests.size());
+    int range_count = 0;
+    for (const auto &request : requests) {
+        if (request.find("Range: bytes=") != string::npos) {
+            ++range_count;
+        }
+        EXPECT_EQ(string::npos, request.find("Accept-Encoding:"));
+    }
+    EXPECT_EQ(4, range_count);
+
+    // 統計情報はダウンロード全体を1回として記録する
+    NbStatistics statistics = service->GetStatistics();
+    const NbOperationStatistics &download = statistics.operations[NbOperation::FILE_DOWNLOAD];
+    EXPECT_EQ(1, download.request_count);
+    EXPECT_LE(body.size(), download.bytes_received);
+    EXPECT_NE(string::npos, std::string(requests[0] + requests[1] + requests[2] + requests[3])
+                                .find("Range: bytes=786441-1048585\r\n"));
+
+    std::ifstream file_stream("download_parallel.dat", std::ios::in | std::ios::binary);
+    string downloaded((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+    EXPECT_EQ(body, downloaded);
+    std::remove("download_parallel.dat");
+}
+
+//NbFileBucketTest::DownloadFile(並列、分割不要なサイズ)
+TEST_F(NbFileBucketTest, DownloadFileParallelSmall) {
+    LocalHttpServer server("0123456789", "X-Content-Length: 10\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    NbJsonObject json;
+    json[kKeyFilename] = kFileName;
+    json[kKeyLength] = 10;
+    NbFileMetadata metadata(kBucketName, json);
+
+    // 1回のダウンロードで処理する
+    NbResult<int64_t> result = file_bucket.DownloadFile(metadata, "download_parallel.dat", 4);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(10, result.GetSuccessData());
+    ASSERT_EQ(1, server.GetRequestCount());
+    EXPECT_EQ(string::npos, server.GetRequests()[0].find("Range:"));
+    std::remove("download_parallel.dat");
+
+    // パラメータ不正
+    result = file_bucket.DownloadFile(metadata, "download_parallel.dat", 0);
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+    result = file_bucket.DownloadFile(metadata, kEmpty, 4);
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+}
+
+//NbFileBucketTest::DownloadFile(並列、エラー)
+TEST_F(NbFileBucketTest, DownloadFileParallelRestError) {
+    LocalHttpServer server(string(1024 * 1024, 'x'));
+    server.SetStatusCodes({404, 404});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    NbJsonObject json;
+    json[kKeyFilename] = kFileName;
+    json[kKeyLength] = 1024 * 1024;
+    NbFileMetadata metadata(kBucketName, json);
+
+    NbResult<int64_t> result = file_bucket.DownloadFile(metadata, "download_parallel.dat", 2);
+    ASSERT_TRUE(result.IsRestError());
+    EXPECT_EQ(404, result.GetRestError().status_code);
+    std::remove("download_parallel.dat");
+}
+
+//NbFileBucketTest::DownloadFile(並列、REST Executorの空き不足)
+TEST_F(NbFileBucketTest, DownloadFileParallelExecutorShortage) {
+    static const int kFileSize = 1024 * 1024;
+    LocalHttpServer server(string(kFileSize, 'x'), "X-Content-Length: " + std::to_string(kFileSize) + "\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    NbJsonObject json;
+    json[kKeyFilename] = kFileName;
+    json[kKeyLength] = kFileSize;
+    NbFileMetadata metadata(kBucketName, json);
+
+    // 他の処理が使用中で空きが2つの場合は、2分割でダウンロードする
+    vector<NbRestExecutor *> in_use = service->ReserveRestExecutors(kHttpConnectionMax - 2);
+    ASSERT_EQ(kHttpConnectionMax - 2, in_use.size());
+    NbResult<int64_t> result = file_bucket.DownloadFile(metadata, "download_parallel.dat", 4);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(kFileSize, result.GetSuccessData());
+    EXPECT_EQ(2, server.GetRequestCount());
+
+    // 空きが1つの場合は分割しない
+    vector<NbRestExecutor *> in_use2 = service->ReserveRestExecutors(1);
+    result = file_bucket.DownloadFile(metadata, "download_parallel.dat", 4);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(3, server.GetRequestCount());
+    EXPECT_EQ(string::npos, server.GetRequests()[2].find("Range: "));
+    EXPECT_EQ(kFileSize, NbUtility::GetFileSize("download_parallel.dat"));
+    // 空きの不足はエラーとして計上しない
+    EXPECT_EQ(0, service->GetStatistics().connection_pool.failed_count);
+
+    service->ReleaseRestExecutors(in_use2);
+    service->ReleaseRestExecutors(in_use);
+    std::remove("download_parallel.dat");
+}
+
+//NbFileBucketTest::DownloadFile(並列、メタデータのファイルサイズ不一致)
+TEST_F(NbFileBucketTest, DownloadFileParallelSizeMismatch) {
+    static const int kFileSize = 1024 * 1024;
+    LocalHttpServer server(string(kFileSize, 'x'), "X-Content-Length: " + std::to_string(kFileSize + 1) + "\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    NbJsonObject json;
+    json[kKeyFilename] = kFileName;
+    json[kKeyLength] = kFileSize;
+    NbFileMetadata metadata(kBucketName, json);
+
+    NbResult<int64_t> result = file_bucket.DownloadFile(metadata, "download_parallel.dat", 2);
+    EXPECT_EQ(NbResultCode::NB_ERROR_FILE_DOWNLOAD, result.GetResultCode());
+    std::remove("download_parallel.dat");
+}
+
+//NbFileBucketTest::ResumeDownloadFile(保存済みデータの続きから再開)
+TEST_F(NbFileBucketTest, ResumeDownloadFile) {
+    LocalHttpServer server("0123456789", "X-Content-Length: 10\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+    NbFileMetadata metadata(kBucketName, NbJsonObject(kFileMetadata));
+
+    std::ofstream("download_resume.dat", std::ios::out | std::ios::binary) << "01234";
+    std::ofstream("download_resume.dat.etag") << metadata.GetFileETag();
+
+    NbResult<int64_t> result = file_bucket.ResumeDownloadFile(metadata, "download_resume.dat");
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(10, result.GetSuccessData());
+
+    ASSERT_EQ(1, server.GetRequestCount());
+    string request = server.GetRequests()[0];
+    EXPECT_NE(string::npos, request.find("Range: bytes=5-\r\n"));
+    EXPECT_NE(string::npos, request.find("If-Range: \"" + metadata.GetFileETag() + "\"\r\n"));
+
+    std::ifstream file_stream("download_resume.dat", std::ios::in | std::ios::binary);
+    EXPECT_EQ(string("0123456789"),
+              string((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>()));
+    // 成功時はETag保存ファイルを削除する
+    EXPECT_FALSE(std::ifstream("download_resume.dat.etag").is_open());
+    std::remove("download_resume.dat");
+}
+
+//NbFileBucketTest::ResumeDownloadFile(受信後のファイルサイズ不一致)
+TEST_F(NbFileBucketTest, ResumeDownloadFileSizeMismatch) {
+    LocalHttpServer server("0123456789", "X-Content-Length: 11\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+    NbFileMetadata metadata(kBucketName, NbJsonObject(kFileMetadata));
+
+    std::ofstream("download_resume.dat", std::ios::out | std::ios::binary) << "01234";
+    std::ofstream("download_resume.dat.etag") << metadata.GetFileETag();
+
+    NbResult<int64_t> result = file_bucket.ResumeDownloadFile(metadata, "download_resume.dat");
+    EXPECT_EQ(NbResultCode::NB_ERROR_FILE_DOWNLOAD, result.GetResultCode());
+    // 不完全なファイルのため、ETag保存ファイルは残す
+    EXPECT_TRUE(std::ifstream("download_resume.dat.etag").is_open());
+    std::remove("download_resume.dat");
+    std::remove("download_resume.dat.etag");
+}
+
+//NbFileBucketTest::ResumeDownloadFile(ETag不一致は先頭から)
+TEST_F(NbFileBucketTest, ResumeDownloadFileETagMismatch) {
+    LocalHttpServer server("0123456789", "X-Content-Length: 10\r\n");
+    server.SetStatusCodes({503});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+    NbFileMetadata metadata(kBucketName, NbJsonObject(kFileMetadata));
+
+    std::ofstream("download_resume.dat", std::ios::out | std::ios::binary) << "abcde";
+    std::ofstream("download_resume.dat.etag") << "old-etag";
+
+    // エラー時はETagを保存したファイルを残す
+    NbResult<int64_t> result = file_bucket.ResumeDownloadFile(metadata, "download_resume.dat");
+    ASSERT_TRUE(result.IsRestError());
+    std::string saved_etag;
+    std::getline(std::ifstream("download_resume.dat.etag"), saved_etag);
+    EXPECT_EQ(metadata.GetFileETag(), saved_etag);
+
+    result = file_bucket.ResumeDownloadFile(metadata, "download_resume.dat");
+    ASSERT_TRUE(result.IsSuccess());
+    for (const auto &request : server.GetRequests()) {
+        EXPECT_EQ(string::npos, request.find("Range:"));
+    }
+    std::ifstream file_stream("download_resume.dat", std::ios::in | std::ios::binary);
+    EXPECT_EQ(string("0123456789"),
+              string((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>()));
+    std::remove("download_resume.dat");
+}
+
+//NbFileBucketTest::ResumeDownloadFile(2GB超のファイルの続きから再開)
+// 3GBのスパースファイルを作成するため、通常の実行では無効とする
+TEST_F(NbFileBucketTest, DISABLED_ResumeDownloadFileLarge) {
+    static const int64_t kLargeSize = (3LL << 30) + 20;
+    LocalHttpServer server(kEmpty, "X-Content-Length: " + std::to_string(kLargeSize) + "\r\n");
+    server.SetBodySize(kLargeSize);
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+    NbFileMetadata metadata(kBucketName, NbJsonObject(kFileMetadata));
+
+    // 受信済みの部分はデータを書込まないスパースファイルで作成する
+    std::ofstream("download_resume.dat");
+    ASSERT_EQ(0, truncate("download_resume.dat", kLargeSize - 20));
+    std::ofstream("download_resume.dat.etag") << metadata.GetFileETag();
+
+    NbResult<int64_t> result = file_bucket.ResumeDownloadFile(metadata, "download_resume.dat");
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(kLargeSize, result.GetSuccessData());
+
+    ASSERT_EQ(1, server.GetRequestCount());
+    EXPECT_NE(string::npos, server.GetRequests()[0].find("Range: bytes=" + std::to_string(kLargeSize - 20) + "-\r\n"));
+    EXPECT_EQ(kLargeSize, NbUtility::GetFileSize("download_resume.dat"));
+
+    std::ifstream file_stream("download_resume.dat", std::ios::in | std::ios::binary);
+    file_stream.seekg(kLargeSize - 20);
+    string tail((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+    ASSERT_EQ(20, tail.size());
+    for (int i = 0; i < 20; ++i) {
+        EXPECT_EQ(LocalHttpServer::GetBodyByte(kLargeSize - 20 + i), tail[i]);
+    }
+    std::remove("download_resume.dat");
+}
+
 static NbResult<NbHttpResponse> UploadNewFileCommon(const NbHttpRequest &request, const string &file_path, int timeout) {
     EXPECT_EQ(NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST, request.GetMethod());
     EXPECT_EQ(kEmpty, request.GetBody());
@@ -666,6 +1015,195 @@ TEST_F(NbFileBucketTest, UploadUpdateFileConnectionOver) {
     EXPECT_EQ(NbResultCode::NB_ERROR_CONNECTION_OVER, result.GetResultCode());
 }
 
+//NbFileBucketTest::UploadNewFile(メモリ上のデータ)
+TEST_F(NbFileBucketTest, UploadNewFileBuffer) {
+    LocalHttpServer server(kFileMetadata);
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    string data(100000, 'd');
+    NbResult<NbFileMetadata> result = file_bucket.UploadNewFile(kFileName, data.c_str(), data.size(), kContentType);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(kFileName, result.GetSuccessData().GetFileName());
+
+    vector<string> requests = server.GetRequests();
+    ASSERT_EQ(1, requests.size());
+    EXPECT_EQ(0, requests[0].find("POST /api/1/tenantID/files/" + kBucketName + "/" + kFileName + " HTTP/1.1"));
+    EXPECT_NE(string::npos, requests[0].find("Content-Type: text/plain\r\n"));
+    EXPECT_NE(string::npos, requests[0].find("Content-Length: 100000\r\n"));
+    EXPECT_EQ(data, requests[0].substr(requests[0].find("\r\n\r\n") + 4));
+
+    // パラメータ不正
+    result = file_bucket.UploadNewFile(kFileName, nullptr, 10, kContentType);
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+    result = file_bucket.UploadNewFile(kFileName, data.c_str(), data.size(), kEmpty);
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+}
+
+//NbFileBucketTest::UploadFiles(一括アップロード)
+TEST_F(NbFileBucketTest, UploadFiles) {
+    LocalHttpServer server(kFileMetadata);
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    vector<NbFileUploadJob> jobs(3);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].file_name = "file" + std::to_string(i);
+        jobs[i].file_path = "upload_batch" + std::to_string(i) + ".dat";
+        jobs[i].content_type = kContentType;
+        std::ofstream(jobs[i].file_path, std::ios::out | std::ios::binary) << "data" << i;
+    }
+    jobs[0].acl = std::make_shared<NbAcl>(NbAcl::CreateAclForAnonymous());
+    // Content-Typeなしはパラメータ不正
+    jobs[2].content_type = kEmpty;
+
+    NbFileTransferResult<NbFileMetadata> result = file_bucket.UploadFiles(jobs, 4);
+    ASSERT_EQ(3, result.results.size());
+    EXPECT_TRUE(result.results[0].IsSuccess());
+    EXPECT_TRUE(result.results[1].IsSuccess());
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.results[2].GetResultCode());
+    EXPECT_EQ(2, result.success_count);
+    EXPECT_EQ(1, result.failure_count);
+    // 成功したファイルのメタデータのサイズを合計する
+    EXPECT_EQ(24, result.total_bytes);
+
+    vector<string> requests = server.GetRequests();
+    ASSERT_EQ(2, requests.size());
+    std::sort(requests.begin(), requests.end());
+    EXPECT_EQ(0, requests[0].find("POST /api/1/tenantID/files/" + kBucketName + "/file0 HTTP/1.1"));
+    EXPECT_NE(string::npos, requests[0].find("X-ACL: "));
+    EXPECT_NE(string::npos, requests[0].find("\r\n\r\ndata0"));
+    EXPECT_EQ(0, requests[1].find("POST /api/1/tenantID/files/" + kBucketName + "/file1 HTTP/1.1"));
+    EXPECT_EQ(string::npos, requests[1].find("X-ACL: "));
+    EXPECT_NE(string::npos, requests[1].find("\r\n\r\ndata1"));
+
+    for (const auto &job : jobs) {
+        std::remove(job.file_path.c_str());
+    }
+}
+
+//NbFileBucketTest::DownloadFiles(一括ダウンロード)
+TEST_F(NbFileBucketTest, DownloadFiles) {
+    static const int kJobCount = 8;
+    static const int kDelay = 200;
+    LocalHttpServer server("0123456789", "X-Content-Length: 10\r\n");
+    server.SetResponseDelays(vector<int>(kJobCount, kDelay));
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    vector<NbFileDownloadJob> jobs(kJobCount + 1);
+    for (int i = 0; i < kJobCount; ++i) {
+        jobs[i].file_name = "file" + std::to_string(i);
+        jobs[i].file_path = "download_batch" + std::to_string(i) + ".dat";
+    }
+    // ファイル名なしはパラメータ不正
+    jobs[kJobCount].file_path = "download_batch_invalid.dat";
+
+    NbFileTransferResult<int64_t> result = file_bucket.DownloadFiles(jobs, 4);
+    ASSERT_EQ(kJobCount + 1, result.results.size());
+    for (int i = 0; i < kJobCount; ++i) {
+        ASSERT_TRUE(result.results[i].IsSuccess());
+        EXPECT_EQ(10, result.results[i].GetSuccessData());
+        std::ifstream file_stream(jobs[i].file_path, std::ios::in | std::ios::binary);
+        EXPECT_EQ(string("0123456789"),
+                  string((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>()));
+        std::remove(jobs[i].file_path.c_str());
+    }
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.results[kJobCount].GetResultCode());
+    EXPECT_EQ(kJobCount, result.success_count);
+    EXPECT_EQ(1, result.failure_count);
+    EXPECT_EQ(kJobCount * 10, result.total_bytes);
+    EXPECT_EQ(kJobCount, server.GetRequestCount());
+
+    // 4並列のため、逐次実行(8 * 200ms)より短時間で完了する
+    EXPECT_LT(result.elapsed_time_ms, kJobCount * kDelay);
+    EXPECT_GT(result.bytes_per_second, 0);
+}
+
+//NbFileBucketTest::DownloadFiles(REST Executorの空き待ち)
+TEST_F(NbFileBucketTest, DownloadFilesWaitExecutor) {
+    static const int kJobCount = 4;
+    LocalHttpServer server("0123456789", "X-Content-Length: 10\r\n");
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    vector<NbFileDownloadJob> jobs(kJobCount);
+    for (int i = 0; i < kJobCount; ++i) {
+        jobs[i].file_name = "file" + std::to_string(i);
+        jobs[i].file_path = "download_batch" + std::to_string(i) + ".dat";
+    }
+
+    // 他のスレッドがREST Executorを全て使用中の状態で開始し、途中で返却する
+    vector<NbRestExecutor *> executors = service->ReserveRestExecutors(kHttpConnectionMax);
+    ASSERT_EQ(kHttpConnectionMax, executors.size());
+    std::thread release_thread([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        service->ReleaseRestExecutors(executors);
+    });
+
+    NbFileTransferResult<int64_t> result = file_bucket.DownloadFiles(jobs, kJobCount);
+    release_thread.join();
+    ASSERT_EQ(kJobCount, result.results.size());
+    EXPECT_EQ(kJobCount, result.success_count);
+    EXPECT_EQ(0, result.failure_count);
+    EXPECT_EQ(kJobCount, server.GetRequestCount());
+    EXPECT_GE(result.elapsed_time_ms, 300);
+    for (const auto &job : jobs) {
+        std::remove(job.file_path.c_str());
+    }
+
+    // RESTタイムアウトまで空きが無い場合は同時接続数オーバー
+    executors = service->ReserveRestExecutors(kHttpConnectionMax);
+    ASSERT_EQ(kHttpConnectionMax, executors.size());
+    file_bucket.SetTimeout(1);
+    result = file_bucket.DownloadFiles(vector<NbFileDownloadJob>(jobs.begin(), jobs.begin() + 1), 1);
+    service->ReleaseRestExecutors(executors);
+    ASSERT_EQ(1, result.results.size());
+    EXPECT_EQ(NbResultCode::NB_ERROR_CONNECTION_OVER, result.results[0].GetResultCode());
+    EXPECT_GE(result.elapsed_time_ms, 1000);
+    EXPECT_EQ(kJobCount, server.GetRequestCount());
+}
+
+//NbFileBucketTest::DownloadFiles(ジョブなし、同時実行数の範囲外)
+TEST_F(NbFileBucketTest, DownloadFilesEmpty) {
+    shared_ptr<NbService> service(mock_service_);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    NbFileTransferResult<int64_t> result = file_bucket.DownloadFiles(vector<NbFileDownloadJob>(), 0);
+    EXPECT_TRUE(result.results.empty());
+    EXPECT_EQ(0, result.success_count);
+    EXPECT_EQ(0, result.failure_count);
+    EXPECT_EQ(0, result.total_bytes);
+
+    // 同時実行数が1未満でも1スレッドで処理する
+    vector<NbFileDownloadJob> jobs(2);
+    result = file_bucket.DownloadFiles(jobs, -1);
+    ASSERT_EQ(2, result.results.size());
+    EXPECT_EQ(2, result.failure_count);
+}
+
+//NbFileBucketTest::UploadUpdateFile(メモリ上のデータ)
+TEST_F(NbFileBucketTest, UploadUpdateFileBuffer) {
+    LocalHttpServer server(kFileMetadata);
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), "tenantID", "appID", "appKey", kEmpty);
+    NbFileBucket file_bucket(service, kBucketName);
+
+    NbFileMetadata metadata(kBucketName, NbJsonObject(kFileMetadata));
+    string data("0123456789");
+    NbResult<NbFileMetadata> result = file_bucket.UploadUpdateFile(data.c_str(), data.size(), metadata);
+    ASSERT_TRUE(result.IsSuccess());
+
+    vector<string> requests = server.GetRequests();
+    ASSERT_EQ(1, requests.size());
+    EXPECT_EQ(0, requests[0].find("PUT /api/1/tenantID/files/" + kBucketName + "/" + kFileName + "?"));
+    EXPECT_NE(string::npos, requests[0].find("Content-Length: 10\r\n"));
+    EXPECT_EQ(data, requests[0].substr(requests[0].find("\r\n\r\n") + 4));
+
+    // パラメータ不正
+    result = file_bucket.UploadUpdateFile(kEmpty, data.c_str(), data.size(), kEmpty, kEmpty, kEmpty);
+    EXPECT_EQ(NbResultCode::NB_ERROR_INVALID_ARGUMENT, result.GetResultCode());
+}
+
 static NbResult<NbHttpResponse> DeleteFileNorm1(const NbHttpRequest &request, int timeout) {
     EXPECT_EQ(string("/files/" + kBucketName + "/" + kFileName + "?deleteMark=1&fileETag=8c92c97e-01a7-11e4-9598-53792c688d1c&metaETag=8c92c97e-01a7-11e4-9598-53792c688d1b"),
               request.GetUrl().substr(request.GetUrl().find("/files/")));
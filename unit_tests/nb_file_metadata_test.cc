@@ -58,4 +58,11 @@ TEST(NbFileMetadata, NbFileMetadataJson) {
     EXPECT_TRUE(metadata.IsCacheDisabled());
     EXPECT_TRUE(metadata.IsDeleted());
 }
+
+//NbFileMetadata ファイルサイズ(2GB超)
+TEST(NbFileMetadata, NbFileMetadataLargeLength) {
+    NbJsonObject json(R"({"filename":"largeFile","length":5368709120})");
+    NbFileMetadata metadata(string("testBucket"), json);
+    EXPECT_EQ(5368709120LL, metadata.GetLength());
+}
 } //namespace necbaas
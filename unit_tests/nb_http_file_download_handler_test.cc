@@ -1,5 +1,8 @@
 #include "gtest/gtest.h"
 #include "necbaas/internal/nb_http_file_download_handler.h"
+#include <sys/stat.h>
+#include <fstream>
+#include <iterator>
 
 namespace necbaas {
 
@@ -127,4 +130,173 @@ static const vector<string> headers = {
     EXPECT_EQ(0, file_stream.read(buf, strlen(kBuf)).gcount());
     std::remove("download.dat");
 }
+
+// ファイル内容読込み
+static string ReadFile(const string &file_name) {
+    std::ifstream file_stream(file_name, std::ios::in | std::ios::binary);
+    return string((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>());
+}
+
+//NbHttpFileDownloadHandler 再開モード(206:追記)
+TEST(NbHttpFileDownloadHandler, ResumePartialContent) {
+    static const vector<string> headers = {
+        "HTTP/1.1 206 Partial Content\r\n",
+        "Content-Range: bytes 5-19/20\r\n",
+        "\r\n"};
+    std::ofstream("download.dat", std::ios::out | std::ios::binary) << "12345";
+    {
+        NbHttpFileDownloadHandler handler(string("download.dat"), true);
+        for (auto header : headers) {
+            EXPECT_EQ(header.size(), handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size()));
+        }
+        EXPECT_FALSE(handler.IsError());
+        EXPECT_EQ(15, handler.WriteCallback(kBuf + 5, 1, 15));
+    }
+    EXPECT_EQ(string(kBuf), ReadFile("download.dat"));
+    std::remove("download.dat");
+}
+
+//NbHttpFileDownloadHandler 再開モード(206:Content-Rangeの開始位置不一致は中断)
+TEST(NbHttpFileDownloadHandler, ResumeContentRangeMismatch) {
+    static const vector<vector<string>> patterns = {
+        {"HTTP/1.1 206 Partial Content\r\n", "Content-Range: bytes 3-19/20\r\n", "\r\n"},
+        {"HTTP/1.1 206 Partial Content\r\n", "Content-Range: bytes 0-19/20\r\n", "\r\n"},
+        {"HTTP/1.1 206 Partial Content\r\n", "\r\n"}};
+    for (const auto &headers : patterns) {
+        std::ofstream("download.dat", std::ios::out | std::ios::binary) << "12345";
+        {
+            NbHttpFileDownloadHandler handler(string("download.dat"), true);
+            for (size_t i = 0; i < headers.size() - 1; ++i) {
+                EXPECT_EQ(headers[i].size(), handler.WriteHeaderCallback((void *)headers[i].c_str(), 1, headers[i].size()));
+            }
+            EXPECT_EQ(0, handler.WriteHeaderCallback((void *)headers.back().c_str(), 1, headers.back().size()));
+            EXPECT_TRUE(handler.IsError());
+            EXPECT_EQ(0, handler.WriteCallback(kBuf + 5, 1, 15));
+        }
+        EXPECT_EQ(string("12345"), ReadFile("download.dat"));
+    }
+    std::remove("download.dat");
+}
+
+//NbHttpFileDownloadHandler 再開モード(200:上書き)
+TEST(NbHttpFileDownloadHandler, ResumeFullContent) {
+    std::ofstream("download.dat", std::ios::out | std::ios::binary) << "abcde";
+    {
+        NbHttpFileDownloadHandler handler(string("download.dat"), true);
+        for (auto header : kHeaders) {
+            EXPECT_EQ(header.size(), handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size()));
+        }
+        EXPECT_EQ(20, handler.WriteCallback(kBuf, 1, 20));
+    }
+    EXPECT_EQ(string(kBuf), ReadFile("download.dat"));
+    std::remove("download.dat");
+}
+
+//NbHttpFileDownloadHandler 再開モード(ステータスコードエラー:ファイルを変更しない)
+TEST(NbHttpFileDownloadHandler, ResumeStatusCodeError) {
+    static const vector<string> headers = {
+        "HTTP/1.1 503 Service Unavailable\r\n",
+        "\r\n"};
+    std::ofstream("download.dat", std::ios::out | std::ios::binary) << "12345";
+    {
+        NbHttpFileDownloadHandler handler(string("download.dat"), true);
+        for (auto header : headers) {
+            handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+        }
+        EXPECT_EQ(10, handler.WriteCallback(kBuf, 1, 10));
+        EXPECT_EQ(503, handler.Parse().GetStatusCode());
+    }
+    EXPECT_EQ(string("12345"), ReadFile("download.dat"));
+    std::remove("download.dat");
+}
+// ファイルサイズ取得
+static off_t GetFileSize(const string &file_name) {
+    struct stat file_stat;
+    return (stat(file_name.c_str(), &file_stat) == 0) ? file_stat.st_size : -1;
+}
+
+//NbHttpFileDownloadHandler 書込みバッファ(バッファサイズ分蓄積してから書込む)
+TEST(NbHttpFileDownloadHandler, WriteBuffer) {
+    {
+        NbHttpFileDownloadHandler handler(string("download.dat"));
+        handler.SetWriteBufferSize(16);
+        for (auto header : kHeaders) {
+            handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+        }
+
+        EXPECT_EQ(10, handler.WriteCallback(kBuf, 1, 10));
+        EXPECT_EQ(0, GetFileSize("download.dat"));
+
+        // バッファに収まらないため蓄積済みのデータを書込む
+        EXPECT_EQ(8, handler.WriteCallback(kBuf + 10, 1, 8));
+        EXPECT_EQ(10, GetFileSize("download.dat"));
+
+        EXPECT_EQ(2, handler.WriteCallback(kBuf + 18, 1, 2));
+        EXPECT_EQ(10, GetFileSize("download.dat"));
+
+        // Finish()で残りを書込む
+        EXPECT_TRUE(handler.Finish());
+        EXPECT_EQ(20, GetFileSize("download.dat"));
+        EXPECT_EQ(string(kBuf), ReadFile("download.dat"));
+    }
+    EXPECT_EQ(string(kBuf), ReadFile("download.dat"));
+    std::remove("download.dat");
+}
+
+//NbHttpFileDownloadHandler 書込みバッファ(バッファサイズ以上のデータ、バッファリングなし)
+TEST(NbHttpFileDownloadHandler, WriteBufferLargeData) {
+    {
+        NbHttpFileDownloadHandler handler(string("download.dat"));
+        handler.SetWriteBufferSize(8);
+        for (auto header : kHeaders) {
+            handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+        }
+
+        // バッファサイズ以上のデータは直接書込む
+        EXPECT_EQ(15, handler.WriteCallback(kBuf, 1, 15));
+        EXPECT_EQ(15, GetFileSize("download.dat"));
+
+        handler.SetWriteBufferSize(0);
+        EXPECT_EQ(5, handler.WriteCallback(kBuf + 15, 1, 5));
+        EXPECT_EQ(20, GetFileSize("download.dat"));
+    }
+    EXPECT_EQ(string(kBuf), ReadFile("download.dat"));
+    std::remove("download.dat");
+}
+
+//NbHttpFileDownloadHandler 同期書込み
+TEST(NbHttpFileDownloadHandler, FinishSync) {
+    NbHttpFileDownloadHandler handler(string("download.dat"));
+    handler.SetSyncEnabled(true);
+    for (auto header : kHeaders) {
+        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+    EXPECT_EQ(20, handler.WriteCallback(kBuf, 1, 20));
+
+    EXPECT_TRUE(handler.Finish());
+    EXPECT_EQ(string(kBuf), ReadFile("download.dat"));
+    std::remove("download.dat");
+}
+
+//NbHttpFileDownloadHandler ファイル領域確保(ファイルサイズは変更しない)
+TEST(NbHttpFileDownloadHandler, Preallocate) {
+    static const vector<string> headers = {
+        "HTTP/1.1 200 OK\r\n",
+        "x-content-length: 1048576\r\n",
+        "\r\n"};
+    {
+        NbHttpFileDownloadHandler handler(string("download.dat"));
+        for (auto header : headers) {
+            EXPECT_EQ(header.size(), handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size()));
+        }
+        EXPECT_FALSE(handler.IsError());
+        EXPECT_EQ(0, GetFileSize("download.dat"));
+
+        EXPECT_EQ(20, handler.WriteCallback(kBuf, 1, 20));
+        EXPECT_TRUE(handler.Finish());
+        EXPECT_EQ(20, GetFileSize("download.dat"));
+    }
+    EXPECT_EQ(string(kBuf), ReadFile("download.dat"));
+    std::remove("download.dat");
+}
 } //namespace necbaas
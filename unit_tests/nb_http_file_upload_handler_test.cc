@@ -62,8 +62,21 @@ TEST(NbHttpFileUploadHandler, FileOpenError) {
     NbHttpFileUploadHandler handler(string("notfounddir/upload.dat"));
 
     EXPECT_TRUE(handler.IsError());
+    EXPECT_EQ(0, handler.GetFileSize());
 
     EXPECT_EQ(0, handler.ReadCallback(buf, 1, 10));
 }
 
+//NbHttpFileUploadHandler ファイルサイズ取得
+TEST(NbHttpFileUploadHandler, GetFileSize) {
+    NbHttpFileUploadHandler handler(MakeFilePath("upload.dat"));
+    EXPECT_EQ(strlen(kBuf), handler.GetFileSize());
+
+    NbHttpFileUploadHandler empty_handler(MakeFilePath("0.txt"));
+    EXPECT_FALSE(empty_handler.IsError());
+    EXPECT_EQ(0, empty_handler.GetFileSize());
+    char buf[16];
+    EXPECT_EQ(0, empty_handler.ReadCallback(buf, 1, sizeof(buf)));
+}
+
 } //namespace necbaas
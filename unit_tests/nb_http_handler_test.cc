@@ -260,6 +260,109 @@ static const vector<string> headers = {
     EXPECT_EQ(0, response.GetHeaders().size());
 }
 
+//NbHttpHandler GetHeader(大文字小文字区別なし)
+TEST(NbHttpHandler, GetHeader) {
+    NbHttpHandler handler;
+
+    for (auto header : kHeaders) {
+        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+    NbHttpResponse response = handler.Parse();
+
+    string value;
+    EXPECT_TRUE(response.GetHeader("content-type", &value));
+    EXPECT_EQ(string("application/json"), value);
+    EXPECT_TRUE(response.GetHeader("CACHE-CONTROL", &value));
+    EXPECT_EQ(string("no-cache, no-store, max-age=0, must-revalidate"), value);
+    EXPECT_TRUE(response.GetHeader("Server", &value));
+    EXPECT_EQ(string(""), value);
+    EXPECT_FALSE(response.GetHeader("Content", &value));
+    EXPECT_TRUE(response.GetHeader("Date", nullptr));
+}
+
+//NbHttpHandler HTTP/2のステータスライン
+TEST(NbHttpHandler, StatusLineHttp2) {
+    static const vector<string> headers = {
+        "HTTP/2 201 \r\n",
+        "content-type: application/json\r\n",
+        "x-content-length: 12345\r\n",
+        "\r\n"};
+
+    NbHttpHandler handler;
+    for (auto header : headers) {
+        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+
+    NbHttpResponse response = handler.Parse();
+    EXPECT_EQ(201, response.GetStatusCode());
+    EXPECT_EQ(string(""), response.GetReasonPhrase());
+    EXPECT_EQ(2, response.GetHeaders().size());
+    string value;
+    EXPECT_TRUE(response.GetHeader("X-Content-Length", &value));
+    EXPECT_EQ(string("12345"), value);
+}
+
+// 受信ボディの確保サイズ確認用
+class NbHttpHandlerCapacity : public NbHttpHandler {
+  public:
+    size_t GetBodyCapacity() const { return response_body_.capacity(); }
+};
+
+//NbHttpHandler Content-Lengthによるボディ領域の事前確保
+TEST(NbHttpHandler, ReserveContentLength) {
+    vector<string> headers = {
+        "HTTP/1.1 100 Continue\r\n",
+        "content-length: 99999\r\n",
+        "\r\n",
+        "HTTP/1.1 200 OK\r\n",
+        "CONTENT-LENGTH: 4096\r\n",
+        "\r\n"};
+    NbHttpHandlerCapacity handler;
+    for (auto header : headers) {
+        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+
+    // 最初の受信で最終レスポンスのContent-Length分を確保し、以降は再確保しない
+    vector<char> chunk(1024, 'a');
+    handler.WriteCallback(chunk.data(), 1, chunk.size());
+    EXPECT_EQ(4096, handler.GetBodyCapacity());
+    for (int i = 0; i < 3; ++i) {
+        handler.WriteCallback(chunk.data(), 1, chunk.size());
+    }
+    EXPECT_EQ(4096, handler.GetBodyCapacity());
+
+    NbHttpResponse response = handler.Parse();
+    EXPECT_EQ(200, response.GetStatusCode());
+    EXPECT_EQ(4096, response.GetBody().size());
+}
+
+//NbHttpHandler 圧縮転送時はContent-Lengthで事前確保しない
+TEST(NbHttpHandler, ReserveContentLengthEncoded) {
+    vector<string> headers = {
+        "HTTP/1.1 200 OK\r\n",
+        "Content-Length: 4096\r\n",
+        "content-encoding: gzip\r\n",
+        "\r\n"};
+    NbHttpHandlerCapacity handler;
+    for (auto header : headers) {
+        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+
+    // Content-Lengthは展開前のサイズのため、展開後の受信サイズに応じて拡張する
+    vector<char> chunk(1024, 'a');
+    handler.WriteCallback(chunk.data(), 1, chunk.size());
+    EXPECT_GT(4096, handler.GetBodyCapacity());
+
+    // identityは無変換のため確保する
+    NbHttpHandlerCapacity identity_handler;
+    headers[2] = "Content-Encoding: identity\r\n";
+    for (auto header : headers) {
+        identity_handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+    identity_handler.WriteCallback(chunk.data(), 1, chunk.size());
+    EXPECT_EQ(4096, identity_handler.GetBodyCapacity());
+}
+
 //NbHttpHandler ReadCallback
 TEST(NbHttpHandler, ReadCallback) {
     NbHttpHandler handler;
@@ -276,6 +276,24 @@ TEST(NbHttpRequestFactory, UserAgent) {
     EXPECT_EQ(kEmpty, request.GetProxy());
 }
 
+//NbHttpRequestFactory Hedgeable
+TEST(NbHttpRequestFactory, Hedgeable) {
+    NbHttpRequestFactory factory(kEndPointUrl, kTenantId, kAppId, kAppKey, kSessionToken, kEmpty);
+    EXPECT_FALSE(factory.Get(kPath).Build().IsHedgeable());
+
+    NbHttpRequestFactory hedge_factory(kEndPointUrl, kTenantId, kAppId, kAppKey, kSessionToken, kEmpty);
+    EXPECT_TRUE(hedge_factory.Get(kPath).Hedgeable().Build().IsHedgeable());
+}
+
+//NbHttpRequestFactory CompressibleBody
+TEST(NbHttpRequestFactory, CompressibleBody) {
+    NbHttpRequestFactory factory(kEndPointUrl, kTenantId, kAppId, kAppKey, kSessionToken, kEmpty);
+    EXPECT_FALSE(factory.Put(kPath).Body(kBody).Build().IsBodyCompressible());
+
+    NbHttpRequestFactory compress_factory(kEndPointUrl, kTenantId, kAppId, kAppKey, kSessionToken, kEmpty);
+    EXPECT_TRUE(compress_factory.Put(kPath).Body(kBody).CompressibleBody().Build().IsBodyCompressible());
+}
+
 //NbHttpRequestFactory IsError
 TEST(NbHttpRequestFactory, IsError) {
     NbHttpRequestFactory *factory = new NbHttpRequestFactory(kEmpty, kTenantId, kAppId, kAppKey, kSessionToken, kProxy);
@@ -1,6 +1,9 @@
 #include "gtest/gtest.h"
 #include "necbaas/nb_http_response.h"
+#include "necbaas/nb_result.h"
 #include "necbaas/internal/nb_logger.h"
+#include <thread>
+#include <vector>
 
 namespace necbaas {
 
@@ -16,6 +19,37 @@ TEST(NbHttpResponse, NbHttpResponse) {
     EXPECT_EQ(kEmpty, response.GetReasonPhrase());
     EXPECT_TRUE(response.GetHeaders().empty());
     EXPECT_TRUE(response.GetBody().empty());
+    EXPECT_EQ(0, response.GetTransferInfo().total_time_us);
+    EXPECT_EQ(0, response.GetTransferInfo().download_size);
+}
+
+//NbHttpResponse 転送情報
+TEST(NbHttpResponse, TransferInfo) {
+    NbHttpResponse response;
+    NbTransferInfo info;
+    info.name_lookup_time_us = 1;
+    info.connect_time_us = 2;
+    info.app_connect_time_us = 3;
+    info.pre_transfer_time_us = 4;
+    info.start_transfer_time_us = 5;
+    info.total_time_us = 6;
+    info.request_size = 7;
+    info.response_header_size = 8;
+    info.upload_size = 9;
+    info.download_size = 10;
+    response.SetTransferInfo(info);
+
+    const NbTransferInfo &result = response.GetTransferInfo();
+    EXPECT_EQ(1, result.name_lookup_time_us);
+    EXPECT_EQ(2, result.connect_time_us);
+    EXPECT_EQ(3, result.app_connect_time_us);
+    EXPECT_EQ(4, result.pre_transfer_time_us);
+    EXPECT_EQ(5, result.start_transfer_time_us);
+    EXPECT_EQ(6, result.total_time_us);
+    EXPECT_EQ(7, result.request_size);
+    EXPECT_EQ(8, result.response_header_size);
+    EXPECT_EQ(9, result.upload_size);
+    EXPECT_EQ(10, result.download_size);
 }
 
 
@@ -33,6 +67,67 @@ TEST(NbHttpResponse, NbHttpResponseValue) {
     EXPECT_EQ(string("OK"), response.GetReasonPhrase());
     EXPECT_EQ(headers, response.GetHeaders());
     EXPECT_EQ(body, response.GetBody());
+
+    // ヘッダ名は大文字小文字を区別しない
+    string value;
+    EXPECT_TRUE(response.GetHeader("x-header-key1", &value));
+    EXPECT_EQ(string("abcdef"), value);
+    EXPECT_TRUE(response.GetHeader("X-Header-Key2", &value));
+    EXPECT_EQ(string("123456"), value);
+    EXPECT_FALSE(response.GetHeader("X-HEADER-KEY3", &value));
+}
+
+//NbHttpResponse ムーブ(ボディを複製しない)
+TEST(NbHttpResponse, MoveBody) {
+    std::vector<char> body(1024, 'a');
+    const char *data = body.data();
+
+    NbHttpResponse response(200, "OK", std::multimap<std::string, std::string>(), std::move(body));
+    EXPECT_EQ(data, response.GetBody().data());
+
+    NbResult<NbHttpResponse> result(NbResultCode::NB_OK);
+    result.SetSuccessData(std::move(response));
+    EXPECT_EQ(data, result.GetSuccessData().GetBody().data());
+
+    NbResult<NbHttpResponse> moved_result = std::move(result);
+    EXPECT_EQ(data, moved_result.GetSuccessData().GetBody().data());
+
+    // 右辺値からの取得はボディを取り出す
+    std::vector<char> moved_body = std::move(moved_result).GetSuccessData().GetBody();
+    EXPECT_EQ(data, moved_body.data());
+    EXPECT_EQ(1024, moved_body.size());
+}
+
+//NbHttpResponse ヘッダリスト生成(受信データ、複数スレッドから同時に取得)
+TEST(NbHttpResponse, GetHeadersConcurrent) {
+    string header_buffer = "X-HEADER-KEY1abcdefX-HEADER-KEY2123456";
+    std::vector<NbHttpResponse::HeaderField> header_fields{{0, 13, 13, 6}, {19, 13, 32, 6}};
+    NbHttpResponse response(200, "OK", header_buffer, header_fields, std::vector<char>());
+
+    std::multimap<std::string, std::string> expected;
+    expected.insert(std::make_pair("X-HEADER-KEY1", "abcdef"));
+    expected.insert(std::make_pair("X-HEADER-KEY2", "123456"));
+
+    std::vector<const std::multimap<std::string, std::string> *> results(8);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&response, &results, i] { results[i] = &response.GetHeaders(); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    // 生成は1回のみ
+    for (auto headers : results) {
+        EXPECT_EQ(&response.GetHeaders(), headers);
+    }
+    EXPECT_EQ(expected, response.GetHeaders());
+
+    // コピー先は自身の格納領域から生成する
+    NbHttpResponse copied = response;
+    EXPECT_EQ(expected, copied.GetHeaders());
+    EXPECT_NE(&response.GetHeaders(), &copied.GetHeaders());
+    copied = NbHttpResponse();
+    EXPECT_TRUE(copied.GetHeaders().empty());
 }
 
 //NbHttpResponse Dump(ログ無効)
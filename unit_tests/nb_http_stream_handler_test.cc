@@ -0,0 +1,85 @@
+#include "gtest/gtest.h"
+#include "necbaas/internal/nb_http_stream_handler.h"
+
+namespace necbaas {
+
+using std::string;
+using std::vector;
+
+static const vector<string> kHeaders = {
+    "HTTP/1.1 200 OK\r\n",
+    "Content-Type: application/octet-stream\r\n",
+    "Content-Length: 20\r\n",
+    "\r\n"};
+
+static char kBuf[] = "1234567890abcdefghij";
+
+//NbHttpStreamHandler 通常処理
+TEST(NbHttpStreamHandler, Normal) {
+    string received;
+    int call_count = 0;
+    NbHttpStreamHandler handler([&received, &call_count](const char *data, size_t size) {
+        received.append(data, size);
+        ++call_count;
+        return true;
+    });
+
+    for (auto header : kHeaders) {
+        EXPECT_EQ(header.size(), handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size()));
+    }
+
+    EXPECT_EQ(10, handler.WriteCallback(kBuf, 1, 10));
+    EXPECT_EQ(0, handler.WriteCallback(kBuf, 1, 0));
+    EXPECT_EQ(10, handler.WriteCallback(kBuf + 10, 1, 10));
+
+    // 受信の都度出力し、ボディは保持しない
+    EXPECT_EQ(string(kBuf), received);
+    EXPECT_EQ(2, call_count);
+    EXPECT_FALSE(handler.IsAborted());
+
+    NbHttpResponse response = handler.Parse();
+    EXPECT_EQ(200, response.GetStatusCode());
+    EXPECT_TRUE(response.GetBody().empty());
+}
+
+//NbHttpStreamHandler ステータスコード200台以外
+TEST(NbHttpStreamHandler, StatusCodeError) {
+    static const vector<string> headers = {
+        "HTTP/1.1 404 Not Found\r\n",
+        "Content-Type: application/json\r\n",
+        "\r\n"};
+    bool called = false;
+    NbHttpStreamHandler handler([&called](const char *data, size_t size) {
+        called = true;
+        return true;
+    });
+
+    for (auto header : headers) {
+        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+    EXPECT_EQ(20, handler.WriteCallback(kBuf, 1, 20));
+
+    // エラー内容はボディとして保持する
+    EXPECT_FALSE(called);
+    NbHttpResponse response = handler.Parse();
+    EXPECT_EQ(404, response.GetStatusCode());
+    EXPECT_EQ(string(kBuf), string(response.GetBody().begin(), response.GetBody().end()));
+}
+
+//NbHttpStreamHandler 出力先による中断
+TEST(NbHttpStreamHandler, Abort) {
+    int call_count = 0;
+    NbHttpStreamHandler handler([&call_count](const char *data, size_t size) {
+        return (++call_count < 2);
+    });
+
+    for (auto header : kHeaders) {
+        handler.WriteHeaderCallback((void *)header.c_str(), 1, header.size());
+    }
+
+    EXPECT_EQ(10, handler.WriteCallback(kBuf, 1, 10));
+    EXPECT_FALSE(handler.IsAborted());
+    EXPECT_EQ(0, handler.WriteCallback(kBuf + 10, 1, 10));
+    EXPECT_TRUE(handler.IsAborted());
+}
+} //namespace necbaas
@@ -0,0 +1,54 @@
+#include "gtest/gtest.h"
+#include <curl/curl.h>
+#include <cstring>
+#include "necbaas/internal/nb_http_stream_upload_handler.h"
+
+namespace necbaas {
+
+using std::string;
+
+static const string kData = "1234567890abcdefghij";
+
+//NbHttpStreamUploadHandler 通常処理
+TEST(NbHttpStreamUploadHandler, Normal) {
+    size_t offset = 0;
+    NbHttpStreamUploadHandler handler([&offset](char *buffer, size_t size) -> int64_t {
+        size_t copy_size = std::min(size, kData.size() - offset);
+        std::memcpy(buffer, kData.c_str() + offset, copy_size);
+        offset += copy_size;
+        return copy_size;
+    });
+
+    char buffer[16];
+    string sent;
+    size_t read_size;
+    while ((read_size = handler.ReadCallback(buffer, 1, 8)) > 0) {
+        sent.append(buffer, read_size);
+    }
+
+    EXPECT_EQ(kData, sent);
+    EXPECT_FALSE(handler.IsAborted());
+}
+
+//NbHttpStreamUploadHandler 生成関数による中断
+TEST(NbHttpStreamUploadHandler, Abort) {
+    NbHttpStreamUploadHandler handler([](char *buffer, size_t size) -> int64_t {
+        return -1;
+    });
+
+    char buffer[16];
+    EXPECT_EQ(CURL_READFUNC_ABORT, handler.ReadCallback(buffer, 1, sizeof(buffer)));
+    EXPECT_TRUE(handler.IsAborted());
+}
+
+//NbHttpStreamUploadHandler 生成関数がバッファサイズを超える値を返す
+TEST(NbHttpStreamUploadHandler, InvalidSize) {
+    NbHttpStreamUploadHandler handler([](char *buffer, size_t size) -> int64_t {
+        return size + 1;
+    });
+
+    char buffer[16];
+    EXPECT_EQ(CURL_READFUNC_ABORT, handler.ReadCallback(buffer, 1, sizeof(buffer)));
+    EXPECT_TRUE(handler.IsAborted());
+}
+}  // namespace necbaas
@@ -0,0 +1,47 @@
+#include "gtest/gtest.h"
+#include "necbaas/internal/nb_latency_window.h"
+
+namespace necbaas {
+
+//NbLatencyWindow::GetPercentile
+TEST(NbLatencyWindow, GetPercentile) {
+    NbLatencyWindow window(100);
+    EXPECT_EQ(0, window.GetCount());
+    EXPECT_EQ(0, window.GetPercentile(99));
+
+    // 100～1の逆順で記録
+    for (int i = 100; i > 0; --i) {
+        window.Add(i);
+    }
+    EXPECT_EQ(100, window.GetCount());
+    EXPECT_EQ(1, window.GetPercentile(0));
+    EXPECT_EQ(1, window.GetPercentile(1));
+    EXPECT_EQ(50, window.GetPercentile(50));
+    EXPECT_EQ(95, window.GetPercentile(95));
+    EXPECT_EQ(100, window.GetPercentile(100));
+    EXPECT_EQ(100, window.GetPercentile(200));
+}
+
+//NbLatencyWindow::Add(保持数超過)
+TEST(NbLatencyWindow, Add) {
+    NbLatencyWindow window(3);
+    window.Add(1000);
+    window.Add(1);
+    window.Add(2);
+    window.Add(3);
+    EXPECT_EQ(3, window.GetCount());
+    EXPECT_EQ(3, window.GetPercentile(100));
+}
+
+//NbLatencyWindow::Resize
+TEST(NbLatencyWindow, Resize) {
+    NbLatencyWindow window(0);
+    window.Add(10);
+    window.Add(20);
+    EXPECT_EQ(1, window.GetCount());
+    EXPECT_EQ(20, window.GetPercentile(50));
+
+    window.Resize(10);
+    EXPECT_EQ(0, window.GetCount());
+}
+} //namespace necbaas
@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+#include <thread>
+#include <vector>
+#include "necbaas/internal/nb_metrics_registry.h"
+
+namespace necbaas {
+
+static NbResult<NbHttpResponse> CreateResult(NbResultCode code) {
+    NbResult<NbHttpResponse> result(code);
+    NbTransferInfo transfer_info;
+    transfer_info.request_size = 100;
+    transfer_info.upload_size = 20;
+    transfer_info.response_header_size = 50;
+    transfer_info.download_size = 300;
+    result.SetTransferInfo(transfer_info);
+    return result;
+}
+
+//NbMetricsRegistry::Record, GetStatistics
+TEST(NbMetricsRegistry, Record) {
+    NbMetricsRegistry registry;
+    registry.Record(NbOperation::OBJECT_QUERY, CreateResult(NbResultCode::NB_OK), 1000);
+    registry.Record(NbOperation::OBJECT_QUERY, CreateResult(NbResultCode::NB_OK), 20);
+    registry.Record(NbOperation::OBJECT_QUERY, CreateResult(NbResultCode::NB_ERROR_RESPONSE), 3000);
+    registry.Record(NbOperation::LOGIN, CreateResult(NbResultCode::NB_ERROR_CURL_RUNTIME), -1);
+
+    NbStatistics statistics;
+    registry.GetStatistics(&statistics);
+    // 記録の無い操作は含まない
+    ASSERT_EQ(2, statistics.operations.size());
+
+    const NbOperationStatistics &query = statistics.operations[NbOperation::OBJECT_QUERY];
+    EXPECT_EQ(3, query.request_count);
+    EXPECT_EQ(1, query.error_count);
+    EXPECT_EQ(2, query.result_counts.at(NbResultCode::NB_OK));
+    EXPECT_EQ(1, query.result_counts.at(NbResultCode::NB_ERROR_RESPONSE));
+    EXPECT_EQ(360, query.bytes_sent);
+    EXPECT_EQ(1050, query.bytes_received);
+    EXPECT_EQ(3, query.latency.GetCount());
+    EXPECT_EQ(20, query.latency.GetMin());
+    EXPECT_EQ(3000, query.latency.GetMax());
+    EXPECT_DOUBLE_EQ(4020.0 / 3, query.latency.GetMean());
+
+    const NbOperationStatistics &login = statistics.operations[NbOperation::LOGIN];
+    EXPECT_EQ(1, login.request_count);
+    EXPECT_EQ(1, login.error_count);
+    EXPECT_EQ(0, login.latency.GetMin());
+
+    // クリア
+    registry.Reset();
+    registry.GetStatistics(&statistics);
+    EXPECT_TRUE(statistics.operations.empty());
+}
+
+//NbMetricsRegistry::Record(末尾に追加した処理結果コード)
+TEST(NbMetricsRegistry, RecordAppendedResultCode) {
+    // 既存の処理結果コードの値は変わらない
+    EXPECT_EQ(20, static_cast<int>(NbResultCode::NB_FATAL));
+
+    NbMetricsRegistry registry;
+    registry.Record(NbOperation::OBJECT_QUERY, CreateResult(NbResultCode::NB_ERROR_CANCELED), 10);
+    registry.Record(NbOperation::OBJECT_QUERY, CreateResult(NbResultCode::NB_ERROR_CIRCUIT_OPEN), 10);
+
+    NbStatistics statistics;
+    registry.GetStatistics(&statistics);
+    const NbOperationStatistics &query = statistics.operations[NbOperation::OBJECT_QUERY];
+    EXPECT_EQ(1, query.result_counts.at(NbResultCode::NB_ERROR_CANCELED));
+    EXPECT_EQ(1, query.result_counts.at(NbResultCode::NB_ERROR_CIRCUIT_OPEN));
+}
+
+//NbMetricsRegistry::Record(マルチスレッド)
+TEST(NbMetricsRegistry, RecordMultiThread) {
+    static const int kThreadNum = 8;
+    static const int kLoopNum = 1000;
+    NbMetricsRegistry registry;
+    NbResult<NbHttpResponse> result = CreateResult(NbResultCode::NB_OK);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreadNum; ++i) {
+        threads.emplace_back([&registry, &result, i] {
+            for (int j = 0; j < kLoopNum; ++j) {
+                registry.Record(NbOperation::FILE_DOWNLOAD, result, i * kLoopNum + j);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    NbStatistics statistics;
+    registry.GetStatistics(&statistics);
+    const NbOperationStatistics &download = statistics.operations[NbOperation::FILE_DOWNLOAD];
+    EXPECT_EQ(kThreadNum * kLoopNum, download.request_count);
+    EXPECT_EQ(kThreadNum * kLoopNum, download.latency.GetCount());
+    EXPECT_EQ(0, download.latency.GetMin());
+    EXPECT_EQ(kThreadNum * kLoopNum - 1, download.latency.GetMax());
+    EXPECT_EQ(120ULL * kThreadNum * kLoopNum, download.bytes_sent);
+}
+} //namespace necbaas
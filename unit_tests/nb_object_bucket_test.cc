@@ -1,9 +1,13 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <curlpp/cURLpp.hpp>
 #include "necbaas/nb_object_bucket.h"
 #include "necbaas/internal/nb_utility.h"
 #include "rest_api_mock.h"
+#include "local_http_server.h"
 
 namespace necbaas {
 
@@ -86,6 +90,7 @@ static NbResult<NbHttpResponse> GetObject1(const NbHttpRequest &request, int tim
     EXPECT_EQ(NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, request.GetMethod());
     EXPECT_EQ(3, request.GetHeaders().size());
     EXPECT_TRUE(request.GetBody().empty());
+    EXPECT_TRUE(request.IsHedgeable());
     EXPECT_EQ(60, timeout);
 
     NbResult<NbHttpResponse> tmp_result(NbResultCode::NB_OK);
@@ -162,6 +167,9 @@ static NbResult<NbHttpResponse> GetObjectRestError(const NbHttpRequest &request,
 
     NbRestError response{404, body_str};
     tmp_result.SetRestError(response);
+    NbTransferInfo transfer_info;
+    transfer_info.total_time_us = 1234;
+    tmp_result.SetTransferInfo(transfer_info);
     return tmp_result;
 }
 
@@ -179,6 +187,8 @@ TEST_F(NbObjectBucketTest, GetObjectRestError) {
     NbRestError rest_error = result.GetRestError();
     EXPECT_EQ(404, result.GetRestError().status_code);
     EXPECT_EQ(string("Http Response Error"), result.GetRestError().reason);
+    // 転送情報はエラー時も引き継ぐ
+    EXPECT_EQ(1234, result.GetTransferInfo().total_time_us);
 }
 
 static NbResult<NbHttpResponse> GetObjectFatal(const NbHttpRequest &request, int timeout) {
@@ -262,6 +272,7 @@ static NbResult<NbHttpResponse> Query1(const NbHttpRequest &request, int timeout
     EXPECT_EQ(NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, request.GetMethod());
     EXPECT_EQ(3, request.GetHeaders().size());
     EXPECT_TRUE(request.GetBody().empty());
+    EXPECT_TRUE(request.IsHedgeable());
     EXPECT_EQ(60, timeout);
 
     NbResult<NbHttpResponse> tmp_result(NbResultCode::NB_OK);
@@ -432,6 +443,124 @@ TEST_F(NbObjectBucketTest, QueryConnectionOver) {
     EXPECT_EQ(NbResultCode::NB_ERROR_CONNECTION_OVER, result.GetResultCode());
 }
 
+//NbObjectBucket::QueryAsync(queryあり、ヒットあり、countあり)
+TEST_F(NbObjectBucketTest, QueryAsync) {
+    SetExpectAsync(&Query2);
+
+    shared_ptr<NbService> service(mock_service_);
+
+    NbObjectBucket object_bucket(service, kBucketName);
+    NbQuery query;
+    query.EqualTo(string("key1"),string("abc")).GreaterThan(string("key2"),123);
+    int count = 0;
+    int callback_count = 0;
+    std::future<NbResult<std::vector<NbObject>>> future = object_bucket.QueryAsync(query, &count,
+        [&callback_count](const NbResult<std::vector<NbObject>> &result) {
+            EXPECT_TRUE(result.IsSuccess());
+            ++callback_count;
+        });
+    NbResult<std::vector<NbObject>> result = future.get();
+
+    // 戻り値確認
+    EXPECT_EQ(1, callback_count);
+    EXPECT_TRUE(result.IsSuccess());
+    std::vector<NbObject> response = result.GetSuccessData();
+    EXPECT_EQ(3, count);
+    EXPECT_EQ(3, response.size());
+    EXPECT_EQ("Foo1", response[0].GetString("name"));
+    EXPECT_EQ(kBucketName, response[0].GetBucketName());
+}
+
+//NbObjectBucket::QueryAsync(RESTエラー、コールバックなし)
+TEST_F(NbObjectBucketTest, QueryAsyncRestError) {
+    SetExpectAsync(&QueryRestError);
+
+    shared_ptr<NbService> service(mock_service_);
+
+    NbObjectBucket object_bucket(service, kBucketName);
+    NbQuery query;
+    NbResult<std::vector<NbObject>> result = object_bucket.QueryAsync(query).get();
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsRestError());
+    EXPECT_EQ(404, result.GetRestError().status_code);
+}
+
+//NbObjectBucket::QueryAsync(バケット名空)
+TEST_F(NbObjectBucketTest, QueryAsyncBucketNameEmpty) {
+    shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+
+    NbObjectBucket object_bucket(service, kEmpty);
+    NbQuery query;
+    int callback_count = 0;
+    std::future<NbResult<std::vector<NbObject>>> future = object_bucket.QueryAsync(query, nullptr,
+        [&callback_count](const NbResult<std::vector<NbObject>> &result) {
+            EXPECT_EQ(NbResultCode::NB_ERROR_BUCKET_NAME, result.GetResultCode());
+            ++callback_count;
+        });
+
+    // 戻り値確認
+    EXPECT_EQ(1, callback_count);
+    EXPECT_EQ(NbResultCode::NB_ERROR_BUCKET_NAME, future.get().GetResultCode());
+}
+
+//NbObjectBucket::QueryAsync(実行中にサービス破棄)
+TEST(NbObjectBucketAsync, QueryAsyncServiceDestroyed) {
+    LocalHttpServer server(kQureyResponse);
+    server.SetResponseDelays({300});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, kEmpty);
+    std::unique_ptr<NbObjectBucket> object_bucket(new NbObjectBucket(service, kBucketName));
+    std::future<NbResult<std::vector<NbObject>>> future = object_bucket->QueryAsync(NbQuery());
+
+    // 呼び出し元スレッドでの破棄は実行中の非同期リクエストを中断する
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    object_bucket.reset();
+    service.reset();
+
+    EXPECT_EQ(NbResultCode::NB_ERROR_CANCELED, future.get().GetResultCode());
+}
+
+//NbObjectBucket::QueryAsync(イベントループスレッドで最後の参照を解放)
+TEST(NbObjectBucketAsync, QueryAsyncServiceReleasedOnLoopThread) {
+    LocalHttpServer server(kQureyResponse);
+    server.SetResponseDelays({300});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, kEmpty);
+    std::weak_ptr<NbService> weak_service = service;
+    std::atomic<int> callback_count{0};
+    {
+        NbObjectBucket object_bucket(service, kBucketName);
+        // 完了コールバックで呼び出し元の参照を解放し、結果(NbObject)の参照をイベントループスレッドで最後に解放させる
+        object_bucket.QueryAsync(NbQuery(), nullptr,
+            [&service, &callback_count](const NbResult<std::vector<NbObject>> &result) {
+                EXPECT_TRUE(result.IsSuccess());
+                service.reset();
+                ++callback_count;
+            });
+    }
+
+    // イベントループスレッドを自身で停止・破棄せずにサービスが破棄される
+    for (int i = 0; i < 100 && !weak_service.expired(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    EXPECT_EQ(1, callback_count);
+    EXPECT_TRUE(weak_service.expired());
+    // 別スレッドでの破棄(イベントループスレッドのjoin)の完了を待つ
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+}
+
+//NbObjectBucket::QueryAsync(request_factory構築失敗)
+TEST_F(NbObjectBucketTest, QueryAsyncRequestFactoryFail) {
+    shared_ptr<NbService> service = NbService::CreateService(kEmpty, kTenantId, kAppId, kAppKey, kProxy);
+
+    NbObjectBucket object_bucket(service, kBucketName);
+    NbQuery query;
+    NbResult<std::vector<NbObject>> result = object_bucket.QueryAsync(query).get();
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsFatalError());
+    EXPECT_EQ(NbResultCode::NB_ERROR_ENDPOINT_URL, result.GetResultCode());
+}
+
 static NbResult<NbHttpResponse> GetParams(const NbHttpRequest &request, int timeout) {
     string query_str = curlpp::unescape(request.GetUrl().substr(request.GetUrl().find("?") + 1));
 
@@ -64,6 +64,7 @@ static NbResult<NbHttpResponse> PartUpdateObject1(const NbHttpRequest &request,
                      request.GetUrl().substr(request.GetUrl().find("/objects/")));
     EXPECT_EQ(NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT, request.GetMethod());
     EXPECT_EQ(4, request.GetHeaders().size());
+    EXPECT_TRUE(request.IsBodyCompressible());
     int check_header = 0;
     for (auto header : request.GetHeaders()) {
         if (header.find("Content-Type: application/json") != std::string::npos) {
@@ -356,6 +357,7 @@ static NbResult<NbHttpResponse> DeleteObject1(const NbHttpRequest &request, int
                      request.GetUrl().substr(request.GetUrl().find("/objects/")));
     EXPECT_EQ(NbHttpRequestMethod::HTTP_REQUEST_TYPE_DELETE, request.GetMethod());
     EXPECT_EQ(3, request.GetHeaders().size());
+    EXPECT_FALSE(request.IsBodyCompressible());
     EXPECT_EQ(kEmpty, request.GetBody());
     EXPECT_EQ(60, timeout);
 
@@ -554,6 +556,7 @@ static NbResult<NbHttpResponse> SaveNew1(const NbHttpRequest &request, int timeo
                      request.GetUrl().substr(request.GetUrl().find("/objects/")));
     EXPECT_EQ(NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST, request.GetMethod());
     EXPECT_EQ(4, request.GetHeaders().size());
+    EXPECT_TRUE(request.IsBodyCompressible());
     int check_header = 0;
     for (auto header : request.GetHeaders()) {
         if (header.find("Content-Type: application/json") != std::string::npos) {
@@ -657,6 +660,7 @@ static NbResult<NbHttpResponse> SaveUpdate1(const NbHttpRequest &request, int ti
                      request.GetUrl().substr(request.GetUrl().find("/objects/")));
     EXPECT_EQ(NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT, request.GetMethod());
     EXPECT_EQ(4, request.GetHeaders().size());
+    EXPECT_TRUE(request.IsBodyCompressible());
     int check_header = 0;
     for (auto header : request.GetHeaders()) {
         if (header.find("Content-Type: application/json") != std::string::npos) {
@@ -865,6 +869,63 @@ TEST_F(NbObjectTest, SaveConnectionOver) {
     EXPECT_EQ(NbResultCode::NB_ERROR_CONNECTION_OVER, result.GetResultCode());
 }
 
+//NbObject::SaveAsync(更新、作成日時あり、Etagあり)
+TEST_F(NbObjectTest, SaveAsync) {
+    SetExpectAsync(&SaveUpdate2);
+
+    shared_ptr<NbService> service(mock_service_);
+
+    NbObject object(service, kBucketName);
+    object.SetCurrentParam(NbJsonObject(kDefaultObject));
+    object["_id"] = "id";
+    int callback_count = 0;
+    std::future<NbResult<NbObject>> future = object.SaveAsync(false,
+        [&callback_count](const NbResult<NbObject> &result) {
+            EXPECT_TRUE(result.IsSuccess());
+            ++callback_count;
+        });
+    NbResult<NbObject> result = future.get();
+
+    // 戻り値確認
+    EXPECT_EQ(1, callback_count);
+    EXPECT_TRUE(result.IsSuccess());
+    NbObject response = result.GetSuccessData();
+    EXPECT_EQ(123, response.GetInt("intKey"));
+    EXPECT_EQ("stringValue", response.GetString("stringKey"));
+    EXPECT_EQ("521c36d4ac521e1ffa000007", response.GetObjectId());
+    EXPECT_EQ(kBucketName, response.GetBucketName());
+    // 自インスタンスは更新されない
+    EXPECT_EQ("id", object.GetString("_id"));
+}
+
+//NbObject::SaveAsync(RESTエラー)
+TEST_F(NbObjectTest, SaveAsyncRestError) {
+    SetExpectAsync(&SaveRestError);
+
+    shared_ptr<NbService> service(mock_service_);
+
+    NbObject object(service, kBucketName);
+    object.SetCurrentParam(NbJsonObject(kSaveNew));
+    NbResult<NbObject> result = object.SaveAsync().get();
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsRestError());
+    EXPECT_EQ(404, result.GetRestError().status_code);
+}
+
+//NbObject::SaveAsync(バケット名空)
+TEST_F(NbObjectTest, SaveAsyncBucketNameEmpty) {
+    shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+
+    NbObject object(service, kEmpty);
+    object.SetCurrentParam(NbJsonObject(kSaveNew));
+    NbResult<NbObject> result = object.SaveAsync().get();
+
+    // 戻り値確認
+    EXPECT_TRUE(result.IsFatalError());
+    EXPECT_EQ(NbResultCode::NB_ERROR_BUCKET_NAME, result.GetResultCode());
+}
+
 //NbObject::SetCurrentParam
 TEST_F(NbObjectTest, SetCurrentParam) {
     shared_ptr<NbService> service = NbService::CreateService(kEmpty, kTenantId, kAppId, kAppKey, kProxy);
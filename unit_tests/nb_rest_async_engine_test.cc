@@ -0,0 +1,156 @@
+#include "gtest/gtest.h"
+#include "necbaas/internal/nb_rest_async_engine.h"
+#include <chrono>
+#include <condition_variable>
+#include <curlpp/cURLpp.hpp>
+#include "necbaas/internal/nb_rest_executor.h"
+#include "necbaas/internal/nb_token_bucket.h"
+#include "local_http_server.h"
+
+namespace necbaas {
+
+using std::string;
+using std::vector;
+
+static NbHttpRequest MakeRequest(const string &url) {
+    return NbHttpRequest(url, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), string(), string());
+}
+
+class NbRestAsyncEngineTest : public ::testing::Test {
+  protected:
+    virtual void SetUp() {
+        curlpp::initialize();
+    }
+
+    virtual void TearDown() {
+        curlpp::terminate();
+    }
+
+    // 指定数のコールバック完了を待つ
+    bool WaitCallback(int count) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return cond_.wait_for(lock, std::chrono::seconds(10), [this, count] { return callback_count_ >= count; });
+    }
+
+    void OnComplete(NbResult<NbHttpResponse> result) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(result);
+        ++callback_count_;
+        cond_.notify_all();
+    }
+
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    int callback_count_{0};
+    vector<NbResult<NbHttpResponse>> results_;
+};
+
+//NbRestAsyncEngine::Submit(正常)
+TEST_F(NbRestAsyncEngineTest, Submit) {
+    LocalHttpServer server;
+    NbRestAsyncEngine engine;
+
+    engine.Submit(MakeRequest(server.GetUrl()), 10, [this](NbResult<NbHttpResponse> result) { OnComplete(result); });
+
+    ASSERT_TRUE(WaitCallback(1));
+    ASSERT_TRUE(results_[0].IsSuccess());
+    const NbHttpResponse &response = results_[0].GetSuccessData();
+    EXPECT_EQ(200, response.GetStatusCode());
+    EXPECT_EQ(string("hello"), string(response.GetBody().begin(), response.GetBody().end()));
+}
+
+//NbRestAsyncEngine::Submit(帯域制限、POSTボディも送信コールバックで制限する)
+TEST_F(NbRestAsyncEngineTest, SubmitBodyBandwidthLimit) {
+    static const int kBodySize = 300 * 1024;
+    LocalHttpServer server;
+    NbRestAsyncEngine engine;
+    auto limiter = std::make_shared<NbTokenBucket>();
+    limiter->SetRate(200 * 1024);
+    engine.SetExecutorSetup([limiter](NbRestExecutor *executor) { executor->SetBandwidthLimiter(limiter, nullptr); });
+
+    // 1秒分を超えた100KB分(500ms)は一時停止して送信する
+    NbHttpRequest request(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST, std::list<string>(),
+                          string(kBodySize, 'a'), string());
+    auto start = std::chrono::steady_clock::now();
+    engine.Submit(request, 10, [this](NbResult<NbHttpResponse> result) { OnComplete(result); });
+
+    ASSERT_TRUE(WaitCallback(1));
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_TRUE(results_[0].IsSuccess());
+    EXPECT_LE(400, elapsed.count());
+    ASSERT_EQ(1, server.GetRequestBodySizes().size());
+    EXPECT_EQ(kBodySize, server.GetRequestBodySizes()[0]);
+    // 送信サイズは二重に計上しない
+    EXPECT_EQ(kBodySize, results_[0].GetSuccessData().GetRequestBodySize());
+}
+
+//NbRestAsyncEngine::Submit(多重実行、接続数上限超過)
+TEST_F(NbRestAsyncEngineTest, SubmitMany) {
+    static const int kRequestNum = 100;
+    LocalHttpServer server;
+    NbRestAsyncEngine engine(4);
+
+    for (int i = 0; i < kRequestNum; ++i) {
+        engine.Submit(MakeRequest(server.GetUrl()), 10, [this](NbResult<NbHttpResponse> result) { OnComplete(result); });
+    }
+
+    ASSERT_TRUE(WaitCallback(kRequestNum));
+    for (auto &result : results_) {
+        EXPECT_TRUE(result.IsSuccess());
+    }
+}
+
+//NbRestAsyncEngine::Submit(接続失敗)
+TEST_F(NbRestAsyncEngineTest, SubmitConnectError) {
+    NbRestAsyncEngine engine;
+
+    engine.Submit(MakeRequest("http://127.0.0.1:1/"), 10,
+                  [this](NbResult<NbHttpResponse> result) { OnComplete(result); });
+
+    ASSERT_TRUE(WaitCallback(1));
+    EXPECT_EQ(NbResultCode::NB_ERROR_CURL_RUNTIME, results_[0].GetResultCode());
+}
+
+//NbRestAsyncEngine::~NbRestAsyncEngine(実行中の転送をキャンセル)
+TEST_F(NbRestAsyncEngineTest, DestructCancel) {
+    // acceptしないサーバ(応答待ちのまま残る)
+    int listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    listen(listen_fd, 16);
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    string url = "http://127.0.0.1:" + std::to_string(ntohs(addr.sin_port)) + "/";
+
+    {
+        NbRestAsyncEngine engine;
+        for (int i = 0; i < 3; ++i) {
+            engine.Submit(MakeRequest(url), 10, [this](NbResult<NbHttpResponse> result) { OnComplete(result); });
+        }
+    }
+
+    // デストラクタ完了時点で全コールバックが呼ばれている
+    EXPECT_EQ(3, callback_count_);
+    for (auto &result : results_) {
+        EXPECT_EQ(NbResultCode::NB_ERROR_CANCELED, result.GetResultCode());
+    }
+    close(listen_fd);
+}
+
+//NbRestAsyncEngine::~NbRestAsyncEngine(コールバック内で破棄)
+TEST_F(NbRestAsyncEngineTest, DestructInCallback) {
+    LocalHttpServer server;
+    std::unique_ptr<NbRestAsyncEngine> engine(new NbRestAsyncEngine());
+
+    engine->Submit(MakeRequest(server.GetUrl()), 10, [this, &engine](NbResult<NbHttpResponse> result) {
+        engine.reset();
+        OnComplete(result);
+    });
+
+    ASSERT_TRUE(WaitCallback(1));
+    EXPECT_TRUE(results_[0].IsSuccess());
+    EXPECT_EQ(nullptr, engine.get());
+}
+}  // namespace necbaas
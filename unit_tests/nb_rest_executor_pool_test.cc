@@ -1,5 +1,9 @@
 #include "gtest/gtest.h"
 #include "necbaas/internal/nb_rest_executor_pool.h"
+#include <thread>
+#include <chrono>
+#include <set>
+#include <mutex>
 
 namespace necbaas {
 
@@ -57,4 +61,165 @@ TEST(NbRestExecutorPool, NbRestExecutorPoolEmpty) {
     delete executor_pool;
 }
 
+//NbRestExecutorPool 空き待ち(返却により払い出し成功)
+TEST(NbRestExecutorPool, WaitAcquire) {
+    NbRestExecutorPool executor_pool(1);
+    NbRestExecutor *executor = executor_pool.PopRestExecutor();
+    ASSERT_NE(nullptr, executor);
+
+    std::thread pusher([&executor_pool, executor] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        executor_pool.PushRestExecutor(executor);
+    });
+    EXPECT_EQ(executor, executor_pool.PopRestExecutor(5000));
+    pusher.join();
+
+    NbRestExecutorPoolStatistics statistics = executor_pool.GetStatistics();
+    EXPECT_EQ(2, statistics.acquired_count);
+    EXPECT_EQ(1, statistics.waited_count);
+    EXPECT_EQ(0, statistics.failed_count);
+    EXPECT_LE(statistics.max_wait_time_us, statistics.total_wait_time_us);
+    EXPECT_LT(0, statistics.max_wait_time_us);
+
+    executor_pool.PushRestExecutor(executor);
+}
+
+//NbRestExecutorPool 空き待ち(タイムアウト)
+TEST(NbRestExecutorPool, WaitTimeout) {
+    NbRestExecutorPool executor_pool(1);
+    NbRestExecutor *executor = executor_pool.PopRestExecutor();
+    ASSERT_NE(nullptr, executor);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(nullptr, executor_pool.PopRestExecutor(100));
+    EXPECT_LE(100, std::chrono::duration_cast<std::chrono::milliseconds>(
+                       std::chrono::steady_clock::now() - start).count());
+
+    // 待ち時間0以下は待ち合わせしない
+    EXPECT_EQ(nullptr, executor_pool.PopRestExecutor(0));
+
+    NbRestExecutorPoolStatistics statistics = executor_pool.GetStatistics();
+    EXPECT_EQ(1, statistics.acquired_count);
+    EXPECT_EQ(1, statistics.waited_count);
+    EXPECT_EQ(2, statistics.failed_count);
+
+    // タイムアウト後の返却はスタックに戻る
+    executor_pool.PushRestExecutor(executor);
+    EXPECT_EQ(executor, executor_pool.PopRestExecutor());
+    executor_pool.PushRestExecutor(executor);
+}
+
+//NbRestExecutorPool 空きがある場合のみ払い出し
+TEST(NbRestExecutorPool, TryPop) {
+    NbRestExecutorPool executor_pool(1);
+    NbRestExecutor *executor = executor_pool.TryPopRestExecutor();
+    ASSERT_NE(nullptr, executor);
+
+    // 空きが無い場合は待たずにnullptrを返し、失敗回数に計上しない
+    EXPECT_EQ(nullptr, executor_pool.TryPopRestExecutor());
+    NbRestExecutorPoolStatistics statistics = executor_pool.GetStatistics();
+    EXPECT_EQ(1, statistics.acquired_count);
+    EXPECT_EQ(0, statistics.waited_count);
+    EXPECT_EQ(0, statistics.failed_count);
+
+    executor_pool.PushRestExecutor(executor);
+    EXPECT_EQ(executor, executor_pool.TryPopRestExecutor());
+    executor_pool.PushRestExecutor(executor);
+}
+
+//NbRestExecutorPool 空き待ち(到着順)
+TEST(NbRestExecutorPool, WaitFifo) {
+    static const int kWaiterNum = 5;
+    NbRestExecutorPool executor_pool(1);
+    NbRestExecutor *executor = executor_pool.PopRestExecutor();
+    ASSERT_NE(nullptr, executor);
+
+    std::mutex order_mutex;
+    vector<int> order;
+    vector<std::thread> waiters;
+    for (int i = 0; i < kWaiterNum; ++i) {
+        waiters.emplace_back([&executor_pool, &order_mutex, &order, i] {
+            NbRestExecutor *acquired = executor_pool.PopRestExecutor(5000);
+            EXPECT_NE(nullptr, acquired);
+            {
+                std::lock_guard<std::mutex> lock(order_mutex);
+                order.push_back(i);
+            }
+            executor_pool.PushRestExecutor(acquired);
+        });
+        // 到着順を確定させる
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    executor_pool.PushRestExecutor(executor);
+    for (auto &waiter : waiters) {
+        waiter.join();
+    }
+
+    ASSERT_EQ(kWaiterNum, order.size());
+    for (int i = 0; i < kWaiterNum; ++i) {
+        EXPECT_EQ(i, order[i]);
+    }
+}
+
+//NbRestExecutorPool 他スレッドが返却したRestExecutorの払い出し
+TEST(NbRestExecutorPool, PopOtherThread) {
+    NbRestExecutorPool executor_pool(1);
+    NbRestExecutor *executor = nullptr;
+
+    std::thread other([&executor_pool, &executor] {
+        executor = executor_pool.PopRestExecutor();
+        executor_pool.PushRestExecutor(executor);
+    });
+    other.join();
+
+    ASSERT_NE(nullptr, executor);
+    EXPECT_EQ(executor, executor_pool.PopRestExecutor());
+    EXPECT_EQ(nullptr, executor_pool.PopRestExecutor());
+    executor_pool.PushRestExecutor(executor);
+}
+
+//NbRestExecutorPool 多重スレッドからの払い出し・返却
+TEST(NbRestExecutorPool, Concurrent) {
+    static const int kThreadNum = 16;
+    static const int kLoopNum = 1000;
+    static const int kConnectionMax = 4;
+    NbRestExecutorPool executor_pool(kConnectionMax);
+
+    std::mutex mutex;
+    std::set<NbRestExecutor *> used;
+    vector<std::thread> threads;
+    for (int i = 0; i < kThreadNum; ++i) {
+        threads.emplace_back([&executor_pool, &mutex, &used] {
+            for (int j = 0; j < kLoopNum; ++j) {
+                NbRestExecutor *executor = executor_pool.PopRestExecutor(5000);
+                ASSERT_NE(nullptr, executor);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    used.insert(executor);
+                }
+                executor_pool.PushRestExecutor(executor);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_GE(kConnectionMax, used.size());
+    NbRestExecutorPoolStatistics statistics = executor_pool.GetStatistics();
+    EXPECT_EQ(kThreadNum * kLoopNum, statistics.acquired_count);
+    EXPECT_EQ(0, statistics.failed_count);
+
+    // 全て返却済みのため、上限数まで払い出し可能
+    vector<NbRestExecutor *> executors;
+    for (int i = 0; i < kConnectionMax; ++i) {
+        executors.push_back(executor_pool.PopRestExecutor());
+        EXPECT_NE(nullptr, executors.back());
+    }
+    EXPECT_EQ(nullptr, executor_pool.PopRestExecutor());
+    for (auto executor : executors) {
+        executor_pool.PushRestExecutor(executor);
+    }
+}
 } //namespace necbaas
@@ -2,6 +2,10 @@
 #include "necbaas/internal/nb_rest_executor.h"
 #include <curlpp/Options.hpp>
 #include "necbaas/internal/nb_logger.h"
+#include "local_http_server.h"
+#include "necbaas/internal/nb_utility.h"
+#include "test_util.h"
+#include <unistd.h>
 
 namespace necbaas {
 
@@ -537,6 +541,83 @@ TEST(NbRestExecutor, ExecuteFileUploadGet) {
     EXPECT_EQ(NbResultCode::NB_FATAL, result.GetResultCode());
 }
 
+//NbRestExecutor::ExecuteFileUpload(2GB超のファイルをローカルサーバへ送信)
+// 2GB超のデータをループバックで転送するため、通常の実行では無効とする
+TEST(NbRestExecutor, DISABLED_ExecuteFileUploadLarge) {
+    static const int64_t kLargeSize = (2LL << 30) + 20;
+    // データを書込まないスパースファイルで作成する
+    std::ofstream("upload_large.dat");
+    ASSERT_EQ(0, truncate("upload_large.dat", kLargeSize));
+
+    LocalHttpServer server;
+    NbRestExecutor executor;
+    for (auto method : {NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT, NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST}) {
+        NbHttpRequest request(server.GetUrl(), method, kReqHeaders, kEmpty, kEmpty);
+        NbResult<NbHttpResponse> result = executor.ExecuteFileUpload(request, "upload_large.dat");
+        EXPECT_TRUE(result.IsSuccess());
+    }
+
+    ASSERT_EQ(2, server.GetRequestCount());
+    for (const auto &request : server.GetRequests()) {
+        EXPECT_NE(string::npos, request.find("Content-Length: " + std::to_string(kLargeSize) + "\r\n"));
+        // chunked転送を併用しない
+        EXPECT_EQ(string::npos, request.find("Transfer-Encoding"));
+    }
+    for (auto body_size : server.GetRequestBodySizes()) {
+        EXPECT_EQ(kLargeSize, body_size);
+    }
+    std::remove("upload_large.dat");
+}
+
+//NbRestExecutor::ExecuteFileUpload(帯域制限)
+TEST(NbRestExecutor, ExecuteFileUploadBandwidthLimit) {
+    static const int kFileSize = 300 * 1024;
+    std::ofstream("upload_limit.dat") << string(kFileSize, 'a');
+
+    LocalHttpServer server;
+    NbRestExecutor executor;
+    auto limiter = std::make_shared<NbTokenBucket>();
+    limiter->SetRate(200 * 1024);
+    executor.SetBandwidthLimiter(limiter, nullptr);
+    EXPECT_EQ(limiter, executor.GetUploadLimiter());
+    EXPECT_EQ(nullptr, executor.GetDownloadLimiter());
+
+    // 1秒分を超えた100KB分(500ms)待機する
+    NbHttpRequest request(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT, kReqHeaders, kEmpty, kEmpty);
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = executor.ExecuteFileUpload(request, "upload_limit.dat");
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_TRUE(result.IsSuccess());
+    EXPECT_LE(400, elapsed.count());
+    ASSERT_EQ(1, server.GetRequestBodySizes().size());
+    EXPECT_EQ(kFileSize, server.GetRequestBodySizes()[0]);
+    std::remove("upload_limit.dat");
+}
+
+//NbRestExecutor::ExecuteFileDownload(帯域制限)
+TEST(NbRestExecutor, ExecuteFileDownloadBandwidthLimit) {
+    static const int kFileSize = 300 * 1024;
+
+    LocalHttpServer server(kEmpty, "X-Content-Length: " + std::to_string(kFileSize) + "\r\n");
+    server.SetBodySize(kFileSize);
+    NbRestExecutor executor;
+    auto limiter = std::make_shared<NbTokenBucket>();
+    limiter->SetRate(200 * 1024);
+    executor.SetBandwidthLimiter(nullptr, limiter);
+
+    // 1秒分を超えた100KB分(500ms)待機する
+    NbHttpRequest request(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, kReqHeaders, kEmpty, kEmpty);
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = executor.ExecuteFileDownload(request, "download_limit.dat");
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_TRUE(result.IsSuccess());
+    EXPECT_LE(400, elapsed.count());
+    EXPECT_EQ(kFileSize, NbUtility::GetFileSize("download_limit.dat"));
+    std::remove("download_limit.dat");
+}
+
 //NbRestExecutor::ExecuteFileUpload(ファイルオープンエラー)
 TEST(NbRestExecutor, ExecuteFileUploadFileOpenError) {
     NbRestExecutorTest executor;
@@ -724,6 +805,26 @@ TEST_F(NbRestExecutorDownloadTest, ExecuteFileDownload2) {
     CheckCurlOption(executor, request, 10);
 }
 
+//NbRestExecutor::ExecuteFileDownload(書込みバッファサイズ、同期書込み設定)
+TEST_F(NbRestExecutorDownloadTest, ExecuteFileDownloadWriteSettings) {
+    NbRestExecutorTest executor;
+    EXPECT_EQ(kDownloadBufferSize, executor.GetFileDownloadBufferSize());
+    EXPECT_FALSE(executor.IsFileDownloadSync());
+
+    executor.SetFileDownloadBufferSize(8);
+    executor.SetFileDownloadSync(true);
+    EXPECT_EQ(8, executor.GetFileDownloadBufferSize());
+    EXPECT_TRUE(executor.IsFileDownloadSync());
+
+    NbHttpRequest request(kUrl, NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, kReqHeaders, kEmpty, kEmpty);
+
+    NbResult<NbHttpResponse> result = executor.ExecuteFileDownload(request, string("download.dat"));
+
+    EXPECT_TRUE(result.IsSuccess());
+    std::ifstream file_stream("download.dat", std::ios::in | std::ios::binary);
+    EXPECT_EQ(string(kBody), string((std::istreambuf_iterator<char>(file_stream)), std::istreambuf_iterator<char>()));
+}
+
 //NbRestExecutor::ExecuteFileDownload(メソッド不正)
 TEST_F(NbRestExecutorDownloadTest, ExecuteFileDownloadInvalidMethod) {
     NbRestExecutorTest executor;
@@ -914,4 +1015,261 @@ TEST_F(NbRestExecutorDownloadTest, ExecuteFileDownloadException) {
     EXPECT_TRUE(result.IsFatalError());
     EXPECT_EQ(NbResultCode::NB_ERROR_CURL_FATAL, result.GetResultCode());
 }
+//NbRestExecutor 接続再利用モード
+TEST(NbRestExecutor, ConnectionReuse) {
+    LocalHttpServer server;
+    NbRestExecutor executor;
+    EXPECT_FALSE(executor.IsConnectionReuse());
+    executor.SetConnectionReuse(true);
+    EXPECT_TRUE(executor.IsConnectionReuse());
+
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+    NbHttpRequest put(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT,
+                      std::list<string>{"Content-Type: application/json"}, string("{}"), kEmpty);
+    NbHttpRequest del(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_DELETE, std::list<string>(), kEmpty, kEmpty);
+
+    NbResult<NbHttpResponse> result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_FALSE(result.GetSuccessData().IsConnectionReused());
+
+    result = executor.ExecuteRequest(put, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.GetSuccessData().IsConnectionReused());
+
+    result = executor.ExecuteRequest(del, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.GetSuccessData().IsConnectionReused());
+
+    // 前回のメソッド設定が残らないこと
+    result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.GetSuccessData().IsConnectionReused());
+
+    EXPECT_EQ(1, server.GetConnectionCount());
+    vector<string> lines = server.GetRequestLines();
+    ASSERT_EQ(4, lines.size());
+    EXPECT_EQ(0, lines[0].find("GET "));
+    EXPECT_EQ(0, lines[1].find("PUT "));
+    EXPECT_EQ(0, lines[2].find("DELETE "));
+    EXPECT_EQ(0, lines[3].find("GET "));
+}
+
+//NbRestExecutor 接続再利用モード無効(CURLハンドルの接続は再利用される)
+TEST(NbRestExecutor, ConnectionReuseDisabled) {
+    LocalHttpServer server;
+    NbRestExecutor executor;
+
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    NbResult<NbHttpResponse> result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_FALSE(result.GetSuccessData().IsConnectionReused());
+
+    result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.GetSuccessData().IsConnectionReused());
+    EXPECT_EQ(1, server.GetConnectionCount());
+}
+
+//NbRestExecutor HTTP/2モード(平文HTTPではHTTP/1.1で通信する)
+TEST(NbRestExecutor, Http2) {
+    LocalHttpServer server;
+    NbRestExecutor executor;
+    EXPECT_FALSE(executor.IsHttp2());
+    executor.SetHttp2(true);
+    EXPECT_TRUE(executor.IsHttp2());
+
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    NbResult<NbHttpResponse> result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(200, result.GetSuccessData().GetStatusCode());
+
+    // モード切替後も同じハンドルで実行できる
+    executor.SetHttp2(false);
+    EXPECT_FALSE(executor.IsHttp2());
+    result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(200, result.GetSuccessData().GetStatusCode());
+    EXPECT_EQ(2, server.GetRequestCount());
+}
+
+//NbRestExecutor::Connect(確立した接続を再利用する)
+TEST(NbRestExecutor, Connect) {
+    LocalHttpServer server;
+    NbRestExecutor executor;
+
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    NbResult<NbHttpResponse> result = executor.Connect(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.GetSuccessData().GetBody().empty());
+
+    // HEADの設定が残らないこと
+    result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.GetSuccessData().IsConnectionReused());
+    EXPECT_EQ(string("hello"), string(result.GetSuccessData().GetBody().begin(), result.GetSuccessData().GetBody().end()));
+
+    EXPECT_EQ(1, server.GetConnectionCount());
+    vector<string> lines = server.GetRequestLines();
+    ASSERT_EQ(2, lines.size());
+    EXPECT_EQ(0, lines[0].find("HEAD "));
+    EXPECT_EQ(0, lines[1].find("GET "));
+}
+
+//NbRestExecutor::Connect(接続失敗)
+TEST(NbRestExecutor, ConnectError) {
+    NbRestExecutor executor;
+    NbHttpRequest get("http://127.0.0.1:1/", NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    NbResult<NbHttpResponse> result = executor.Connect(get, 10);
+    EXPECT_EQ(NbResultCode::NB_ERROR_CURL_RUNTIME, result.GetResultCode());
+}
+
+//NbRestExecutor 応答圧縮
+TEST(NbRestExecutor, ResponseCompression) {
+    string body;
+    for (int i = 0; i < 100; ++i) {
+        body += R"({"key":"value","number":12345})";
+    }
+    string compressed;
+    ASSERT_TRUE(NbUtility::GzipCompress(body, &compressed));
+    LocalHttpServer server(compressed, "Content-Encoding: gzip\r\n");
+    NbRestExecutor executor;
+    EXPECT_TRUE(executor.IsResponseCompression());
+
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+    NbResult<NbHttpResponse> result = executor.ExecuteRequest(get, 10);
+    ASSERT_TRUE(result.IsSuccess());
+
+    // 展開済みのボディを受信する
+    const NbHttpResponse &response = result.GetSuccessData();
+    EXPECT_EQ(body, string(response.GetBody().begin(), response.GetBody().end()));
+    EXPECT_EQ(body.size(), response.GetResponseBodySize());
+    EXPECT_EQ(compressed.size(), response.GetResponseTransferSize());
+    EXPECT_EQ(0, response.GetRequestBodySize());
+    EXPECT_NE(string::npos, server.GetRequests()[0].find("Accept-Encoding: "));
+
+    // 無効時はAccept-Encodingを送信しない
+    executor.SetResponseCompression(false);
+    EXPECT_FALSE(executor.IsResponseCompression());
+    executor.ExecuteRequest(get, 10);
+    EXPECT_EQ(string::npos, server.GetRequests()[1].find("Accept-Encoding: "));
+
+    // ストリーム受信・送信では有効時も送信しない
+    executor.SetResponseCompression(true);
+    executor.ExecuteStreamRequest(get, [](const char *data, size_t size) { return true; }, 10);
+    EXPECT_EQ(string::npos, server.GetRequests()[2].find("Accept-Encoding: "));
+    NbHttpRequest put(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT, std::list<string>(), kEmpty, kEmpty);
+    executor.ExecuteStreamUpload(put, [](char *buffer, size_t size) -> int64_t { return 0; }, 0, 10);
+    ASSERT_EQ(4, server.GetRequests().size());
+    EXPECT_EQ(string::npos, server.GetRequests()[3].find("Accept-Encoding: "));
+}
+
+//NbRestExecutor リクエスト圧縮
+TEST(NbRestExecutor, RequestCompression) {
+    LocalHttpServer server;
+    NbRestExecutor executor;
+    EXPECT_EQ(0, executor.GetRequestCompressionThreshold());
+    executor.SetRequestCompressionThreshold(100);
+    EXPECT_EQ(100, executor.GetRequestCompressionThreshold());
+
+    string body = R"({"data":")" + string(200, 'a') + R"("})";
+    std::list<string> json_headers{"Content-Type: application/json"};
+
+    // 圧縮対象に設定した閾値以上のボディは圧縮する
+    NbHttpRequest put(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT, json_headers, body, kEmpty);
+    put.SetBodyCompressible(true);
+    NbResult<NbHttpResponse> result = executor.ExecuteRequest(put, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(body.size(), result.GetSuccessData().GetRequestBodySize());
+    EXPECT_GT(body.size(), result.GetSuccessData().GetRequestTransferSize());
+
+    string request = server.GetRequests()[0];
+    size_t header_end = request.find("\r\n\r\n");
+    EXPECT_NE(string::npos, request.find("Content-Encoding: gzip"));
+    EXPECT_EQ(body, TestUtil::GzipDecompress(request.substr(header_end + 4)));
+
+    // 閾値未満
+    NbHttpRequest post(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST, json_headers, string("{}"), kEmpty);
+    post.SetBodyCompressible(true);
+    result = executor.ExecuteRequest(post, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(2, result.GetSuccessData().GetRequestTransferSize());
+    EXPECT_EQ(string::npos, server.GetRequests()[1].find("Content-Encoding"));
+
+    // 圧縮対象に設定していないリクエストは、JSONボディでも圧縮しない
+    NbHttpRequest json(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_POST, json_headers, body, kEmpty);
+    result = executor.ExecuteRequest(json, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(body.size(), result.GetSuccessData().GetRequestTransferSize());
+    EXPECT_EQ(string::npos, server.GetRequests()[2].find("Content-Encoding"));
+}
+
+//NbRestExecutor::Cancel
+TEST(NbRestExecutor, Cancel) {
+    LocalHttpServer server;
+    server.SetResponseDelays({3000});
+    NbRestExecutor executor;
+
+    NbHttpRequest get(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(), kEmpty, kEmpty);
+
+    // 転送中の中断
+    std::thread cancel_thread([&executor] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        executor.Cancel();
+    });
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = executor.ExecuteRequest(get, 10);
+    cancel_thread.join();
+    EXPECT_EQ(NbResultCode::NB_ERROR_CANCELED, result.GetResultCode());
+    EXPECT_GT(std::chrono::seconds(3), std::chrono::steady_clock::now() - start);
+
+    // 解除するまでは次の転送も中断する
+    result = executor.ExecuteRequest(get, 10);
+    EXPECT_EQ(NbResultCode::NB_ERROR_CANCELED, result.GetResultCode());
+
+    executor.ClearCancel();
+    result = executor.ExecuteRequest(get, 10);
+    EXPECT_TRUE(result.IsSuccess());
+}
+
+//NbRestExecutor 転送情報
+TEST(NbRestExecutor, TransferInfo) {
+    LocalHttpServer server;
+    server.SetStatusCodes({200, 503});
+    NbRestExecutor executor;
+
+    NbHttpRequest put(server.GetUrl(), NbHttpRequestMethod::HTTP_REQUEST_TYPE_PUT, std::list<string>(),
+                      string("12345"), kEmpty);
+    NbResult<NbHttpResponse> result = executor.ExecuteRequest(put, 10);
+    ASSERT_TRUE(result.IsSuccess());
+
+    // 各フェーズは開始からの経過時間のため、順に増加する
+    const NbTransferInfo &info = result.GetTransferInfo();
+    EXPECT_LE(info.name_lookup_time_us, info.connect_time_us);
+    EXPECT_LE(info.connect_time_us, info.pre_transfer_time_us);
+    EXPECT_LE(info.pre_transfer_time_us, info.start_transfer_time_us);
+    EXPECT_LE(info.start_transfer_time_us, info.total_time_us);
+    EXPECT_LT(0, info.total_time_us);
+    EXPECT_EQ(0, info.app_connect_time_us);
+    EXPECT_LT(0, info.request_size);
+    EXPECT_LT(0, info.response_header_size);
+    EXPECT_EQ(5, info.upload_size);
+    EXPECT_EQ(5, info.download_size);
+    EXPECT_EQ(info.total_time_us, result.GetSuccessData().GetTransferInfo().total_time_us);
+
+    // エラー時も設定する
+    result = executor.ExecuteRequest(put, 10);
+    ASSERT_TRUE(result.IsRestError());
+    EXPECT_LT(0, result.GetTransferInfo().total_time_us);
+    EXPECT_EQ(5, result.GetTransferInfo().download_size);
+
+    NbHttpRequest refused("http://127.0.0.1:1/", NbHttpRequestMethod::HTTP_REQUEST_TYPE_GET, std::list<string>(),
+                          kEmpty, kEmpty);
+    result = executor.ExecuteRequest(refused, 10);
+    EXPECT_EQ(NbResultCode::NB_ERROR_CURL_RUNTIME, result.GetResultCode());
+    EXPECT_EQ(0, result.GetTransferInfo().download_size);
+}
 } //namespace necbaas
@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "necbaas/nb_service.h"
 #include "test_util.h"
+#include "local_http_server.h"
+#include <future>
 
 namespace necbaas {
 
@@ -88,6 +90,594 @@ TEST(NbService, Executor) {
     EXPECT_EQ(executor, executor2);
 }
 
+//NbService(ConnectionWaitTimeout)
+TEST(NbService, ConnectionWaitTimeout) {
+    shared_ptr<NbServiceTest> service(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    EXPECT_EQ(0, service->GetConnectionWaitTimeout());
+
+    service->SetConnectionWaitTimeout(500);
+    EXPECT_EQ(500, service->GetConnectionWaitTimeout());
+
+    // 0以下は待ち合わせなし
+    service->SetConnectionWaitTimeout(-1);
+    EXPECT_EQ(0, service->GetConnectionWaitTimeout());
+
+    NbRestExecutor *executor = service->PopRestExecutorTest();
+    service->PushRestExecutorTest(executor);
+    EXPECT_EQ(1, service->GetConnectionPoolStatistics().acquired_count);
+}
+
+//NbService(ConnectionReuse)
+TEST(NbService, ConnectionReuse) {
+    shared_ptr<NbServiceTest> service(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    EXPECT_FALSE(service->IsConnectionReuseEnabled());
+
+    // 払い出し時にExecutorへ反映される
+    service->SetConnectionReuseEnabled(true);
+    EXPECT_TRUE(service->IsConnectionReuseEnabled());
+    NbRestExecutor *executor = service->PopRestExecutorTest();
+    EXPECT_TRUE(executor->IsConnectionReuse());
+    service->PushRestExecutorTest(executor);
+
+    service->SetConnectionReuseEnabled(false);
+    executor = service->PopRestExecutorTest();
+    EXPECT_FALSE(executor->IsConnectionReuse());
+    service->PushRestExecutorTest(executor);
+}
+
+//NbService(Http2)
+TEST(NbService, Http2) {
+    shared_ptr<NbServiceTest> service(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    EXPECT_FALSE(service->IsHttp2Enabled());
+
+    // 払い出し時にExecutorへ反映される
+    service->SetHttp2Enabled(true);
+    EXPECT_TRUE(service->IsHttp2Enabled());
+    NbRestExecutor *executor = service->PopRestExecutorTest();
+    EXPECT_TRUE(executor->IsHttp2());
+    service->PushRestExecutorTest(executor);
+
+    service->SetHttp2Enabled(false);
+    executor = service->PopRestExecutorTest();
+    EXPECT_FALSE(executor->IsHttp2());
+    service->PushRestExecutorTest(executor);
+}
+
+//NbService(Compression)
+TEST(NbService, Compression) {
+    shared_ptr<NbServiceTest> service(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    EXPECT_TRUE(service->IsResponseCompressionEnabled());
+    EXPECT_EQ(0, service->GetRequestCompressionThreshold());
+
+    // 払い出し時にExecutorへ反映される
+    service->SetResponseCompressionEnabled(false);
+    service->SetRequestCompressionThreshold(1024);
+    EXPECT_FALSE(service->IsResponseCompressionEnabled());
+    EXPECT_EQ(1024, service->GetRequestCompressionThreshold());
+    NbRestExecutor *executor = service->PopRestExecutorTest();
+    EXPECT_FALSE(executor->IsResponseCompression());
+    EXPECT_EQ(1024, executor->GetRequestCompressionThreshold());
+    service->PushRestExecutorTest(executor);
+
+    // 負値は無効
+    service->SetRequestCompressionThreshold(-1);
+    EXPECT_EQ(0, service->GetRequestCompressionThreshold());
+}
+
+//NbService(FileDownloadWriteSettings)
+TEST(NbService, FileDownloadWriteSettings) {
+    shared_ptr<NbServiceTest> service(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    EXPECT_EQ(kDownloadBufferSize, service->GetFileDownloadBufferSize());
+    EXPECT_FALSE(service->IsFileDownloadSyncEnabled());
+
+    // 払い出し時にExecutorへ反映される
+    service->SetFileDownloadBufferSize(4096);
+    service->SetFileDownloadSyncEnabled(true);
+    EXPECT_EQ(4096, service->GetFileDownloadBufferSize());
+    EXPECT_TRUE(service->IsFileDownloadSyncEnabled());
+    NbRestExecutor *executor = service->PopRestExecutorTest();
+    EXPECT_EQ(4096, executor->GetFileDownloadBufferSize());
+    EXPECT_TRUE(executor->IsFileDownloadSync());
+    service->PushRestExecutorTest(executor);
+
+    // 負値はバッファリングなし
+    service->SetFileDownloadBufferSize(-1);
+    EXPECT_EQ(0, service->GetFileDownloadBufferSize());
+}
+
+//NbService(BandwidthLimit)
+TEST(NbService, BandwidthLimit) {
+    shared_ptr<NbServiceTest> service(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    EXPECT_EQ(0, service->GetUploadBandwidthLimit());
+    EXPECT_EQ(0, service->GetDownloadBandwidthLimit());
+
+    service->SetUploadBandwidthLimit(1000);
+    service->SetDownloadBandwidthLimit(2000);
+    EXPECT_EQ(1000, service->GetUploadBandwidthLimit());
+    EXPECT_EQ(2000, service->GetDownloadBandwidthLimit());
+
+    // Executorはサービスの帯域制限を共有し、変更が即時に反映される
+    NbRestExecutor *executor = service->PopRestExecutorTest();
+    ASSERT_NE(nullptr, executor->GetUploadLimiter());
+    ASSERT_NE(nullptr, executor->GetDownloadLimiter());
+    EXPECT_EQ(1000, executor->GetUploadLimiter()->GetRate());
+    service->SetDownloadBandwidthLimit(3000);
+    EXPECT_EQ(3000, executor->GetDownloadLimiter()->GetRate());
+    service->PushRestExecutorTest(executor);
+
+    // 負値は制限なし
+    service->SetUploadBandwidthLimit(-1);
+    service->SetDownloadBandwidthLimit(-1);
+    EXPECT_EQ(0, service->GetUploadBandwidthLimit());
+    EXPECT_EQ(0, service->GetDownloadBandwidthLimit());
+}
+
+//NbService(BandwidthLimit、非同期実行エンジン)
+TEST(NbService, BandwidthLimitHttp2) {
+    static const int kBodySize = 250 * 1024;
+    LocalHttpServer server;
+    server.SetBodySize(kBodySize);
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    service->SetHttp2Enabled(true);
+    service->SetDownloadBandwidthLimit(100 * 1024);
+
+    // 1秒分を超えた150KB分(1.5秒)は、イベントループで待機せずに転送を一時停止して待ち合わせる
+    auto start = std::chrono::steady_clock::now();
+    std::future<NbResult<NbHttpResponse>> large_result = std::async(std::launch::async, [&service] {
+        return service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+            return factory.Get("/path").Build();
+        }, 10);
+    });
+
+    // 制限中もイベントループは停止せず、他の転送を実行できる
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto small_start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> small_result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").AppendHeader("Range", "bytes=0-9").Build();
+    }, 10);
+    auto small_elapsed =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - small_start);
+
+    NbResult<NbHttpResponse> result = large_result.get();
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(kBodySize, result.GetSuccessData().GetBody().size());
+    EXPECT_LE(1000, elapsed.count());
+    ASSERT_TRUE(small_result.IsSuccess());
+    EXPECT_EQ(10, small_result.GetSuccessData().GetBody().size());
+    EXPECT_GT(500, small_elapsed.count());
+    EXPECT_EQ(2, server.GetRequestCount());
+}
+
+//NbService(RequestRateLimit)
+TEST(NbService, RequestRateLimit) {
+    LocalHttpServer server;
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    EXPECT_EQ(0, service->GetRequestRateLimit());
+    service->SetRequestRateLimit(20);
+    EXPECT_EQ(20, service->GetRequestRateLimit());
+
+    // 1秒分(20回)を超えた10回分(500ms)待機する
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 30; ++i) {
+        NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+            return factory.Get("/path").Build();
+        }, 10);
+        EXPECT_TRUE(result.IsSuccess());
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    EXPECT_LE(400, elapsed.count());
+    EXPECT_EQ(30, server.GetRequestCount());
+
+    // 負値は制限なし
+    service->SetRequestRateLimit(-1);
+    EXPECT_EQ(0, service->GetRequestRateLimit());
+}
+
+//NbService(ProcessCacheShare)
+TEST(NbService, ProcessCacheShare) {
+    shared_ptr<NbServiceTest> service1(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    shared_ptr<NbServiceTest> service2(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
+    EXPECT_FALSE(service1->IsProcessCacheShareEnabled());
+
+    // サービス内のExecutorは共有キャッシュを使用する
+    NbRestExecutor *executor1 = service1->PopRestExecutorTest();
+    NbRestExecutor *executor2 = service2->PopRestExecutorTest();
+    ASSERT_NE(nullptr, executor1->GetCurlShare());
+    EXPECT_NE(executor1->GetCurlShare(), executor2->GetCurlShare());
+    service1->PushRestExecutorTest(executor1);
+    service2->PushRestExecutorTest(executor2);
+
+    // 有効にしたサービス間で共有する
+    service1->SetProcessCacheShareEnabled(true);
+    service2->SetProcessCacheShareEnabled(true);
+    EXPECT_TRUE(service1->IsProcessCacheShareEnabled());
+    executor1 = service1->PopRestExecutorTest();
+    executor2 = service2->PopRestExecutorTest();
+    EXPECT_EQ(executor1->GetCurlShare(), executor2->GetCurlShare());
+    service1->PushRestExecutorTest(executor1);
+    service2->PushRestExecutorTest(executor2);
+
+    service1->SetProcessCacheShareEnabled(false);
+    executor1 = service1->PopRestExecutorTest();
+    executor2 = service2->PopRestExecutorTest();
+    EXPECT_NE(executor1->GetCurlShare(), executor2->GetCurlShare());
+    service1->PushRestExecutorTest(executor1);
+    service2->PushRestExecutorTest(executor2);
+}
+
+//NbService::ExecuteRequest(HTTP/2モード、非同期実行エンジンで多重実行)
+TEST(NbService, ExecuteRequestHttp2) {
+    static const int kThreadNum = 8;
+    LocalHttpServer server;
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    service->SetHttp2Enabled(true);
+
+    vector<NbResult<NbHttpResponse>> results(kThreadNum);
+    vector<std::thread> threads;
+    for (int i = 0; i < kThreadNum; ++i) {
+        threads.emplace_back([&service, &results, i] {
+            results[i] = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+                return factory.Get("/path").Build();
+            }, 10);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    for (auto &result : results) {
+        ASSERT_TRUE(result.IsSuccess());
+        EXPECT_EQ(200, result.GetSuccessData().GetStatusCode());
+    }
+    // 接続プールは使用しない
+    EXPECT_EQ(0, service->GetConnectionPoolStatistics().acquired_count);
+    EXPECT_EQ(kThreadNum, server.GetRequestCount());
+}
+
+//NbService(RetryPolicy)
+TEST(NbService, RetryPolicy) {
+    shared_ptr<NbService> service = NbService::CreateService(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy);
+    NbRetryPolicy policy = service->GetRetryPolicy();
+    EXPECT_EQ(1, policy.max_attempts);
+    EXPECT_FALSE(policy.retry_post);
+
+    policy.max_attempts = 3;
+    policy.deadline_ms = 1000;
+    policy.retry_post = true;
+    service->SetRetryPolicy(policy);
+    policy = service->GetRetryPolicy();
+    EXPECT_EQ(3, policy.max_attempts);
+    EXPECT_EQ(1000, policy.deadline_ms);
+    EXPECT_TRUE(policy.retry_post);
+}
+
+//NbService::ExecuteRequest(リトライ)
+TEST(NbService, ExecuteRequestRetry) {
+    LocalHttpServer server;
+    server.SetStatusCodes({503, 502, 504, 503});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    NbRetryPolicy policy;
+    policy.max_attempts = 3;
+    policy.initial_backoff_ms = 10;
+    service->SetRetryPolicy(policy);
+
+    // 最大試行回数まで実行し、最後の結果を返す
+    NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Build();
+    }, 10);
+    ASSERT_TRUE(result.IsRestError());
+    EXPECT_EQ(504, result.GetRestError().status_code);
+    EXPECT_EQ(2, result.GetRetryCount());
+    EXPECT_EQ(3, server.GetRequestCount());
+
+    // 成功した時点で終了する
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Put("/path").Build();
+    }, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(1, result.GetRetryCount());
+    EXPECT_EQ(5, server.GetRequestCount());
+}
+
+//NbService::ExecuteRequest(リトライ対象外)
+TEST(NbService, ExecuteRequestRetryNotTarget) {
+    LocalHttpServer server;
+    server.SetStatusCodes({503, 500, 503});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    NbRetryPolicy policy;
+    policy.max_attempts = 3;
+    policy.initial_backoff_ms = 10;
+    service->SetRetryPolicy(policy);
+
+    // POSTはリトライしない
+    NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Post("/path").Build();
+    }, 10);
+    EXPECT_EQ(503, result.GetRestError().status_code);
+    EXPECT_EQ(0, result.GetRetryCount());
+
+    // 500はリトライしない
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Build();
+    }, 10);
+    EXPECT_EQ(500, result.GetRestError().status_code);
+    EXPECT_EQ(0, result.GetRetryCount());
+
+    // 期限内に次のリトライを開始できない場合はリトライしない
+    policy.initial_backoff_ms = 1000;
+    policy.deadline_ms = 100;
+    service->SetRetryPolicy(policy);
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Delete("/path").Build();
+    }, 10);
+    EXPECT_EQ(503, result.GetRestError().status_code);
+    EXPECT_EQ(0, result.GetRetryCount());
+    EXPECT_EQ(3, server.GetRequestCount());
+}
+
+//NbService::ExecuteRequest(リトライ、通信エラー)
+TEST(NbService, ExecuteRequestRetryCurlError) {
+    shared_ptr<NbService> service = NbService::CreateService("http://127.0.0.1:1/api", kTenantId, kAppId, kAppKey, string());
+    NbRetryPolicy policy;
+    policy.max_attempts = 2;
+    policy.initial_backoff_ms = 10;
+    policy.retry_post = true;
+    service->SetRetryPolicy(policy);
+
+    NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Post("/path").Build();
+    }, 10);
+    EXPECT_EQ(NbResultCode::NB_ERROR_CURL_RUNTIME, result.GetResultCode());
+    EXPECT_EQ(1, result.GetRetryCount());
+}
+
+//NbService::ExecuteRequest(サーキットブレーカー)
+TEST(NbService, ExecuteRequestCircuitBreaker) {
+    LocalHttpServer server;
+    server.SetStatusCodes({503, 500});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    EXPECT_FALSE(service->GetCircuitBreakerPolicy().enabled);
+
+    NbCircuitBreakerPolicy policy;
+    policy.enabled = true;
+    policy.minimum_calls = 2;
+    policy.open_duration_ms = 50;
+    policy.half_open_calls = 1;
+    service->SetCircuitBreakerPolicy(policy);
+    EXPECT_TRUE(service->GetCircuitBreakerPolicy().enabled);
+    EXPECT_EQ(NbCircuitBreakerState::CLOSED, service->GetCircuitBreakerState());
+
+    auto create_request = [](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Build();
+    };
+    EXPECT_TRUE(service->ExecuteRequest(create_request, 10).IsRestError());
+    EXPECT_TRUE(service->ExecuteRequest(create_request, 10).IsRestError());
+    EXPECT_EQ(NbCircuitBreakerState::OPEN, service->GetCircuitBreakerState());
+
+    // 遮断中はREST APIを実行しない
+    EXPECT_EQ(NbResultCode::NB_ERROR_CIRCUIT_OPEN, service->ExecuteRequest(create_request, 10).GetResultCode());
+    EXPECT_EQ(2, server.GetRequestCount());
+    EXPECT_EQ(2, service->GetConnectionPoolStatistics().acquired_count);
+
+    // 遮断時間経過後、試行が成功すれば通常状態に戻る
+    std::this_thread::sleep_for(std::chrono::milliseconds(60));
+    EXPECT_EQ(NbCircuitBreakerState::HALF_OPEN, service->GetCircuitBreakerState());
+    EXPECT_TRUE(service->ExecuteRequest(create_request, 10).IsSuccess());
+    EXPECT_EQ(NbCircuitBreakerState::CLOSED, service->GetCircuitBreakerState());
+}
+
+//NbService::ExecuteRequest(ヘッジリクエスト)
+TEST(NbService, ExecuteRequestHedge) {
+    LocalHttpServer server;
+    server.SetResponseDelays({3000});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    EXPECT_FALSE(service->GetHedgePolicy().enabled);
+
+    NbHedgePolicy policy;
+    policy.enabled = true;
+    policy.default_delay_ms = 50;
+    service->SetHedgePolicy(policy);
+    EXPECT_TRUE(service->GetHedgePolicy().enabled);
+
+    // 待ち時間内に完了しない場合は重複して送信し、先に完了した応答を採用する
+    auto start = std::chrono::steady_clock::now();
+    NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Hedgeable().Build();
+    }, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_GT(std::chrono::seconds(3), std::chrono::steady_clock::now() - start);
+    EXPECT_EQ(2, server.GetRequestCount());
+
+    // 待ち時間内に完了した場合は送信しない
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Hedgeable().Build();
+    }, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(3, server.GetRequestCount());
+
+    // GET以外は対象外
+    server.SetResponseDelays({0, 0, 0, 200});
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Put("/path").Hedgeable().Build();
+    }, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(4, server.GetRequestCount());
+
+    // 対象に設定していないGETは対象外
+    server.SetResponseDelays({0, 0, 0, 0, 200});
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Build();
+    }, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(5, server.GetRequestCount());
+}
+
+//NbService::ExecuteRequest(ヘッジリクエスト、先に完了した転送がエラー)
+TEST(NbService, ExecuteRequestHedgeFailure) {
+    LocalHttpServer server;
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    NbHedgePolicy policy;
+    policy.enabled = true;
+    policy.default_delay_ms = 50;
+    service->SetHedgePolicy(policy);
+    NbRetryPolicy retry_policy;
+    retry_policy.max_attempts = 1;
+    service->SetRetryPolicy(retry_policy);
+
+    // リトライ可能なエラーは採用せず、重複送信した転送の成功を待つ
+    server.SetStatusCodes({503, 200});
+    server.SetResponseDelays({100, 300});
+    NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Hedgeable().Build();
+    }, 10);
+    EXPECT_TRUE(result.IsSuccess());
+    EXPECT_EQ(2, server.GetRequestCount());
+
+    // 待ち時間内にエラーで完了した場合は、待たずに重複送信する
+    server.SetStatusCodes({200, 200, 503, 200});
+    server.SetResponseDelays({0, 0, 0, 0});
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Hedgeable().Build();
+    }, 10);
+    EXPECT_TRUE(result.IsSuccess());
+    EXPECT_EQ(4, server.GetRequestCount());
+
+    // 全てエラーの場合はエラーを返す
+    server.SetStatusCodes({200, 200, 200, 200, 503, 502});
+    server.SetResponseDelays({0, 0, 0, 0, 100, 100});
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Hedgeable().Build();
+    }, 10);
+    ASSERT_TRUE(result.IsRestError());
+    EXPECT_EQ(6, server.GetRequestCount());
+
+    // リトライ不可のエラーは採用する
+    server.SetStatusCodes({200, 200, 200, 200, 200, 200, 404});
+    server.SetResponseDelays({0, 0, 0, 0, 0, 0, 100, 3000});
+    auto start = std::chrono::steady_clock::now();
+    result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Hedgeable().Build();
+    }, 10);
+    ASSERT_TRUE(result.IsRestError());
+    EXPECT_EQ(404, result.GetRestError().status_code);
+    EXPECT_GT(std::chrono::seconds(3), std::chrono::steady_clock::now() - start);
+}
+
+//NbService::ExecuteRequest(ヘッジリクエスト、空き接続無し)
+TEST(NbService, ExecuteRequestHedgeConnectionOver) {
+    LocalHttpServer server;
+    server.SetResponseDelays({200});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+    NbHedgePolicy policy;
+    policy.enabled = true;
+    policy.default_delay_ms = 50;
+    service->SetHedgePolicy(policy);
+
+    // 最後の1接続で実行し、空きが無いため重複送信しない(接続数オーバーのエラーとして計上しない)
+    std::vector<NbRestExecutor *> executors = service->ReserveRestExecutors(19);
+    ASSERT_EQ(19, executors.size());
+    NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Hedgeable().Build();
+    }, 10);
+    service->ReleaseRestExecutors(executors);
+
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_EQ(1, server.GetRequestCount());
+    EXPECT_EQ(0, service->GetStatistics().connection_pool.failed_count);
+}
+
+//NbService::GetStatistics
+TEST(NbService, GetStatistics) {
+    LocalHttpServer server("{}");
+    server.SetStatusCodes({200, 200, 404});
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+            return factory.Get("/path").Build();
+        }, 10, NbOperation::OBJECT_QUERY).IsSuccess());
+    }
+    ASSERT_TRUE(service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Delete("/path").Build();
+    }, 10).IsRestError());
+
+    NbStatistics statistics = service->GetStatistics();
+    ASSERT_EQ(2, statistics.operations.size());
+    const NbOperationStatistics &query = statistics.operations[NbOperation::OBJECT_QUERY];
+    EXPECT_EQ(2, query.request_count);
+    EXPECT_EQ(0, query.error_count);
+    EXPECT_EQ(2, query.latency.GetCount());
+    EXPECT_LT(0, query.latency.GetMax());
+    EXPECT_LT(0, query.bytes_sent);
+    EXPECT_LT(0, query.bytes_received);
+
+    const NbOperationStatistics &other = statistics.operations[NbOperation::OTHER];
+    EXPECT_EQ(1, other.request_count);
+    EXPECT_EQ(1, other.result_counts.at(NbResultCode::NB_ERROR_RESPONSE));
+    EXPECT_EQ(3, statistics.connection_pool.acquired_count);
+
+    service->ResetStatistics();
+    EXPECT_TRUE(service->GetStatistics().operations.empty());
+}
+
+//NbService::WarmUp
+TEST(NbService, WarmUp) {
+    LocalHttpServer server;
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+
+    NbWarmUpResult warm_up_result = service->WarmUp(3);
+    EXPECT_EQ(3, warm_up_result.connected_count);
+    EXPECT_EQ(0, warm_up_result.failed_count);
+    EXPECT_LE(0, warm_up_result.elapsed_time_ms);
+    EXPECT_EQ(3, server.GetConnectionCount());
+
+    // 確立済みの接続を使用する
+    NbResult<NbHttpResponse> result = service->ExecuteRequest([](NbHttpRequestFactory &factory) {
+        return factory.Get("/path").Build();
+    }, 10);
+    ASSERT_TRUE(result.IsSuccess());
+    EXPECT_TRUE(result.GetSuccessData().IsConnectionReused());
+    EXPECT_EQ(3, server.GetConnectionCount());
+}
+
+//NbService::WarmUp(接続失敗、HTTP同時接続数最大値超過)
+TEST(NbService, WarmUpError) {
+    shared_ptr<NbService> service = NbService::CreateService("http://127.0.0.1:1", kTenantId, kAppId, kAppKey, string());
+
+    NbWarmUpResult warm_up_result = service->WarmUp(30);
+    EXPECT_EQ(0, warm_up_result.connected_count);
+    EXPECT_EQ(20, warm_up_result.failed_count);
+}
+
+//NbService::WarmUpAsync
+TEST(NbService, WarmUpAsync) {
+    LocalHttpServer server;
+    shared_ptr<NbService> service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string());
+
+    std::promise<NbWarmUpResult> promise;
+    service->WarmUpAsync(2, [&promise](const NbWarmUpResult &warm_up_result) {
+        promise.set_value(warm_up_result);
+    });
+    std::future<NbWarmUpResult> future = promise.get_future();
+    ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(10)));
+    EXPECT_EQ(2, future.get().connected_count);
+    EXPECT_EQ(2, server.GetConnectionCount());
+}
+
+//NbService::CreateService(事前接続あり)
+TEST(NbService, CreateServiceWarmUp) {
+    LocalHttpServer server;
+    shared_ptr<NbService> service =
+        NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string(), 2, false);
+    EXPECT_EQ(2, server.GetConnectionCount());
+
+    // バックグラウンド実行はサービス破棄時に完了を待ち合わせる
+    service = NbService::CreateService(server.GetUrl("/api"), kTenantId, kAppId, kAppKey, string(), 2, true);
+    service.reset();
+    EXPECT_EQ(4, server.GetRequestCount());
+}
+
 //NbService(HttpRequestFactory)
 TEST(NbService, HttpRequestFactory) {
     shared_ptr<NbServiceTest> service(new NbServiceTest(kEndPointUrl, kTenantId, kAppId, kAppKey, kProxy));
@@ -0,0 +1,69 @@
+#include "gtest/gtest.h"
+#include "necbaas/nb_statistics.h"
+
+namespace necbaas {
+
+using std::vector;
+
+//NbLatencyHistogram::GetBucketIndex, GetBucketUpperBound
+TEST(NbLatencyHistogram, Bucket) {
+    // 32us未満は1us単位
+    EXPECT_EQ(0, NbLatencyHistogram::GetBucketIndex(-1));
+    EXPECT_EQ(0, NbLatencyHistogram::GetBucketIndex(0));
+    EXPECT_EQ(31, NbLatencyHistogram::GetBucketIndex(31));
+    EXPECT_EQ(31, NbLatencyHistogram::GetBucketUpperBound(31));
+
+    // 32us以上は2のべき乗毎に16分割
+    EXPECT_EQ(32, NbLatencyHistogram::GetBucketIndex(32));
+    EXPECT_EQ(32, NbLatencyHistogram::GetBucketIndex(33));
+    EXPECT_EQ(33, NbLatencyHistogram::GetBucketIndex(34));
+    EXPECT_EQ(33, NbLatencyHistogram::GetBucketUpperBound(32));
+
+    // 区間の上限値は次の区間の下限値-1、相対誤差は6.25%以下
+    for (int i = 0; i < NbLatencyHistogram::kBucketNum - 1; ++i) {
+        int64_t upper = NbLatencyHistogram::GetBucketUpperBound(i);
+        EXPECT_EQ(i, NbLatencyHistogram::GetBucketIndex(upper));
+        EXPECT_EQ(i + 1, NbLatencyHistogram::GetBucketIndex(upper + 1));
+        int64_t lower = (i == 0) ? 0 : NbLatencyHistogram::GetBucketUpperBound(i - 1) + 1;
+        EXPECT_LE(upper - lower, lower / 16);
+    }
+
+    // 上限を超える値は最終区間
+    EXPECT_EQ(NbLatencyHistogram::kBucketNum - 1, NbLatencyHistogram::GetBucketIndex(INT64_MAX));
+}
+
+//NbLatencyHistogram::Set, GetPercentile
+TEST(NbLatencyHistogram, GetPercentile) {
+    NbLatencyHistogram histogram;
+    EXPECT_EQ(0, histogram.GetCount());
+    EXPECT_EQ(0, histogram.GetPercentile(50));
+    EXPECT_EQ(0, histogram.GetMean());
+    EXPECT_TRUE(histogram.GetBuckets().empty());
+
+    // 10us x 90件、1000us x 9件、100000us x 1件
+    vector<uint64_t> counts(NbLatencyHistogram::kBucketNum, 0);
+    counts[NbLatencyHistogram::GetBucketIndex(10)] = 90;
+    counts[NbLatencyHistogram::GetBucketIndex(1000)] = 9;
+    counts[NbLatencyHistogram::GetBucketIndex(100000)] = 1;
+    histogram.Set(counts, 10 * 90 + 1000 * 9 + 100000, 10, 100000);
+
+    EXPECT_EQ(100, histogram.GetCount());
+    EXPECT_EQ(10, histogram.GetMin());
+    EXPECT_EQ(100000, histogram.GetMax());
+    EXPECT_DOUBLE_EQ(1099.0, histogram.GetMean());
+
+    EXPECT_EQ(10, histogram.GetPercentile(0));
+    EXPECT_EQ(10, histogram.GetPercentile(50));
+    EXPECT_EQ(10, histogram.GetPercentile(90));
+    EXPECT_EQ(NbLatencyHistogram::GetBucketUpperBound(NbLatencyHistogram::GetBucketIndex(1000)),
+              histogram.GetPercentile(95));
+    // 最大値を超えない
+    EXPECT_EQ(100000, histogram.GetPercentile(100));
+
+    vector<std::pair<int64_t, uint64_t>> buckets = histogram.GetBuckets();
+    ASSERT_EQ(3, buckets.size());
+    EXPECT_EQ(10, buckets[0].first);
+    EXPECT_EQ(90, buckets[0].second);
+    EXPECT_EQ(1, buckets[2].second);
+}
+} //namespace necbaas
@@ -0,0 +1,109 @@
+#include "gtest/gtest.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "necbaas/internal/nb_token_bucket.h"
+
+namespace necbaas {
+
+using std::chrono::steady_clock;
+using std::chrono::milliseconds;
+using std::chrono::duration_cast;
+
+static int64_t ElapsedMs(steady_clock::time_point start) {
+    return duration_cast<milliseconds>(steady_clock::now() - start).count();
+}
+
+//NbTokenBucket::Acquire(制限なし)
+TEST(NbTokenBucket, AcquireUnlimited) {
+    NbTokenBucket bucket;
+    EXPECT_FALSE(bucket.IsLimited());
+    EXPECT_EQ(0, bucket.GetRate());
+
+    auto start = steady_clock::now();
+    bucket.Acquire(1000000000);
+    EXPECT_GT(100, ElapsedMs(start));
+}
+
+//NbTokenBucket::Acquire(蓄積分を超えた場合は待機)
+TEST(NbTokenBucket, Acquire) {
+    NbTokenBucket bucket;
+    bucket.SetRate(1000);
+    EXPECT_TRUE(bucket.IsLimited());
+    EXPECT_EQ(1000, bucket.GetRate());
+
+    // 1秒分は待機しない
+    auto start = steady_clock::now();
+    bucket.Acquire(1000);
+    EXPECT_GT(100, ElapsedMs(start));
+
+    // 不足分(300ms)の補充を待つ
+    start = steady_clock::now();
+    bucket.Acquire(300);
+    int64_t elapsed = ElapsedMs(start);
+    EXPECT_LE(250, elapsed);
+    EXPECT_GT(1000, elapsed);
+}
+
+//NbTokenBucket::Acquire(複数スレッドの不足分を合算して待機)
+TEST(NbTokenBucket, AcquireMultiThread) {
+    NbTokenBucket bucket;
+    bucket.SetRate(100);
+    bucket.Acquire(100);
+
+    auto start = steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&bucket] { bucket.Acquire(10); });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    // 40トークン分(400ms)
+    int64_t elapsed = ElapsedMs(start);
+    EXPECT_LE(350, elapsed);
+    EXPECT_GT(1500, elapsed);
+}
+
+//NbTokenBucket::SetRate
+TEST(NbTokenBucket, SetRate) {
+    NbTokenBucket bucket;
+    bucket.SetRate(100000);
+    bucket.SetRate(100);
+
+    // 蓄積分は新しいレートの1秒分に切り詰める
+    bucket.Acquire(100);
+    auto start = steady_clock::now();
+    bucket.Acquire(20);
+    EXPECT_LE(150, ElapsedMs(start));
+
+    // 0以下は制限なし
+    bucket.SetRate(-1);
+    EXPECT_FALSE(bucket.IsLimited());
+    EXPECT_EQ(0, bucket.GetRate());
+    start = steady_clock::now();
+    bucket.Acquire(100000);
+    EXPECT_GT(100, ElapsedMs(start));
+}
+
+//NbTokenBucket::Reserve(待機なし)
+TEST(NbTokenBucket, Reserve) {
+    NbTokenBucket bucket;
+    // 制限なしは待機不要
+    EXPECT_EQ(0, bucket.Reserve(1000000000));
+
+    bucket.SetRate(1000);
+    // 1秒分は待機不要
+    EXPECT_EQ(0, bucket.Reserve(1000));
+
+    // 先に消費し、待機せずに不足分(300ms)の補充時間を返す
+    auto start = steady_clock::now();
+    int64_t wait = bucket.Reserve(300);
+    EXPECT_GT(100, ElapsedMs(start));
+    EXPECT_LT(250, wait);
+    EXPECT_GE(300, wait);
+
+    // 不足分は合算される
+    EXPECT_LT(wait + 50, bucket.Reserve(100));
+}
+} //namespace necbaas
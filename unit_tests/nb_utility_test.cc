@@ -1,6 +1,8 @@
 #include "gtest/gtest.h"
 #include "necbaas/internal/nb_utility.h"
-//#include "test_util.h"
+#include "test_util.h"
+#include <unistd.h>
+#include <fstream>
 
 namespace necbaas {
 
@@ -85,6 +87,17 @@ TEST(NbUtility, GetFileSizeOpenError) {
     EXPECT_EQ(0, file_size);
 }
 
+//NbUtility::GetFileSize(2GB超)
+TEST(NbUtility, GetFileSizeLarge) {
+    static const int64_t kLargeSize = (3LL << 30) + 1;
+    // データを書込まないスパースファイルで作成する
+    std::ofstream("large.dat");
+    ASSERT_EQ(0, truncate("large.dat", kLargeSize));
+
+    EXPECT_EQ(kLargeSize, NbUtility::GetFileSize("large.dat"));
+    std::remove("large.dat");
+}
+
 //NbUtility::ConvertJsonType
 TEST(NbUtility, ConvertJsonType) {
     EXPECT_EQ(NbJsonType::NB_JSON_NUMBER, NbUtility::ConvertJsonType(Json::intValue));
@@ -107,4 +120,32 @@ TEST(NbUtility, CompareCaseInsensitiveString) {
     EXPECT_FALSE(NbUtility::CompareCaseInsensitiveString(string("Test-String123"), string("")));
     EXPECT_TRUE(NbUtility::CompareCaseInsensitiveString(string(""), string("")));
 }
+
+//NbUtility::CompareCaseInsensitiveString(長さ指定)
+TEST(NbUtility, CompareCaseInsensitiveStringLength) {
+    const char *str = "Content-Length: 20";
+    EXPECT_TRUE(NbUtility::CompareCaseInsensitiveString(str, 14, string("content-length")));
+    EXPECT_TRUE(NbUtility::CompareCaseInsensitiveString(str, 14, string("CONTENT-LENGTH")));
+    EXPECT_FALSE(NbUtility::CompareCaseInsensitiveString(str, 13, string("content-length")));
+    EXPECT_FALSE(NbUtility::CompareCaseInsensitiveString(str, 14, string("content-lengtx")));
+    EXPECT_TRUE(NbUtility::CompareCaseInsensitiveString(str, 0, string("")));
+}
+
+//NbUtility::GzipCompress
+TEST(NbUtility, GzipCompress) {
+    string data;
+    for (int i = 0; i < 100; ++i) {
+        data += R"({"key":"value","number":12345})";
+    }
+
+    string compressed;
+    ASSERT_TRUE(NbUtility::GzipCompress(data, &compressed));
+    EXPECT_GT(data.size(), compressed.size());
+    EXPECT_EQ(data, TestUtil::GzipDecompress(compressed));
+
+    // 空データ
+    ASSERT_TRUE(NbUtility::GzipCompress(string(), &compressed));
+    EXPECT_FALSE(compressed.empty());
+    EXPECT_EQ(string(), TestUtil::GzipDecompress(compressed));
+}
 } //namespace necbaas
@@ -23,6 +23,7 @@ class MockService : public NbService {
         : NbService(endpoint_url, tenant_id, app_id, app_key, proxy) {}
     MOCK_METHOD0(PopRestExecutor, NbRestExecutor *());
     MOCK_METHOD1(PushRestExecutor, void(NbRestExecutor *executor));
+    MOCK_METHOD3(SubmitAsyncRequest, void(const NbHttpRequest &request, int timeout, NbRestAsyncEngine::Callback callback));
 };
 
 class MockRestExecutor : public NbRestExecutor {
@@ -88,6 +89,15 @@ class RestApiTest : public ::testing::Test {
         }
     }
 
+    // 非同期実行は、登録時に呼び出しスレッドで完了させる
+    void SetExpectAsync(std::function<NbResult<NbHttpResponse>(const NbHttpRequest &, int)> callback_func) {
+        EXPECT_CALL(*mock_service_, SubmitAsyncRequest(_, _, _))
+        .WillOnce(Invoke([callback_func](const NbHttpRequest &request, int timeout,
+                                         NbRestAsyncEngine::Callback callback) {
+            callback(callback_func(request, timeout));
+        }));
+    }
+
     MockService *mock_service_;
     MockRestExecutor executor_;
 };    
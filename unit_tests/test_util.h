@@ -1,6 +1,7 @@
 #ifndef NECBAAS_TESTUTIL_H
 #define NECBAAS_TESTUTIL_H
 
+#include <zlib.h>
 #include "necbaas/internal/nb_http_request_factory.h"
 
 namespace necbaas {
@@ -32,6 +33,26 @@ class TestUtil {
     static const std::string &NbHttpRequestFactory_GetProxy(const NbHttpRequestFactory &factory) {
         return factory.proxy_;
     }
+
+    // gzip展開(圧縮データ検証用)
+    static std::string GzipDecompress(const std::string &compressed) {
+        z_stream stream{};
+        inflateInit2(&stream, MAX_WBITS + 16);
+        stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(compressed.data()));
+        stream.avail_in = compressed.size();
+
+        std::string data;
+        char buffer[4096];
+        int ret;
+        do {
+            stream.next_out = reinterpret_cast<Bytef *>(buffer);
+            stream.avail_out = sizeof(buffer);
+            ret = inflate(&stream, Z_NO_FLUSH);
+            data.append(buffer, sizeof(buffer) - stream.avail_out);
+        } while (ret == Z_OK);
+        inflateEnd(&stream);
+        return (ret == Z_STREAM_END) ? data : std::string();
+    }
 };
 }//namespace necbaas
 